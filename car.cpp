@@ -1,1003 +1,10676 @@
-#include <iostream>
-#include <vector>
-#include <string>
-#include <fstream>
-#include <sstream>
-#include <iomanip>
-#include <algorithm>
-#include <iterator>
-#include <chrono>
-#include <ctime>
-using namespace std;
-
-// Configuration: Use 86400 for production (1 day), 30 for testing (30 seconds)
-#define SECONDS_PER_DAY 86400
-// #define SECONDS_PER_DAY 30
-
-// Utility function to convert string to integer
-int convertStringToInt(const string& str) {
-    stringstream stream(str);
-    int value = 0;
-    stream >> value;
-    return value;
-}
-
-// Display due date in readable format
-void showDueDate(time_t due_date) {
-    if (due_date == 0) {
-        cout << setw(15) << "Not rented\n";
-        return;
-    }
-    
-    auto current_time = time(0);
-    if (current_time > due_date) {
-        cout << setw(15) << "Overdue\n";
-    } else {
-        auto date_structure = localtime(&due_date);
-        cout << date_structure->tm_mday << "/" 
-             << (1 + date_structure->tm_mon) << "/" 
-             << (1900 + date_structure->tm_year) << endl;
-    }
-}
-
-//======================= VEHICLE CLASS =======================//
-
-class Vehicle {
-public:
-    string vehicle_id;
-    string brand_name;
-    string vehicle_model;
-    int daily_rent;
-    int market_price;
-    int seating_capacity;
-    string vehicle_color;
-    bool is_rented;
-    time_t return_deadline;
-    static int vehicle_counter;
-    int vehicle_condition;
-    
-    friend class Administrator;
-
-    Vehicle(string brand, string model, int rent, int price, int seats, 
-            string color, int condition = 100, time_t deadline = 0) {
-        this->vehicle_id = to_string(++vehicle_counter);
-        this->brand_name = brand;
-        this->vehicle_model = model;
-        this->market_price = price;
-        this->daily_rent = rent;
-        this->seating_capacity = seats;
-        this->vehicle_color = color;
-        this->is_rented = false;
-        this->vehicle_condition = condition;
-        this->return_deadline = deadline;
-    }
-};
-
-int Vehicle::vehicle_counter = 0;
-vector<Vehicle> vehicle_inventory;
-
-//======================= BASE USER CLASS =======================//
-
-class BaseUser {
-protected:
-    string user_password;
-    
-public:
-    int user_id;
-    string username;
-    static int customer_count;
-    static int employee_count;
-    
-    void displayAllVehicles();
-    bool validatePassword(const string& password);
-};
-
-int BaseUser::customer_count = 0;
-int BaseUser::employee_count = 0;
-
-void BaseUser::displayAllVehicles() {
-    cout << setw(3) << "ID" << setw(15) << "Brand" << setw(15) << "Model" 
-         << setw(7) << "Rent" << setw(12) << "Price" << setw(6) << "Seats" 
-         << setw(10) << "Color" << setw(10) << "Available" << setw(10) 
-         << "Condition" << setw(15) << "Due Date" << endl;
-    
-    for (const auto& vehicle : vehicle_inventory) {
-        cout << setw(3) << vehicle.vehicle_id << setw(15) << vehicle.brand_name 
-             << setw(15) << vehicle.vehicle_model << setw(7) << vehicle.daily_rent 
-             << setw(12) << vehicle.market_price << setw(6) << vehicle.seating_capacity 
-             << setw(10) << vehicle.vehicle_color << setw(10) << !vehicle.is_rented 
-             << setw(10) << vehicle.vehicle_condition << setw(15);
-        showDueDate(vehicle.return_deadline);
-    }
-}
-
-bool BaseUser::validatePassword(const string& password) {
-    return (this->user_password == password);
-}
-
-//======================= CUSTOMER CLASS =======================//
-
-class Client : public BaseUser {
-protected:
-    vector<Vehicle> rented_vehicles;
-    int outstanding_dues;
-    int client_rating;
-
-public:
-    friend class Administrator;
-
-    Client(string name, string password, int rating = 100, int dues = 0, 
-           vector<Vehicle> vehicles = {}) {
-        this->username = name;
-        this->user_password = password;
-        this->user_id = ++customer_count;
-        this->outstanding_dues = dues;
-        this->client_rating = rating;
-        this->rented_vehicles = vehicles;
-    }
-
-    void accessClientPortal();
-    void rentVehicle();
-    void returnVehicle();
-    void showRentedVehicles();
-    void checkOutstandingDues();
-    void payDues();
-};
-
-vector<Client> client_database;
-
-void Client::rentVehicle() {
-    cout << "Enter the vehicle ID you wish to rent: ";
-    string vehicle_id;
-    cin >> vehicle_id;
-    
-    for (auto& vehicle : vehicle_inventory) {
-        if (vehicle.vehicle_id == vehicle_id) {
-            if (vehicle.is_rented) {
-                cout << "Vehicle is currently rented out\n";
-                return;
-            }
-            
-            vehicle.is_rented = true;
-            this->outstanding_dues += vehicle.daily_rent;
-            rented_vehicles.push_back(vehicle);
-            vehicle.return_deadline = time(0) + SECONDS_PER_DAY * 7;
-            cout << "Vehicle rented successfully\n";
-            return;
-        }
-    }
-    cout << "Vehicle with specified ID not found\n\n\n";
-}
-
-void Client::returnVehicle() {
-    cout << "Enter the vehicle ID you wish to return: ";
-    string vehicle_id;
-    cin >> vehicle_id;
-    
-    for (auto iterator = rented_vehicles.begin(); iterator != rented_vehicles.end(); ++iterator) {
-        if (iterator->vehicle_id == vehicle_id) {
-            // Update vehicle availability in main inventory
-            for (auto& main_vehicle : vehicle_inventory) {
-                if (main_vehicle.vehicle_id == vehicle_id) {
-                    main_vehicle.is_rented = false;
-                    main_vehicle.return_deadline = 0;
-                    break;
-                }
-            }
-            
-            auto current_time = time(0);
-            if (current_time > iterator->return_deadline) {
-                int penalty = (iterator->daily_rent * ((current_time - iterator->return_deadline) / SECONDS_PER_DAY)) / 5;
-                this->outstanding_dues += penalty;
-                this->client_rating -= 2 * ((current_time - iterator->return_deadline) / SECONDS_PER_DAY);
-                cout << "Late return penalty applied: " << penalty << "\n";
-            }
-            
-            rented_vehicles.erase(iterator);
-            cout << "Vehicle returned successfully\n\n\n";
-            return;
-        }
-    }
-    cout << "Vehicle not found in your rentals\n";
-}
-
-void Client::showRentedVehicles() {
-    if (rented_vehicles.empty()) {
-        cout << "No vehicles currently rented\n\n\n";
-        return;
-    }
-    
-    cout << setw(3) << "ID" << setw(15) << "Brand" << setw(15) << "Model" 
-         << setw(7) << "Rent" << setw(12) << "Price" << setw(6) << "Seats" 
-         << setw(10) << "Color" << setw(10) << "Due Date" << setw(10) 
-         << "Condition" << setw(15) << "Return By" << endl;
-    
-    for (const auto& vehicle : rented_vehicles) {
-        cout << setw(3) << vehicle.vehicle_id << setw(15) << vehicle.brand_name 
-             << setw(15) << vehicle.vehicle_model << setw(7) << vehicle.daily_rent 
-             << setw(12) << vehicle.market_price << setw(6) << vehicle.seating_capacity 
-             << setw(10) << vehicle.vehicle_color << setw(10) << vehicle.return_deadline 
-             << setw(10) << vehicle.vehicle_condition;
-        showDueDate(vehicle.return_deadline);
-    }
-    cout << "\n\n\n";
-}
-
-void Client::checkOutstandingDues() {
-    cout << "Your current outstanding balance: " << this->outstanding_dues << "\n\n\n";
-}
-
-void Client::payDues() {
-    if (this->outstanding_dues == 0) {
-        cout << "No outstanding dues to pay\n\n\n";
-        return;
-    }
-    
-    cout << "Current outstanding balance: " << this->outstanding_dues << endl;
-    cout << "Enter payment amount: ";
-    string amount_str;
-    cin >> amount_str;
-    int payment_amount = convertStringToInt(amount_str);
-    
-    if (payment_amount > 0 && payment_amount <= this->outstanding_dues) {
-        this->outstanding_dues -= payment_amount;
-        cout << "Payment processed successfully\n";
-        cout << "Remaining balance: " << this->outstanding_dues << "\n\n\n";
-    } else {
-        cout << "Invalid payment amount\n";
-    }
-}
-
-void Client::accessClientPortal() {
-    bool session_active = true;
-    cout << "Welcome, " << this->username << endl;
-    
-    while (session_active) {
-        cout << "Select an option:\n";
-        cout << "1. View all vehicles\n2. View your rentals\n3. Rent a vehicle\n"
-             << "4. Return a vehicle\n5. Check dues\n6. Pay dues\n0. Logout\n"
-             << "Enter your choice: ";
-        
-        char user_choice;
-        cin >> user_choice;
-        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        
-        switch (user_choice) {
-            case '1': displayAllVehicles(); break;
-            case '2': showRentedVehicles(); break;
-            case '3': rentVehicle(); break;
-            case '4': returnVehicle(); break;
-            case '5': checkOutstandingDues(); break;
-            case '6': payDues(); break;
-            case '0': session_active = false; break;
-            default: cout << "Invalid selection\n"; break;
-        }
-    }
-}
-
-void handleClientLogin() {
-    bool login_session = true;
-    
-    while (login_session) {
-        cout << "Client Portal Options:\n";
-        cout << "1. Login\n2. Register\n0. Exit\nEnter your choice: ";
-        char choice;
-        cin >> choice;
-        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        
-        switch (choice) {
-            case '1': {
-                cout << "Enter your username:\n";
-                string name;
-                getline(cin, name);
-                cout << "Enter your password:\n";
-                string password;
-                cin >> password;
-                
-                bool login_success = false;
-                for (auto& client : client_database) {
-                    if (client.username == name && client.validatePassword(password)) {
-                        client.accessClientPortal();
-                        login_success = true;
-                        break;
-                    }
-                }
-                
-                if (!login_success) {
-                    cout << "Authentication failed: Invalid credentials\n";
-                }
-                break;
-            }
-            case '2': {
-                cout << "Enter desired username:\n";
-                string name;
-                getline(cin, name);
-                cout << "Enter password:\n";
-                string password;
-                cin >> password;
-                cout << "Confirm password:\n";
-                string confirm_password;
-                cin >> confirm_password;
-                
-                if (password != confirm_password) {
-                    cout << "Registration failed: Passwords do not match\n";
-                    break;
-                }
-                
-                bool username_available = true;
-                for (const auto& client : client_database) {
-                    if (client.username == name) {
-                        cout << "Registration failed: Username already exists\n";
-                        username_available = false;
-                        break;
-                    }
-                }
-                
-                if (username_available) {
-                    Client new_client(name, password);
-                    client_database.push_back(new_client);
-                    cout << "Registration successful\nPlease login to access your account\n\n\n";
-                }
-                break;
-            }
-            case '0': login_session = false; break;
-            default: cout << "Invalid selection\n"; break;
-        }
-    }
-}
-
-//======================= EMPLOYEE CLASS =======================//
-
-class StaffMember : public BaseUser {
-protected:
-    vector<Vehicle> rented_vehicles;
-    int outstanding_dues;
-    double performance_rating;
-
-public:
-    friend class Administrator;
-
-    StaffMember(string name, string password, double rating = 1.00, int dues = 0, 
-                vector<Vehicle> vehicles = {}) {
-        this->username = name;
-        this->user_password = password;
-        this->user_id = ++employee_count;
-        this->outstanding_dues = dues;
-        this->performance_rating = rating;
-        this->rented_vehicles = vehicles;
-    }
-
-    void accessStaffPortal();
-    void rentVehicle();
-    void returnVehicle();
-    void showRentedVehicles();
-    void checkOutstandingDues();
-    void payDues();
-};
-
-vector<StaffMember> staff_database;
-
-void StaffMember::rentVehicle() {
-    cout << "Enter the vehicle ID you wish to rent: ";
-    string vehicle_id;
-    cin >> vehicle_id;
-    
-    for (auto& vehicle : vehicle_inventory) {
-        if (vehicle.vehicle_id == vehicle_id) {
-            if (vehicle.is_rented) {
-                cout << "Vehicle is currently rented out\n";
-                return;
-            }
-            
-            vehicle.is_rented = true;
-            this->outstanding_dues += int(vehicle.daily_rent * 0.85); // Employee discount
-            rented_vehicles.push_back(vehicle);
-            cout << "Vehicle rented successfully (Employee discount applied)\n";
-            return;
-        }
-    }
-    cout << "Vehicle with specified ID not found\n\n\n";
-}
-
-void StaffMember::returnVehicle() {
-    cout << "Enter the vehicle ID you wish to return: ";
-    string vehicle_id;
-    cin >> vehicle_id;
-    
-    for (auto iterator = rented_vehicles.begin(); iterator != rented_vehicles.end(); ++iterator) {
-        if (iterator->vehicle_id == vehicle_id) {
-            // Update vehicle availability in main inventory
-            for (auto& main_vehicle : vehicle_inventory) {
-                if (main_vehicle.vehicle_id == vehicle_id) {
-                    main_vehicle.is_rented = false;
-                    break;
-                }
-            }
-            
-            auto current_time = time(0);
-            if (current_time > iterator->return_deadline) {
-                int penalty = 0.17 * (iterator->daily_rent * ((current_time - iterator->return_deadline) / SECONDS_PER_DAY));
-                this->outstanding_dues += penalty;
-                this->performance_rating -= 2 * ((current_time - iterator->return_deadline) / SECONDS_PER_DAY);
-                cout << "Late return penalty applied: " << penalty << "\n";
-            }
-            
-            rented_vehicles.erase(iterator);
-            cout << "Vehicle returned successfully\n\n\n";
-            return;
-        }
-    }
-    cout << "Vehicle not found in your rentals\n";
-}
-
-void StaffMember::showRentedVehicles() {
-    if (rented_vehicles.empty()) {
-        cout << "No vehicles currently rented\n\n\n";
-        return;
-    }
-    
-    cout << setw(3) << "ID" << setw(15) << "Brand" << setw(15) << "Model" 
-         << setw(7) << "Rent" << setw(12) << "Price" << setw(6) << "Seats" 
-         << setw(10) << "Color" << setw(10) << "Due Date" << setw(10) 
-         << "Condition" << setw(15) << "Return By" << endl;
-    
-    for (const auto& vehicle : rented_vehicles) {
-        cout << setw(3) << vehicle.vehicle_id << setw(15) << vehicle.brand_name 
-             << setw(15) << vehicle.vehicle_model << setw(7) << vehicle.daily_rent 
-             << setw(12) << vehicle.market_price << setw(6) << vehicle.seating_capacity 
-             << setw(10) << vehicle.vehicle_color << setw(10) << vehicle.return_deadline 
-             << setw(10) << vehicle.vehicle_condition;
-        showDueDate(vehicle.return_deadline);
-    }
-    cout << "\n\n\n";
-}
-
-void StaffMember::checkOutstandingDues() {
-    cout << "Your current outstanding balance: " << this->outstanding_dues << "\n\n\n";
-}
-
-void StaffMember::payDues() {
-    if (this->outstanding_dues == 0) {
-        cout << "No outstanding dues to pay\n\n\n";
-        return;
-    }
-    
-    cout << "Current outstanding balance: " << this->outstanding_dues << endl;
-    cout << "Enter payment amount: ";
-    string amount_str;
-    cin >> amount_str;
-    int payment_amount = convertStringToInt(amount_str);
-    
-    if (payment_amount > 0 && payment_amount <= this->outstanding_dues) {
-        this->outstanding_dues -= payment_amount;
-        cout << "Payment processed successfully\n";
-        cout << "Remaining balance: " << this->outstanding_dues << "\n\n\n";
-    } else {
-        cout << "Invalid payment amount\n";
-    }
-}
-
-void StaffMember::accessStaffPortal() {
-    bool session_active = true;
-    cout << "Welcome, " << this->username << endl;
-    
-    while (session_active) {
-        cout << "Select an option:\n";
-        cout << "1. View all vehicles\n2. View your rentals\n3. Rent a vehicle\n"
-             << "4. Return a vehicle\n5. Check dues\n6. Pay dues\n0. Logout\n"
-             << "Enter your choice: ";
-        
-        char user_choice;
-        cin >> user_choice;
-        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        
-        switch (user_choice) {
-            case '1': displayAllVehicles(); break;
-            case '2': showRentedVehicles(); break;
-            case '3': rentVehicle(); break;
-            case '4': returnVehicle(); break;
-            case '5': checkOutstandingDues(); break;
-            case '6': payDues(); break;
-            case '0': session_active = false; break;
-            default: cout << "Invalid selection\n"; break;
-        }
-    }
-}
-
-void handleStaffLogin() {
-    bool login_session = true;
-    
-    while (login_session) {
-        cout << "Staff Portal Options:\n";
-        cout << "1. Login\n0. Exit\nEnter your choice: ";
-        char choice;
-        cin >> choice;
-        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        
-        switch (choice) {
-            case '1': {
-                cout << "Enter your username:\n";
-                string name;
-                getline(cin, name);
-                cout << "Enter your password:\n";
-                string password;
-                cin >> password;
-                
-                bool login_success = false;
-                for (auto& staff : staff_database) {
-                    if (staff.username == name && staff.validatePassword(password)) {
-                        staff.accessStaffPortal();
-                        login_success = true;
-                        break;
-                    }
-                }
-                
-                if (!login_success) {
-                    cout << "Authentication failed: Invalid credentials\n";
-                }
-                break;
-            }
-            case '0': login_session = false; break;
-            default: cout << "Invalid selection\n"; break;
-        }
-    }
-}
-
-//======================= ADMINISTRATOR CLASS =======================//
-
-class Administrator : public BaseUser {
-public:
-    void accessAdminPortal();
-    void addNewVehicle();
-    void modifyVehicle();
-    void removeVehicle();
-    void viewAllClients();
-    void addNewClient();
-    void modifyClient();
-    void removeClient();
-    void viewAllStaff();
-    void addNewStaff();
-    void modifyStaff();
-    void removeStaff();
-};
-
-Administrator system_admin;
-
-void Administrator::addNewVehicle() {
-    cout << "Enter vehicle brand: ";
-    string brand;
-    cin >> brand;
-    cout << "Enter vehicle model: ";
-    string model;
-    cin >> model;
-    cout << "Enter daily rent: ";
-    int rent;
-    cin >> rent;
-    cout << "Enter market price: ";
-    int price;
-    cin >> price;
-    cout << "Enter seating capacity: ";
-    int seats;
-    cin >> seats;
-    cout << "Enter vehicle color: ";
-    string color;
-    cin >> color;
-    
-    vehicle_inventory.push_back(Vehicle(brand, model, rent, price, seats, color));
-    cout << "Vehicle added successfully\n";
-}
-
-void Administrator::addNewClient() {
-    cout << "Enter client name: ";
-    string name;
-    cin >> name;
-    cout << "Enter client password: ";
-    string password;
-    cin >> password;
-    
-    client_database.push_back(Client(name, password));
-    cout << "Client added successfully\n";
-}
-
-void Administrator::addNewStaff() {
-    cout << "Enter staff name: ";
-    string name;
-    cin >> name;
-    cout << "Enter staff password: ";
-    string password;
-    cin >> password;
-    
-    staff_database.push_back(StaffMember(name, password));
-    cout << "Staff member added successfully\n";
-}
-
-void Administrator::viewAllClients() {
-    cout << "ID\tName\tDues\tRating" << endl;
-    for (const auto& client : client_database) {
-        cout << client.user_id << "\t" << client.username << "\t" 
-             << client.outstanding_dues << "\t" << client.client_rating << endl;
-        cout << "\tRented Vehicles:\n";
-        for (const auto& vehicle : client.rented_vehicles) {
-            cout << "\t" << vehicle.brand_name << " " << vehicle.vehicle_model << endl;
-        }
-    }
-}
-
-void Administrator::viewAllStaff() {
-    cout << "ID\tName" << endl;
-    for (const auto& staff : staff_database) {
-        cout << staff.user_id << "\t" << staff.username << endl;
-        cout << "\tRented Vehicles:\n";
-        for (const auto& vehicle : staff.rented_vehicles) {
-            cout << "\t" << vehicle.brand_name << " " << vehicle.vehicle_model << endl;
-        }
-    }
-}
-
-void Administrator::removeVehicle() {
-    cout << "Enter vehicle ID to remove: ";
-    string vehicle_id;
-    cin >> vehicle_id;
-    
-    for (auto iterator = vehicle_inventory.begin(); iterator != vehicle_inventory.end(); ++iterator) {
-        if (iterator->vehicle_id == vehicle_id) {
-            if (iterator->is_rented) {
-                cout << "Cannot remove: Vehicle is currently rented\n";
-                return;
-            }
-            vehicle_inventory.erase(iterator);
-            cout << "Vehicle removed successfully\n";
-            return;
-        }
-    }
-    cout << "Vehicle not found\n";
-}
-
-void Administrator::removeClient() {
-    cout << "Enter client ID to remove: ";
-    int client_id;
-    cin >> client_id;
-    
-    for (auto iterator = client_database.begin(); iterator != client_database.end(); ++iterator) {
-        if (iterator->user_id == client_id) {
-            if (iterator->outstanding_dues > 0) {
-                cout << "Cannot remove: Client has outstanding dues\n";
-                return;
-            }
-            if (!iterator->rented_vehicles.empty()) {
-                cout << "Cannot remove: Client has rented vehicles\n";
-                return;
-            }
-            client_database.erase(iterator);
-            cout << "Client removed successfully\n";
-            return;
-        }
-    }
-    cout << "Client not found\n";
-}
-
-void Administrator::removeStaff() {
-    cout << "Enter staff ID to remove: ";
-    string staff_str;
-    cin >> staff_str;
-    int staff_id = convertStringToInt(staff_str);
-    
-    for (auto iterator = staff_database.begin(); iterator != staff_database.end(); ++iterator) {
-        if (iterator->user_id == staff_id) {
-            if (iterator->outstanding_dues > 0) {
-                cout << "Cannot remove: Staff has outstanding dues\n";
-                return;
-            }
-            if (!iterator->rented_vehicles.empty()) {
-                cout << "Cannot remove: Staff has rented vehicles\n";
-                return;
-            }
-            staff_database.erase(iterator);
-            cout << "Staff removed successfully\n";
-            return;
-        }
-    }
-    cout << "Staff not found\n";
-}
-
-void Administrator::modifyVehicle() {
-    cout << "Enter vehicle ID to modify: ";
-    string vehicle_id;
-    cin >> vehicle_id;
-    
-    for (auto& vehicle : vehicle_inventory) {
-        if (vehicle.vehicle_id == vehicle_id) {
-            bool updating = true;
-            while (updating) {
-                cout << "Select field to update:\n";
-                cout << "1. Brand\n2. Model\n3. Rent\n4. Price\n5. Seats\n6. Color\n"
-                     << "7. Rental Status\n8. Condition\n0. Finish\nEnter choice: ";
-                
-                char choice;
-                cin >> choice;
-                cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                
-                switch (choice) {
-                    case '1':
-                        cout << "Current brand: " << vehicle.brand_name << "\n";
-                        cout << "Enter new brand: ";
-                        cin >> vehicle.brand_name;
-                        break;
-                    case '2':
-                        cout << "Current model: " << vehicle.vehicle_model << "\n";
-                        cout << "Enter new model: ";
-                        cin >> vehicle.vehicle_model;
-                        break;
-                    case '3':
-                        cout << "Current rent: " << vehicle.daily_rent << "\n";
-                        cout << "Enter new rent: ";
-                        cin >> vehicle.daily_rent;
-                        break;
-                    case '4':
-                        cout << "Current price: " << vehicle.market_price << "\n";
-                        cout << "Enter new price: ";
-                        cin >> vehicle.market_price;
-                        break;
-                    case '5':
-                        cout << "Current seats: " << vehicle.seating_capacity << "\n";
-                        cout << "Enter new seats: ";
-                        cin >> vehicle.seating_capacity;
-                        break;
-                    case '6':
-                        cout << "Current color: " << vehicle.vehicle_color << "\n";
-                        cout << "Enter new color: ";
-                        cin >> vehicle.vehicle_color;
-                        break;
-                    case '7':
-                        cout << "Currently " << (vehicle.is_rented ? "rented" : "not rented") << "\n";
-                        cout << "Enter new status: ";
-                        cin >> vehicle.is_rented;
-                        break;
-                    case '8':
-                        cout << "Current condition: " << vehicle.vehicle_condition << "\n";
-                        cout << "Enter new condition: ";
-                        cin >> vehicle.vehicle_condition;
-                        break;
-                    case '0':
-                        updating = false;
-                        break;
-                    default:
-                        cout << "Invalid choice\n";
-                        break;
-                }
-            }
-            return;
-        }
-    }
-    cout << "Vehicle not found\n";
-}
-
-void Administrator::modifyClient() {
-    cout << "Enter client ID to modify: ";
-    int client_id;
-    cin >> client_id;
-    
-    for (auto& client : client_database) {
-        if (client.user_id == client_id) {
-            bool updating = true;
-            while (updating) {
-                cout << "Select field to update:\n";
-                cout << "1. Name\n2. Password\n3. Dues\n4. Rating\n0. Finish\nEnter choice: ";
-                
-                char choice;
-                cin >> choice;
-                cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                
-                switch (choice) {
-                    case '1':
-                        cout << "Current name: " << client.username << "\n";
-                        cout << "Enter new name: ";
-                        cin >> client.username;
-                        break;
-                    case '2':
-                        cout << "Enter new password: ";
-                        cin >> client.user_password;
-                        break;
-                    case '3':
-                        cout << "Current dues: " << client.outstanding_dues << "\n";
-                        cout << "Enter new dues: ";
-                        cin >> client.outstanding_dues;
-                        break;
-                    case '4':
-                        cout << "Current rating: " << client.client_rating << "\n";
-                        cout << "Enter new rating: ";
-                        cin >> client.client_rating;
-                        break;
-                    case '0':
-                        updating = false;
-                        break;
-                    default:
-                        cout << "Invalid choice\n";
-                        break;
-                }
-            }
-            return;
-        }
-    }
-    cout << "Client not found\n";
-}
-
-void Administrator::modifyStaff() {
-    cout << "Enter staff ID to modify: ";
-    string staff_str;
-    cin >> staff_str;
-    int staff_id = convertStringToInt(staff_str);
-    
-    for (auto& staff : staff_database) {
-        if (staff.user_id == staff_id) {
-            bool updating = true;
-            while (updating) {
-                cout << "Select field to update:\n";
-                cout << "1. Name\n2. Password\n3. Dues\n4. Rating\n0. Finish\nEnter choice: ";
-                
-                char choice;
-                cin >> choice;
-                cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                
-                switch (choice) {
-                    case '1':
-                        cout << "Current name: " << staff.username << "\n";
-                        cout << "Enter new name: ";
-                        cin >> staff.username;
-                        cout << "Name updated to " << staff.username << endl;
-                        break;
-                    case '2':
-                        cout << "Enter new password: ";
-                        cin >> staff.user_password;
-                        cout << "Password updated successfully\n";
-                        break;
-                    case '3':
-                        cout << "Current dues: " << staff.outstanding_dues << "\n";
-                        cout << "Enter new dues: ";
-                        cin >> staff.outstanding_dues;
-                        cout << "Dues updated to " << staff.outstanding_dues << endl;
-                        break;
-                    case '4':
-                        cout << "Current rating: " << staff.performance_rating << "\n";
-                        cout << "Enter new rating: ";
-                        cin >> staff.performance_rating;
-                        cout << "Rating updated to " << staff.performance_rating << endl;
-                        break;
-                    case '0':
-                        updating = false;
-                        break;
-                    default:
-                        cout << "Invalid choice\n";
-                        break;
-                }
-            }
-            return;
-        }
-    }
-    cout << "Staff not found\n";
-}
-
-void Administrator::accessAdminPortal() {
-    bool session_active = true;
-    cout << "Welcome, " << this->username << endl;
-    
-    while (session_active) {
-        cout << "Administrator Panel Options:\n";
-        cout << "1. View all vehicles\n2. Add vehicle\n3. Modify vehicle\n4. Remove vehicle\n"
-             << "5. View all clients\n6. Add client\n7. Modify client\n8. Remove client\n"
-             << "9. View all staff\na. Add staff\nb. Modify staff\nc. Remove staff\n"
-             << "0. Logout\nEnter your choice: ";
-        
-        char choice;
-        cin >> choice;
-        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        
-        switch (choice) {
-            case '1': displayAllVehicles(); break;
-            case '2': addNewVehicle(); break;
-            case '3': modifyVehicle(); break;
-            case '4': removeVehicle(); break;
-            case '5': viewAllClients(); break;
-            case '6': addNewClient(); break;
-            case '7': modifyClient(); break;
-            case '8': removeClient(); break;
-            case '9': viewAllStaff(); break;
-            case 'a': addNewStaff(); break;
-            case 'b': modifyStaff(); break;
-            case 'c': removeStaff(); break;
-            case '0': session_active = false; break;
-            default: cout << "Invalid selection\n"; break;
-        }
-    }
-}
-
-void handleAdminLogin() {
-    bool login_session = true;
-    
-    while (login_session) {
-        cout << "Administrator Portal Options:\n";
-        cout << "1. Login\n0. Exit\nEnter your choice: ";
-        char choice;
-        cin >> choice;
-        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        
-        switch (choice) {
-            case '1': {
-                cout << "Enter username:\n";
-                string name;
-                getline(cin, name);
-                cout << "Enter password:\n";
-                string password;
-                cin >> password;
-                
-                if (name == "admin" && password == "admin") {
-                    cout << "Authentication successful\n";
-                    system_admin.accessAdminPortal();
-                    break;
-                }
-                cout << "Authentication failed: Invalid credentials\n";
-                break;
-            }
-            case '0': login_session = false; break;
-            default: cout << "Invalid selection\n"; break;
-        }
-    }
-}
-
-//======================= MAIN FUNCTION =======================//
-
-int main() {
-    bool system_running = true;
-    
-    // Initialize sample vehicle inventory
-    vehicle_inventory.push_back(Vehicle("Toyota", "Corolla", 1000, 2000000, 5, "White", 100, time(0) + SECONDS_PER_DAY));
-    vehicle_inventory.push_back(Vehicle("Honda", "Civic", 1500, 2500000, 5, "Black", 100, time(0) + SECONDS_PER_DAY));
-    vehicle_inventory.push_back(Vehicle("Suzuki", "Cultus", 800, 1000000, 5, "Grey"));
-    vehicle_inventory.push_back(Vehicle("Suzuki", "Mehran", 500, 500000, 5, "White"));
-    vehicle_inventory.push_back(Vehicle("Toyota", "Vitz", 1200, 1500000, 5, "Red"));
-    vehicle_inventory.push_back(Vehicle("Rolls", "Royce", 50000, 20000000, 4, "White", 90));
-    vehicle_inventory.push_back(Vehicle("Ferrari", "Laferrari", 15000, 30000000, 2, "Red", 100, time(0) + 600));
-    vehicle_inventory.push_back(Vehicle("Lamborghini", "Aventador", 20000, 40000000, 2, "Black", 100, time(0) + 1200));
-    vehicle_inventory.push_back(Vehicle("Bugatti", "Veyron", 25000, 50000000, 2, "Blue"));
-    vehicle_inventory.push_back(Vehicle("Audi", "A8", 5000, 10000000, 5, "Black"));
-
-    // Initialize sample client database
-    client_database.push_back(Client("ali", "asd", 100, 5000, {vehicle_inventory[0], vehicle_inventory[1]}));
-    client_database.push_back(Client("ahmed", "123"));
-    client_database.push_back(Client("asad", "123"));
-    client_database.push_back(Client("ahsan", "123"));
-    client_database.push_back(Client("adeel", "123"));
-    vehicle_inventory[0].is_rented = true;
-    vehicle_inventory[1].is_rented = true;
-
-    // Initialize sample staff database
-    staff_database.push_back(StaffMember("dev", "123", 1.00, 0));
-    staff_database.push_back(StaffMember("daksh", "123"));
-    staff_database.push_back(StaffMember("sway", "123"));
-    staff_database.push_back(StaffMember("himan", "123", 0.99, 5000, {vehicle_inventory[6], vehicle_inventory[7]}));
-    staff_database.push_back(StaffMember("kum", "123"));
-    vehicle_inventory[6].is_rented = true;
-    vehicle_inventory[7].is_rented = true;
-
-    while (system_running) {
-        cout << "####################### Digital Vehicle Rental Management System #######################\n";
-        cout << "1. Client Portal\n2. Staff Portal\n3. Administrator Portal\n0. Exit System\n"
-             << "Enter your selection: ";
-        
-        char main_choice;
-        cin >> main_choice;
-        
-        switch (main_choice) {
-            case '0': system_running = false; break;
-            case '1': handleClientLogin(); break;
-            case '2': handleStaffLogin(); break;
-            case '3': handleAdminLogin(); break;
-            default: cout << "Invalid selection\n"; break;
-        }
-        
-        system("cls"); // Use "clear" for Linux/Mac, "cls" for Windows
-    }
-    
-    cin.get();
-    return 0;
-}
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <iterator>
+#include <chrono>
+#include <ctime>
+#include <unordered_map>
+#include <climits>
+#include <cmath>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <cstdio>
+#include <cerrno>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <functional>
+#include <tuple>
+#include <array>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+using namespace std;
+
+// Configuration: Use 86400 for production (1 day), 30 for testing (30 seconds)
+#define SECONDS_PER_DAY 86400
+// #define SECONDS_PER_DAY 30
+
+// Utility function to convert string to integer
+int convertStringToInt(const string& str) {
+    stringstream stream(str);
+    int value = 0;
+    stream >> value;
+    return value;
+}
+
+// Whole-field numeric parsing for batch commands and CSV imports
+bool parseNumber(string_view text, int& value) {
+    auto parsed = from_chars(text.data(), text.data() + text.size(), value);
+    return parsed.ec == errc() && parsed.ptr == text.data() + text.size();
+}
+
+bool parseNumber(string_view text, double& value) {
+    auto parsed = from_chars(text.data(), text.data() + text.size(), value);
+    return parsed.ec == errc() && parsed.ptr == text.data() + text.size();
+}
+
+// Unix time in seconds
+bool parseTime(string_view text, int64_t& value) {
+    auto parsed = from_chars(text.data(), text.data() + text.size(), value);
+    return parsed.ec == errc() && parsed.ptr == text.data() + text.size();
+}
+
+// Run body(begin, end) over [0, count) split into contiguous chunks, one per worker thread
+template <typename Body>
+void parallelFor(size_t count, unsigned workers, Body body) {
+    workers = max(1u, min<unsigned>(workers, count == 0 ? 1 : count));
+    if (workers == 1) {
+        body(size_t(0), count);
+        return;
+    }
+    vector<thread> threads;
+    size_t chunk = (count + workers - 1) / workers;
+    for (unsigned worker = 0; worker < workers; ++worker) {
+        size_t begin = min(count, worker * chunk);
+        size_t end = min(count, begin + chunk);
+        threads.emplace_back([=, &body] { body(begin, end); });
+    }
+    for (auto& worker_thread : threads) {
+        worker_thread.join();
+    }
+}
+
+unsigned workerCount() {
+    return max(1u, thread::hardware_concurrency());
+}
+
+// Atomic access to plain table fields that concurrent renters share. The tables
+// stay ordinary vectors so snapshots can keep copying them as flat columns.
+template <typename T>
+T loadShared(const T& value) {
+#if defined(__GNUC__)
+    T result;
+    __atomic_load(&value, &result, __ATOMIC_ACQUIRE);
+    return result;
+#else
+    return reinterpret_cast<const atomic<T>&>(value).load(memory_order_acquire);
+#endif
+}
+
+template <typename T>
+void storeShared(T& value, T new_value) {
+#if defined(__GNUC__)
+    __atomic_store(&value, &new_value, __ATOMIC_RELEASE);
+#else
+    reinterpret_cast<atomic<T>&>(value).store(new_value, memory_order_release);
+#endif
+}
+
+template <typename T>
+bool compareAndSwapShared(T& value, T expected, T desired) {
+#if defined(__GNUC__)
+    return __atomic_compare_exchange(&value, &expected, &desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#else
+    return reinterpret_cast<atomic<T>&>(value).compare_exchange_strong(expected, desired);
+#endif
+}
+
+// Set or clear bits of a shared bitmap word
+inline void setBitsShared(uint64_t& word, uint64_t bits, bool on) {
+#if defined(__GNUC__)
+    if (on) {
+        __atomic_fetch_or(&word, bits, __ATOMIC_ACQ_REL);
+    } else {
+        __atomic_fetch_and(&word, ~bits, __ATOMIC_ACQ_REL);
+    }
+#else
+    if (on) {
+        reinterpret_cast<atomic<uint64_t>&>(word).fetch_or(bits);
+    } else {
+        reinterpret_cast<atomic<uint64_t>&>(word).fetch_and(~bits);
+    }
+#endif
+}
+
+// Outcome of a rental or admin operation, reported by the portal menus and batch mode
+enum class OperationStatus {
+    Success,
+    VehicleNotFound,
+    AlreadyRented,
+    NotInRentals,
+    AccountNotFound,
+    AuthenticationFailed,
+    NoDues,
+    InvalidAmount,
+    NameTaken,
+    HasDues,
+    HasRentals,
+    VehicleInUse,
+    Reserved,
+    ReservationNotFound,
+    Unauthorized,
+    InvalidRequest
+};
+
+// Stable machine-readable name for batch results
+const char* statusName(OperationStatus status) {
+    switch (status) {
+        case OperationStatus::Success: return "ok";
+        case OperationStatus::VehicleNotFound: return "vehicle_not_found";
+        case OperationStatus::AlreadyRented: return "already_rented";
+        case OperationStatus::NotInRentals: return "not_in_rentals";
+        case OperationStatus::AccountNotFound: return "account_not_found";
+        case OperationStatus::AuthenticationFailed: return "authentication_failed";
+        case OperationStatus::NoDues: return "no_dues";
+        case OperationStatus::InvalidAmount: return "invalid_amount";
+        case OperationStatus::NameTaken: return "name_taken";
+        case OperationStatus::HasDues: return "has_dues";
+        case OperationStatus::HasRentals: return "has_rentals";
+        case OperationStatus::VehicleInUse: return "vehicle_in_use";
+        case OperationStatus::Reserved: return "reserved";
+        case OperationStatus::ReservationNotFound: return "reservation_not_found";
+        case OperationStatus::Unauthorized: return "unauthorized";
+        case OperationStatus::InvalidRequest: return "invalid_request";
+    }
+    return "unknown";
+}
+
+// Per-operation latency histograms and outcome counters. Each thread records
+// into its own shard with plain loads and stores, so an operation costs two
+// cycle counter reads and two increments without locked instructions and can
+// stay on in production. Readers sum the shards while writers carry on.
+enum class MetricOp {
+    Rent, Return, Pay, Reserve, Login, Listing, AdminAdd, AdminModify, AdminRemove, Count
+};
+
+const char* const METRIC_OP_NAMES[] = {
+    "rent", "return", "pay", "reserve", "login", "listing", "admin_add", "admin_modify", "admin_remove"
+};
+const size_t METRIC_OP_COUNT = size_t(MetricOp::Count);
+const size_t OPERATION_STATUS_COUNT = size_t(OperationStatus::InvalidRequest) + 1;
+
+// Timestamp counter where the CPU has one, otherwise steady_clock nanoseconds
+inline uint64_t readCycles() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return __rdtsc();
+#else
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+const chrono::steady_clock::time_point metrics_start_time = chrono::steady_clock::now();
+const uint64_t metrics_start_cycles = readCycles();
+
+// Cycle counter rate, measured against steady_clock since startup
+double cyclesPerNanosecond() {
+    auto elapsed = chrono::steady_clock::now() - metrics_start_time;
+    if (elapsed < chrono::milliseconds(10)) {
+        this_thread::sleep_for(chrono::milliseconds(10) - elapsed);
+    }
+    uint64_t cycles = readCycles() - metrics_start_cycles;
+    double nanoseconds = (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - metrics_start_time).count();
+    return cycles / nanoseconds;
+}
+
+// HDR-style histogram: values below 32 get exact buckets, larger values get 32
+// linear sub-buckets per power of two, so every bucket is within ~3% of its values.
+// Only the owning thread records; any thread may read.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int MAX_EXPONENT = 44;  // larger values land in the last bucket
+    static const size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    void record(uint64_t value) {
+        atomic<uint64_t>& bucket = buckets[bucketIndex(value)];
+        bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    }
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return value;
+        }
+#if defined(__GNUC__)
+        int exponent = 63 - __builtin_clzll(value);
+#else
+        int exponent = 0;
+        while ((value >> exponent) > 1) {
+            ++exponent;
+        }
+#endif
+        if (exponent > MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+        int shift = exponent - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+    }
+
+    // Largest value that maps to the bucket
+    static uint64_t bucketLimit(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        int shift = int(index / SUB_BUCKETS) - 1;
+        return ((SUB_BUCKETS + index % SUB_BUCKETS + 1) << shift) - 1;
+    }
+
+    // Add the counts to a running total, consistent enough for reporting while the owner continues
+    void addCounts(vector<uint64_t>& counts) const {
+        counts.resize(BUCKET_COUNT);
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            counts[i] += buckets[i].load(memory_order_relaxed);
+        }
+    }
+
+    // Value at the given quantile of summed counts holding total samples
+    static uint64_t quantile(const vector<uint64_t>& counts, uint64_t total, double fraction) {
+        uint64_t rank = max<uint64_t>(1, uint64_t(ceil(fraction * total)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return bucketLimit(i);
+            }
+        }
+        return 0;
+    }
+
+private:
+    atomic<uint64_t> buckets[BUCKET_COUNT] = {};
+};
+
+struct OperationMetrics {
+    LatencyHistogram latency;  // in readCycles() units
+    atomic<uint64_t> outcomes[OPERATION_STATUS_COUNT] = {};
+};
+
+struct MetricsShard {
+    OperationMetrics operations[METRIC_OP_COUNT];
+};
+
+// Every shard ever handed out. A thread's shard goes back to the free list when
+// the thread exits and keeps its counts, so totals never go backwards.
+class MetricsRegistry {
+public:
+    MetricsShard* acquire() {
+        lock_guard<mutex> guard(lock);
+        if (!free_shards.empty()) {
+            MetricsShard* shard = free_shards.back();
+            free_shards.pop_back();
+            return shard;
+        }
+        shards.push_back(make_unique<MetricsShard>());
+        return shards.back().get();
+    }
+
+    void release(MetricsShard* shard) {
+        lock_guard<mutex> guard(lock);
+        free_shards.push_back(shard);
+    }
+
+    template <typename Visit>
+    void forEachShard(Visit visit) {
+        lock_guard<mutex> guard(lock);
+        for (const auto& shard : shards) {
+            visit(*shard);
+        }
+    }
+
+private:
+    mutex lock;
+    vector<unique_ptr<MetricsShard>> shards;
+    vector<MetricsShard*> free_shards;
+};
+
+MetricsRegistry metrics_registry;
+
+// Hands the thread's shard back when the thread exits
+struct MetricsShardOwner {
+    MetricsShard* shard = nullptr;
+    ~MetricsShardOwner() {
+        if (shard != nullptr) {
+            metrics_registry.release(shard);
+        }
+    }
+};
+
+thread_local MetricsShard* local_metrics_shard = nullptr;
+thread_local MetricsShardOwner local_metrics_owner;
+
+inline MetricsShard& localMetricsShard() {
+    if (local_metrics_shard == nullptr) {
+        local_metrics_shard = local_metrics_owner.shard = metrics_registry.acquire();
+    }
+    return *local_metrics_shard;
+}
+
+// Started where an operation begins; finish() records its latency and outcome
+// and passes the result through, so it wraps return statements
+class OperationTimer {
+public:
+    // The shard is fetched first so a thread's first operation doesn't time its allocation
+    explicit OperationTimer(MetricOp op) : metrics(localMetricsShard().operations[size_t(op)]), start(readCycles()) {}
+
+    OperationStatus finish(OperationStatus status) {
+        metrics.latency.record(readCycles() - start);
+        atomic<uint64_t>& outcome = metrics.outcomes[size_t(status)];
+        outcome.store(outcome.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        return status;
+    }
+
+    template <typename Result>
+    Result finish(Result result) {
+        finish(result.status);
+        return result;
+    }
+
+private:
+    OperationMetrics& metrics;
+    uint64_t start;
+};
+
+// Summary of one operation's metrics, latencies in nanoseconds
+struct MetricsSummary {
+    uint64_t count = 0;
+    double p50 = 0, p90 = 0, p99 = 0, p999 = 0, max = 0;
+    uint64_t outcomes[OPERATION_STATUS_COUNT] = {};
+};
+
+MetricsSummary summarizeMetrics(MetricOp op, double cycles_per_ns) {
+    MetricsSummary summary;
+    vector<uint64_t> counts;
+    metrics_registry.forEachShard([&](const MetricsShard& shard) {
+        const OperationMetrics& metrics = shard.operations[size_t(op)];
+        for (size_t status = 0; status < OPERATION_STATUS_COUNT; ++status) {
+            summary.outcomes[status] += metrics.outcomes[status].load(memory_order_relaxed);
+        }
+        metrics.latency.addCounts(counts);
+    });
+    for (uint64_t count : counts) {
+        summary.count += count;
+    }
+    if (summary.count == 0) {
+        return summary;
+    }
+    summary.p50 = LatencyHistogram::quantile(counts, summary.count, 0.50) / cycles_per_ns;
+    summary.p90 = LatencyHistogram::quantile(counts, summary.count, 0.90) / cycles_per_ns;
+    summary.p99 = LatencyHistogram::quantile(counts, summary.count, 0.99) / cycles_per_ns;
+    summary.p999 = LatencyHistogram::quantile(counts, summary.count, 0.999) / cycles_per_ns;
+    summary.max = LatencyHistogram::quantile(counts, summary.count, 1.0) / cycles_per_ns;
+    return summary;
+}
+
+// Table of every operation that has run, with its non-zero outcome counts
+void printOperationMetrics() {
+    double cycles_per_ns = cyclesPerNanosecond();
+    cout << left << setw(14) << "Operation" << right << setw(10) << "Count" << setw(11) << "p50 (us)" 
+         << setw(11) << "p90 (us)" << setw(11) << "p99 (us)" << setw(11) << "p999 (us)" << setw(11) << "Max (us)" 
+         << "  Outcomes" << endl;
+    cout << fixed << setprecision(2);
+    for (size_t op = 0; op < METRIC_OP_COUNT; ++op) {
+        MetricsSummary summary = summarizeMetrics(MetricOp(op), cycles_per_ns);
+        if (summary.count == 0) {
+            continue;
+        }
+        cout << left << setw(14) << METRIC_OP_NAMES[op] << right << setw(10) << summary.count 
+             << setw(11) << summary.p50 / 1000 << setw(11) << summary.p90 / 1000 << setw(11) << summary.p99 / 1000 
+             << setw(11) << summary.p999 / 1000 << setw(11) << summary.max / 1000 << " ";
+        for (size_t status = 0; status < OPERATION_STATUS_COUNT; ++status) {
+            if (summary.outcomes[status] > 0) {
+                cout << " " << statusName(OperationStatus(status)) << "=" << summary.outcomes[status];
+            }
+        }
+        cout << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+// Write one JSON object per operation, e.g.
+//   {"op":"rent","count":12,"p50_ns":410.0,...,"outcomes":{"ok":10,"already_rented":2}}
+bool dumpOperationMetrics(const string& path) {
+    FILE* output = fopen(path.c_str(), "w");
+    if (output == nullptr) {
+        return false;
+    }
+    double cycles_per_ns = cyclesPerNanosecond();
+    for (size_t op = 0; op < METRIC_OP_COUNT; ++op) {
+        MetricsSummary summary = summarizeMetrics(MetricOp(op), cycles_per_ns);
+        fprintf(output, "{\"op\":\"%s\",\"count\":%llu,\"p50_ns\":%.1f,\"p90_ns\":%.1f,\"p99_ns\":%.1f,"
+                "\"p999_ns\":%.1f,\"max_ns\":%.1f,\"outcomes\":{", METRIC_OP_NAMES[op], 
+                (unsigned long long)summary.count, summary.p50, summary.p90, summary.p99, summary.p999, summary.max);
+        const char* separator = "";
+        for (size_t status = 0; status < OPERATION_STATUS_COUNT; ++status) {
+            if (summary.outcomes[status] > 0) {
+                fprintf(output, "%s\"%s\":%llu", separator, statusName(OperationStatus(status)), 
+                        (unsigned long long)summary.outcomes[status]);
+                separator = ",";
+            }
+        }
+        fprintf(output, "}}\n");
+    }
+    return fclose(output) == 0;
+}
+
+// Output for listings: rows are formatted straight into one buffer and written
+// to the sink in large blocks, instead of field by field through iostream
+// manipulators. A buffer without a sink only formats, for cached rows.
+class OutputBuffer {
+public:
+    static const size_t FLUSH_BYTES = 1 << 16;
+    string data;
+
+    explicit OutputBuffer(FILE* sink = stdout) : sink(sink) {}
+    ~OutputBuffer() { flush(); }
+
+    OutputBuffer& text(string_view value) {
+        data.append(value.data(), value.size());
+        return *this;
+    }
+
+    // Right-aligned in a field of the given width, like setw
+    OutputBuffer& padded(string_view value, int width) {
+        if ((int)value.size() < width) {
+            data.append(width - value.size(), ' ');
+        }
+        return text(value);
+    }
+
+    OutputBuffer& number(long long value, int width = 0) {
+        char digits[24];
+        auto converted = to_chars(digits, digits + sizeof(digits), value);
+        return padded(string_view(digits, converted.ptr - digits), width);
+    }
+
+    // Call after each row; writes the buffer out once it is large enough
+    void endRow() {
+        if (data.size() >= FLUSH_BYTES) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (sink == nullptr || data.empty()) {
+            return;
+        }
+        cout.flush();
+        fwrite(data.data(), 1, data.size(), sink);
+        data.clear();
+    }
+
+private:
+    FILE* sink;
+};
+
+// Display due date in readable format, with the day right-aligned in date_width.
+// Listings read the clock once and pass it in.
+void showDueDate(OutputBuffer& out, time_t due_date, time_t current_time, int date_width = 0) {
+    if (due_date == 0) {
+        out.padded("Not rented\n", 15);
+        return;
+    }
+    
+    if (current_time > due_date) {
+        out.padded("Overdue\n", 15);
+        return;
+    }
+    
+    // localtime dominates listing time, so keep a few recently seen calendar
+    // days. Each entry covers 23 hours from local midnight, which stays inside
+    // one local day even across DST changes.
+    struct CachedDay {
+        time_t begin = 1;
+        time_t end = 0;
+        tm date;
+    };
+    thread_local CachedDay recent_days[16];
+    CachedDay& day = recent_days[(due_date / 86400) % 16];
+    if (due_date < day.begin || due_date >= day.end) {
+        day.date = *localtime(&due_date);
+        day.begin = due_date - (day.date.tm_hour * 3600 + day.date.tm_min * 60 + day.date.tm_sec);
+        day.end = day.begin + 23 * 3600;
+    }
+    out.number(day.date.tm_mday, date_width).text("/")
+       .number(1 + day.date.tm_mon).text("/")
+       .number(1900 + day.date.tm_year).text("\n");
+}
+
+// Rows per page in interactive listings
+const size_t LISTING_PAGE_ROWS = 100;
+
+// Print a listing one page at a time: header(out) starts each page and
+// render(out, index) writes row index of total. Between pages the user
+// chooses whether to continue, so huge tables never flood the terminal.
+template <typename Header, typename Render>
+void showPaged(size_t total, const char* noun, Header header, Render render) {
+    size_t offset = 0;
+    while (true) {
+        size_t end = min(total, offset + LISTING_PAGE_ROWS);
+        {
+            OperationTimer timer(MetricOp::Listing);
+            OutputBuffer out;
+            header(out);
+            for (size_t index = offset; index < end; ++index) {
+                render(out, index);
+                out.endRow();
+            }
+            out.flush();
+            timer.finish(OperationStatus::Success);
+        }
+        if (end >= total) {
+            return;
+        }
+        cout << "Showing " << end << " of " << total << " " << noun 
+             << ". Enter n for the next page or 0 to stop: ";
+        char choice;
+        cin >> choice;
+        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        if (choice != 'n') {
+            return;
+        }
+        offset = end;
+    }
+}
+
+//======================= VEHICLE CLASS =======================//
+
+class Vehicle {
+public:
+    int vehicle_id;
+    string brand_name;
+    string vehicle_model;
+    int daily_rent;
+    int market_price;
+    int seating_capacity;
+    string vehicle_color;
+    bool is_rented;
+    time_t return_deadline;
+    static atomic<int> vehicle_counter;  // shared by every thread that adds vehicles
+    int vehicle_condition;
+    
+    friend class Administrator;
+
+    Vehicle(string brand, string model, int rent, int price, int seats, 
+            string color, int condition = 100, time_t deadline = 0) {
+        this->vehicle_id = ++vehicle_counter;
+        this->brand_name = brand;
+        this->vehicle_model = model;
+        this->market_price = price;
+        this->daily_rent = rent;
+        this->seating_capacity = seats;
+        this->vehicle_color = color;
+        this->is_rented = false;
+        this->vehicle_condition = condition;
+        this->return_deadline = deadline;
+    }
+};
+
+atomic<int> Vehicle::vehicle_counter{0};
+
+//======================= STRING POOL =======================//
+
+// Dictionary for a low-cardinality string column. Each distinct value is
+// copied once into an arena and gets a small sequential code; the column then
+// stores codes, so equality is an integer compare and the text is only looked
+// up when printing. Codes are never reused, so a pool only grows until it is
+// cleared. Interning needs exclusive access; text() may run on any thread.
+class StringPool {
+public:
+    static constexpr uint32_t NO_CODE = UINT32_MAX;
+
+    uint32_t intern(string_view value) {
+        auto found = codes.find(value);
+        if (found != codes.end()) {
+            return found->second;
+        }
+        string_view stored = store(value);
+        uint32_t code = (uint32_t)texts.size();
+        texts.push_back(stored);
+        codes.emplace(stored, code);
+        return code;
+    }
+
+    // Code of a value already in the pool, or NO_CODE
+    uint32_t find(string_view value) const {
+        auto found = codes.find(value);
+        return found == codes.end() ? NO_CODE : found->second;
+    }
+
+    string_view text(uint32_t code) const { return texts[code]; }
+    size_t size() const { return texts.size(); }
+
+    // Arena blocks plus the code tables, for memory reports
+    size_t memoryBytes() const {
+        return arena_bytes + texts.capacity() * sizeof(string_view) 
+             + codes.bucket_count() * sizeof(void*) + codes.size() * (sizeof(pair<string_view, uint32_t>) + 2 * sizeof(void*));
+    }
+
+    void clear() {
+        codes.clear();
+        texts.clear();
+        blocks.clear();
+        block_used = BLOCK_BYTES;
+        arena_bytes = 0;
+    }
+
+private:
+    static constexpr size_t BLOCK_BYTES = 16 * 1024;
+
+    // Copy a value into the arena; blocks never move, so the views stay valid
+    string_view store(string_view value) {
+        if (value.empty()) {
+            return string_view();
+        }
+        if (value.size() > BLOCK_BYTES) {
+            // Oversized values get a block of their own
+            blocks.emplace_back(new char[value.size()]);
+            arena_bytes += value.size();
+            block_used = BLOCK_BYTES;
+            memcpy(blocks.back().get(), value.data(), value.size());
+            return string_view(blocks.back().get(), value.size());
+        }
+        if (value.size() > BLOCK_BYTES - block_used) {
+            blocks.emplace_back(new char[BLOCK_BYTES]);
+            arena_bytes += BLOCK_BYTES;
+            block_used = 0;
+        }
+        char* target = blocks.back().get() + block_used;
+        memcpy(target, value.data(), value.size());
+        block_used += value.size();
+        return string_view(target, value.size());
+    }
+
+    vector<unique_ptr<char[]>> blocks;
+    size_t block_used = BLOCK_BYTES;
+    size_t arena_bytes = 0;
+    vector<string_view> texts;
+    unordered_map<string_view, uint32_t> codes;
+};
+
+//======================= FLEET INDEXES =======================//
+
+// Secondary indexes over the fleet columns, owned and kept current by the
+// FleetStore. Numeric fields get a sorted (value, slot) index for range
+// queries; low-cardinality fields get one bitmap of slots per pool code.
+
+// Sorted (value, slot) pairs for one numeric column. New pairs collect in a
+// small unsorted pending list that is folded in once it grows, so adding rows
+// one by one stays cheap. A changed or removed row leaves its old pair behind
+// rather than searching for it; readers check each pair against the column and
+// drop it when the values differ, and the index rebuilds itself once stale
+// pairs outnumber the live ones. A row set back to an earlier value can show
+// up twice, so readers collect slots into a bitmap rather than counting pairs.
+class SortedIndex {
+public:
+    struct Entry {
+        int32_t value;
+        uint32_t slot;
+
+        bool operator<(const Entry& other) const {
+            return value != other.value ? value < other.value : slot < other.slot;
+        }
+    };
+
+    void clear() {
+        sorted.clear();
+        pending.clear();
+        stale = 0;
+    }
+
+    void build(const vector<int>& column, const vector<uint64_t>& live_rows) {
+        clear();
+        sorted.reserve(column.size());
+        for (size_t slot = 0; slot < column.size(); ++slot) {
+            if ((live_rows[slot / 64] >> (slot % 64)) & 1) {
+                sorted.push_back({column[slot], (uint32_t)slot});
+            }
+        }
+        sort(sorted.begin(), sorted.end());
+    }
+
+    void add(int value, size_t slot) {
+        pending.push_back({value, (uint32_t)slot});
+        if (pending.size() > max<size_t>(4096, sorted.size() / 64)) {
+            size_t middle = sorted.size();
+            sort(pending.begin(), pending.end());
+            sorted.insert(sorted.end(), pending.begin(), pending.end());
+            inplace_merge(sorted.begin(), sorted.begin() + middle, sorted.end());
+            pending.clear();
+        }
+    }
+
+    // A pair no longer matches its row. True once the index should be rebuilt.
+    bool markStale() { return ++stale > sorted.size() / 2 + 4096; }
+
+    // Upper bound on the rows with a value in [low, high]
+    size_t estimate(int low, int high) const {
+        auto range = find(low, high);
+        return (range.second - range.first) + pending.size();
+    }
+
+    // Call visit(value, slot) for each pair in [low, high]; the caller checks them against the column
+    template <typename Visitor>
+    void forRange(int low, int high, Visitor visit) const {
+        auto range = find(low, high);
+        for (auto entry = range.first; entry != range.second; ++entry) {
+            visit(entry->value, entry->slot);
+        }
+        for (const Entry& entry : pending) {
+            if (entry.value >= low && entry.value <= high) {
+                visit(entry.value, entry.slot);
+            }
+        }
+    }
+
+    size_t memoryBytes() const { return (sorted.capacity() + pending.capacity()) * sizeof(Entry); }
+
+private:
+    vector<Entry> sorted;
+    vector<Entry> pending;
+    size_t stale = 0;
+
+    pair<vector<Entry>::const_iterator, vector<Entry>::const_iterator> find(int low, int high) const {
+        if (low > high) {
+            return {sorted.end(), sorted.end()};
+        }
+        auto first = lower_bound(sorted.begin(), sorted.end(), Entry{low, 0});
+        auto last = upper_bound(first, sorted.end(), Entry{high, UINT32_MAX});
+        return {first, last};
+    }
+};
+
+// One bitmap of slots per pool code, plus how many bits each has set. A
+// bitmap only grows as far as the highest slot holding its code.
+class CodeBitmaps {
+public:
+    void clear() {
+        rows.clear();
+        counts.clear();
+    }
+
+    void set(uint32_t code, size_t slot) {
+        if (code >= rows.size()) {
+            rows.resize(code + 1);
+            counts.resize(code + 1, 0);
+        }
+        vector<uint64_t>& bitmap = rows[code];
+        if (slot / 64 >= bitmap.size()) {
+            bitmap.resize(slot / 64 + 1, 0);
+        }
+        bitmap[slot / 64] |= uint64_t(1) << (slot % 64);
+        ++counts[code];
+    }
+
+    void reset(uint32_t code, size_t slot) {
+        rows[code][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+        --counts[code];
+    }
+
+    size_t count(uint32_t code) const { return code < counts.size() ? counts[code] : 0; }
+
+    // A code's bitmap; slots past its end do not hold the code
+    const vector<uint64_t>& bitmap(uint32_t code) const {
+        static const vector<uint64_t> empty;
+        return code < rows.size() ? rows[code] : empty;
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = counts.capacity() * sizeof(size_t);
+        for (const auto& bitmap : rows) {
+            bytes += bitmap.capacity() * sizeof(uint64_t);
+        }
+        return bytes;
+    }
+
+private:
+    vector<vector<uint64_t>> rows;
+    vector<size_t> counts;
+};
+
+// Everything the fleet search reads besides the columns themselves. Built on
+// demand: bulk loads leave the indexes down and the first search (or
+// prepareConcurrentRentals) builds them, after which every mutation through
+// FleetStore keeps them current.
+struct FleetIndexes {
+    bool ready = false;
+    SortedIndex rent;
+    SortedIndex seats;
+    SortedIndex condition;
+    CodeBitmaps brand;
+    CodeBitmaps model;
+    CodeBitmaps color;
+    vector<uint64_t> available_rows;  // live and not rented; flipped atomically by concurrent renters
+
+    void clear() {
+        ready = false;
+        rent.clear(); seats.clear(); condition.clear();
+        brand.clear(); model.clear(); color.clear();
+        available_rows.clear();
+    }
+
+    size_t memoryBytes() const {
+        return rent.memoryBytes() + seats.memoryBytes() + condition.memoryBytes() + brand.memoryBytes()
+             + model.memoryBytes() + color.memoryBytes() + available_rows.capacity() * sizeof(uint64_t);
+    }
+};
+
+//======================= FLEET STORE =======================//
+
+// Column-oriented vehicle inventory. Each field lives in its own contiguous
+// array indexed by slot, so scans that only look at rent, seats, condition or
+// availability never touch the string columns. Brand, model and color are
+// stored as codes into per-column string pools. Indexed fields are changed
+// through the setters below so the secondary indexes follow.
+class FleetStore {
+public:
+    vector<int> vehicle_id;
+    vector<uint32_t> brand_code;
+    vector<uint32_t> model_code;
+    vector<uint32_t> color_code;
+    StringPool brand_pool;
+    StringPool model_pool;
+    StringPool color_pool;
+    vector<int> market_price;
+    vector<int> daily_rent;
+    vector<int> seating_capacity;
+    vector<int> vehicle_condition;
+    vector<uint8_t> is_rented;
+    vector<time_t> return_deadline;
+    vector<int32_t> accrued_days;  // whole late days already charged to the open rental
+    vector<int64_t> revenue;       // rent and late fees billed on this vehicle so far
+    vector<uint32_t> row_version;  // bumped whenever a listed field changes; not saved in snapshots
+    // Removed vehicles stay in place as tombstones (vehicle_id 0, bit cleared
+    // here) until compact() squeezes them out, so a removal moves nothing
+    vector<uint64_t> live_rows;
+    size_t dead_rows = 0;
+    FleetIndexes indexes;  // built on first search, then kept current by the mutators
+
+    size_t size() const { return vehicle_id.size(); }
+    size_t liveCount() const { return size() - dead_rows; }
+    bool isLive(size_t slot) const { return (live_rows[slot / 64] >> (slot % 64)) & 1; }
+
+    string_view brand(size_t slot) const { return brand_pool.text(brand_code[slot]); }
+    string_view model(size_t slot) const { return model_pool.text(model_code[slot]); }
+    string_view color(size_t slot) const { return color_pool.text(color_code[slot]); }
+    void setBrand(size_t slot, string_view value) { setCode(brand_code, indexes.brand, slot, brand_pool.intern(value)); }
+    void setModel(size_t slot, string_view value) { setCode(model_code, indexes.model, slot, model_pool.intern(value)); }
+    void setColor(size_t slot, string_view value) { setCode(color_code, indexes.color, slot, color_pool.intern(value)); }
+    void setRent(size_t slot, int value) { setNumber(daily_rent, indexes.rent, slot, value); }
+    void setSeats(size_t slot, int value) { setNumber(seating_capacity, indexes.seats, slot, value); }
+    void setCondition(size_t slot, int value) { setNumber(vehicle_condition, indexes.condition, slot, value); }
+
+    // Only the thread holding the vehicle flips its flag; searches may read it concurrently
+    void setRented(size_t slot, bool rented) {
+        storeShared(is_rented[slot], uint8_t(rented));
+        markAvailable(slot, !rented);
+    }
+
+    // Take an available vehicle. False if another renter got there first.
+    bool claim(size_t slot) {
+        if (!compareAndSwapShared(is_rented[slot], uint8_t(0), uint8_t(1))) {
+            return false;
+        }
+        markAvailable(slot, false);
+        return true;
+    }
+
+    // Mark a vehicle's listing row stale. Only the thread holding the vehicle
+    // (or the admin, with exclusive access) changes its fields, so a plain
+    // increment is enough.
+    void touch(size_t slot) { ++row_version[slot]; }
+
+    void clear() {
+        vehicle_id.clear(); brand_code.clear(); model_code.clear(); color_code.clear();
+        brand_pool.clear(); model_pool.clear(); color_pool.clear();
+        market_price.clear(); daily_rent.clear(); seating_capacity.clear();
+        vehicle_condition.clear(); is_rented.clear(); return_deadline.clear(); accrued_days.clear();
+        revenue.clear(); row_version.clear();
+        live_rows.clear();
+        dead_rows = 0;
+        indexes.clear();
+    }
+
+    void reserve(size_t count) {
+        vehicle_id.reserve(count); brand_code.reserve(count); model_code.reserve(count);
+        color_code.reserve(count); market_price.reserve(count); daily_rent.reserve(count);
+        seating_capacity.reserve(count); vehicle_condition.reserve(count);
+        is_rented.reserve(count); return_deadline.reserve(count); accrued_days.reserve(count);
+        revenue.reserve(count); row_version.reserve(count);
+    }
+
+    void append(const Vehicle& vehicle) {
+        vehicle_id.push_back(vehicle.vehicle_id);
+        brand_code.push_back(brand_pool.intern(vehicle.brand_name));
+        model_code.push_back(model_pool.intern(vehicle.vehicle_model));
+        color_code.push_back(color_pool.intern(vehicle.vehicle_color));
+        market_price.push_back(vehicle.market_price);
+        daily_rent.push_back(vehicle.daily_rent);
+        seating_capacity.push_back(vehicle.seating_capacity);
+        vehicle_condition.push_back(vehicle.vehicle_condition);
+        is_rented.push_back(vehicle.is_rented);
+        return_deadline.push_back(vehicle.return_deadline);
+        accrued_days.push_back(0);
+        revenue.push_back(0);
+        row_version.push_back(0);
+        size_t slot = size() - 1;
+        if (slot % 64 == 0) {
+            live_rows.push_back(0);
+        }
+        live_rows[slot / 64] |= uint64_t(1) << (slot % 64);
+        if (indexes.ready) {
+            indexRow(slot);
+        }
+    }
+
+    // O(1) removal: the row stays where it is, so no other slot moves
+    void tombstone(size_t slot) {
+        if (indexes.ready) {
+            indexes.brand.reset(brand_code[slot], slot);
+            indexes.model.reset(model_code[slot], slot);
+            indexes.color.reset(color_code[slot], slot);
+            markAvailable(slot, false);
+            dropNumber(daily_rent, indexes.rent);
+            dropNumber(seating_capacity, indexes.seats);
+            dropNumber(vehicle_condition, indexes.condition);
+        }
+        live_rows[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+        vehicle_id[slot] = 0;
+        is_rented[slot] = 0;
+        return_deadline[slot] = 0;
+        accrued_days[slot] = 0;
+        revenue[slot] = 0;
+        ++dead_rows;
+    }
+
+    // Only the thread holding the vehicle bills it; reports may read the total concurrently
+    void addRevenue(size_t slot, int64_t amount) { storeShared(revenue[slot], loadShared(revenue[slot]) + amount); }
+
+    // Every row live, for columns filled in bulk
+    void markAllLive() {
+        live_rows.assign((size() + 63) / 64, ~uint64_t(0));
+        if (size() % 64 != 0) {
+            live_rows.back() = (uint64_t(1) << (size() % 64)) - 1;
+        }
+        dead_rows = 0;
+    }
+
+    // Drop the tombstones in one pass, keeping live rows in their order.
+    // Slots of later rows change, so the ID table must be rebuilt afterwards.
+    void compact() {
+        keepLive(vehicle_id); keepLive(brand_code); keepLive(model_code); keepLive(color_code);
+        keepLive(market_price); keepLive(daily_rent); keepLive(seating_capacity); keepLive(vehicle_condition);
+        keepLive(is_rented); keepLive(return_deadline); keepLive(accrued_days); keepLive(revenue);
+        keepLive(row_version);
+        markAllLive();
+        // Slots moved, so indexes that were up are rebuilt rather than dropped
+        if (indexes.ready) {
+            buildIndexes();
+        }
+    }
+
+    // Index every live row from scratch. Needs exclusive access.
+    void buildIndexes() {
+        indexes.clear();
+        indexes.rent.build(daily_rent, live_rows);
+        indexes.seats.build(seating_capacity, live_rows);
+        indexes.condition.build(vehicle_condition, live_rows);
+        indexes.available_rows.assign(live_rows.size(), 0);
+        for (size_t slot = 0; slot < size(); ++slot) {
+            if (isLive(slot)) {
+                indexes.brand.set(brand_code[slot], slot);
+                indexes.model.set(model_code[slot], slot);
+                indexes.color.set(color_code[slot], slot);
+                if (!loadShared(is_rented[slot])) {
+                    indexes.available_rows[slot / 64] |= uint64_t(1) << (slot % 64);
+                }
+            }
+        }
+        indexes.ready = true;
+    }
+
+private:
+    void indexRow(size_t slot) {
+        indexes.rent.add(daily_rent[slot], slot);
+        indexes.seats.add(seating_capacity[slot], slot);
+        indexes.condition.add(vehicle_condition[slot], slot);
+        indexes.brand.set(brand_code[slot], slot);
+        indexes.model.set(model_code[slot], slot);
+        indexes.color.set(color_code[slot], slot);
+        if (indexes.available_rows.size() < live_rows.size()) {
+            indexes.available_rows.resize(live_rows.size(), 0);
+        }
+        markAvailable(slot, !is_rented[slot]);
+    }
+
+    void markAvailable(size_t slot, bool available) {
+        if (indexes.ready) {
+            setBitsShared(indexes.available_rows[slot / 64], uint64_t(1) << (slot % 64), available);
+        }
+    }
+
+    void setCode(vector<uint32_t>& codes, CodeBitmaps& bitmaps, size_t slot, uint32_t code) {
+        if (indexes.ready && codes[slot] != code) {
+            bitmaps.reset(codes[slot], slot);
+            bitmaps.set(code, slot);
+        }
+        codes[slot] = code;
+    }
+
+    // The old (value, slot) pair stays in the index as a stale entry that
+    // lookups skip; the new pair goes to the pending list
+    void setNumber(vector<int>& column, SortedIndex& index, size_t slot, int value) {
+        bool changed = column[slot] != value;
+        column[slot] = value;
+        if (indexes.ready && changed) {
+            index.add(value, slot);
+            dropNumber(column, index);
+        }
+    }
+
+    void dropNumber(const vector<int>& column, SortedIndex& index) {
+        if (index.markStale()) {
+            index.build(column, live_rows);
+        }
+    }
+
+    template <typename Column>
+    void keepLive(Column& column) const {
+        size_t kept = 0;
+        for (size_t slot = 0; slot < column.size(); ++slot) {
+            if (isLive(slot)) {
+                column[kept++] = column[slot];
+            }
+        }
+        column.resize(kept);
+    }
+};
+
+FleetStore vehicle_inventory;
+
+// Dense ID -> inventory slot table. Vehicle IDs come from a sequential counter,
+// so the ID itself indexes the table; removed vehicles map to -1. IDs are never
+// handed out twice, which makes an ID a stable handle: it survives inserts,
+// removals and compaction, and one kept after its vehicle is removed resolves
+// to -1 instead of to a newer vehicle. Slots are not stable across compaction.
+vector<int> vehicle_slot_by_id;
+
+// Point the ID table at every vehicle stored from the given slot onwards
+void reindexVehicles(size_t first_slot) {
+    for (size_t slot = first_slot; slot < vehicle_inventory.size(); ++slot) {
+        int vehicle_id = vehicle_inventory.vehicle_id[slot];
+        if (vehicle_id >= (int)vehicle_slot_by_id.size()) {
+            vehicle_slot_by_id.resize(vehicle_id + 1, -1);
+        }
+        vehicle_slot_by_id[vehicle_id] = (int)slot;
+    }
+}
+
+// Versioned-table upkeep for fleet edits (defined with the versioned tables)
+void versionVehicleEdit(size_t slot);
+void markVersionedTablesStale();
+
+// Append a vehicle to the inventory and register it in the ID table
+void addVehicle(const Vehicle& vehicle) {
+    vehicle_inventory.append(vehicle);
+    reindexVehicles(vehicle_inventory.size() - 1);
+    versionVehicleEdit(vehicle_inventory.size() - 1);
+}
+
+// Constant-time lookup; returns the inventory slot, or -1 for unknown or removed IDs
+int findVehicleSlot(int vehicle_id) {
+    if (vehicle_id <= 0 || vehicle_id >= (int)vehicle_slot_by_id.size()) {
+        return -1;
+    }
+    return vehicle_slot_by_id[vehicle_id];
+}
+
+// Squeeze out removed vehicles and repoint the ID table at the moved rows
+void compactVehicles() {
+    if (vehicle_inventory.dead_rows == 0) {
+        return;
+    }
+    vehicle_inventory.compact();
+    reindexVehicles(0);
+    // The versioned fleet rows are keyed by slot, and the slots just moved
+    markVersionedTablesStale();
+}
+
+// Remove the vehicle at the given slot in O(1) by tombstoning it. Compaction
+// runs once half the rows are dead, so its cost is amortized over the removals.
+void eraseVehicle(size_t slot) {
+    vehicle_slot_by_id[vehicle_inventory.vehicle_id[slot]] = -1;
+    vehicle_inventory.tombstone(slot);
+    versionVehicleEdit(slot);
+    if (vehicle_inventory.dead_rows * 2 > vehicle_inventory.size()) {
+        compactVehicles();
+    }
+}
+
+//======================= FLEET LISTINGS =======================//
+
+// Rendered fleet rows, reused until the vehicle's row_version changes or a
+// due date shown on the row passes. Rows are keyed by slot and also remember
+// the vehicle ID, so slots shifted by a removal simply miss.
+class VehicleRowCache {
+public:
+    size_t hits = 0;
+    size_t misses = 0;
+
+    void render(OutputBuffer& out, size_t slot, time_t current_time);
+    // Same row with the rental state a snapshot saw in place of the live one
+    void render(OutputBuffer& out, size_t slot, bool rented, time_t deadline, time_t current_time);
+    void clear() { rows.clear(); }
+
+private:
+    struct CachedRow {
+        int vehicle_id = 0;
+        uint32_t version = 0;
+        bool rented = false;
+        time_t deadline = 0;
+        time_t valid_until = 0;
+        string text;
+    };
+    vector<CachedRow> rows;
+};
+
+VehicleRowCache vehicle_row_cache;
+
+void VehicleRowCache::render(OutputBuffer& out, size_t slot, time_t current_time) {
+    const FleetStore& fleet = vehicle_inventory;
+    render(out, slot, fleet.is_rented[slot], fleet.return_deadline[slot], current_time);
+}
+
+void VehicleRowCache::render(OutputBuffer& out, size_t slot, bool rented, time_t deadline, time_t current_time) {
+    const FleetStore& fleet = vehicle_inventory;
+    if (rows.size() < fleet.size()) {
+        rows.resize(fleet.size());
+    }
+    CachedRow& row = rows[slot];
+    if (row.vehicle_id == fleet.vehicle_id[slot] && row.version == fleet.row_version[slot] && row.rented == rented 
+            && row.deadline == deadline && current_time <= row.valid_until) {
+        ++hits;
+        out.text(row.text);
+        return;
+    }
+    
+    ++misses;
+    OutputBuffer line(nullptr);
+    line.data.swap(row.text);
+    line.data.clear();
+    line.number(fleet.vehicle_id[slot], 3).padded(fleet.brand(slot), 15)
+        .padded(fleet.model(slot), 15).number(fleet.daily_rent[slot], 7)
+        .number(fleet.market_price[slot], 12).number(fleet.seating_capacity[slot], 6)
+        .padded(fleet.color(slot), 10).number(!rented, 10)
+        .number(fleet.vehicle_condition[slot], 10);
+    showDueDate(line, deadline, current_time, 15);
+    
+    row.vehicle_id = fleet.vehicle_id[slot];
+    row.version = fleet.row_version[slot];
+    row.rented = rented;
+    row.deadline = deadline;
+    // A row showing a date turns into "Overdue" once the deadline passes
+    row.valid_until = deadline != 0 && current_time <= deadline ? deadline : numeric_limits<time_t>::max();
+    row.text.swap(line.data);
+    out.text(row.text);
+}
+
+//======================= FLEET FILTERS =======================//
+
+// Numeric predicates for fleet scans. A vehicle is selected when every
+// condition holds; the defaults select the whole fleet.
+struct FleetFilter {
+    int min_seats = 0;
+    int max_rent = INT_MAX;
+    int min_condition = INT_MIN;
+    bool available_only = false;
+    // Exact brand/color matches compare pool codes; an unknown name is StringPool::NO_CODE and matches nothing
+    bool match_brand = false;
+    uint32_t brand_code = 0;
+    bool match_color = false;
+    uint32_t color_code = 0;
+
+    void setBrand(string_view brand) {
+        match_brand = true;
+        brand_code = vehicle_inventory.brand_pool.find(brand);
+    }
+
+    void setColor(string_view color) {
+        match_color = true;
+        color_code = vehicle_inventory.color_pool.find(color);
+    }
+};
+
+// One bit per inventory slot, set when the slot matches the filter
+typedef vector<uint64_t> SelectionBitmap;
+
+// Scalar kernel: fills bitmap words [first_word, word_count) one row at a time
+void filterFleetScalar(const FleetFilter& filter, uint64_t* bitmap, size_t first_word, size_t rows) {
+    const int* rent = vehicle_inventory.daily_rent.data();
+    const int* seats = vehicle_inventory.seating_capacity.data();
+    const int* condition = vehicle_inventory.vehicle_condition.data();
+    const uint8_t* rented = vehicle_inventory.is_rented.data();
+    const uint32_t* brand = vehicle_inventory.brand_code.data();
+    const uint32_t* color = vehicle_inventory.color_code.data();
+    bool check_rented = filter.available_only;
+    uint32_t brand_mask = filter.match_brand ? UINT32_MAX : 0;
+    uint32_t color_mask = filter.match_color ? UINT32_MAX : 0;
+    
+    for (size_t row = first_word * 64; row < rows; ++row) {
+        bool match = seats[row] >= filter.min_seats && rent[row] <= filter.max_rent 
+                  && condition[row] >= filter.min_condition && !(check_rented && rented[row])
+                  && ((brand[row] ^ filter.brand_code) & brand_mask) == 0
+                  && ((color[row] ^ filter.color_code) & color_mask) == 0;
+        bitmap[row / 64] |= uint64_t(match) << (row % 64);
+    }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FLEET_FILTER_SIMD 1
+
+// SSE4.1 kernel: 4 rows per compare, 64 rows per bitmap word
+__attribute__((target("sse4.1")))
+size_t filterFleetSse(const FleetFilter& filter, uint64_t* bitmap, size_t rows) {
+    const int* rent = vehicle_inventory.daily_rent.data();
+    const int* seats = vehicle_inventory.seating_capacity.data();
+    const int* condition = vehicle_inventory.vehicle_condition.data();
+    const uint8_t* rented = vehicle_inventory.is_rented.data();
+    // a >= b is evaluated as a > b - 1, so clamp the bounds to keep them representable
+    const __m128i seats_floor = _mm_set1_epi32(max(filter.min_seats, INT_MIN + 1) - 1);
+    const __m128i rent_ceiling = _mm_set1_epi32(min(filter.max_rent, INT_MAX - 1) + 1);
+    const __m128i condition_floor = _mm_set1_epi32(max(filter.min_condition, INT_MIN + 1) - 1);
+    // The rented column is only read when the filter asks for it; it may be changing under concurrent rentals
+    const bool check_rented = filter.available_only;
+    const uint32_t* brand = vehicle_inventory.brand_code.data();
+    const uint32_t* color = vehicle_inventory.color_code.data();
+    // Code columns are compared as (code ^ wanted) & mask == 0, so an unused filter masks to zero
+    const __m128i brand_wanted = _mm_set1_epi32((int)filter.brand_code);
+    const __m128i brand_mask = _mm_set1_epi32(filter.match_brand ? -1 : 0);
+    const __m128i color_wanted = _mm_set1_epi32((int)filter.color_code);
+    const __m128i color_mask = _mm_set1_epi32(filter.match_color ? -1 : 0);
+    const __m128i zero = _mm_setzero_si128();
+    
+    size_t full_words = rows / 64;
+    for (size_t word = 0; word < full_words; ++word) {
+        uint64_t bits = 0;
+        for (size_t lane = 0; lane < 64; lane += 4) {
+            size_t row = word * 64 + lane;
+            __m128i match = _mm_and_si128(
+                _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)(seats + row)), seats_floor),
+                _mm_cmplt_epi32(_mm_loadu_si128((const __m128i*)(rent + row)), rent_ceiling));
+            match = _mm_and_si128(match, 
+                _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)(condition + row)), condition_floor));
+            if (check_rented) {
+                int32_t rented_bytes;
+                memcpy(&rented_bytes, rented + row, sizeof(rented_bytes));
+                __m128i rented_lanes = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(rented_bytes));
+                match = _mm_and_si128(match, _mm_cmpeq_epi32(rented_lanes, zero));
+            }
+            __m128i brand_miss = _mm_and_si128(
+                _mm_xor_si128(_mm_loadu_si128((const __m128i*)(brand + row)), brand_wanted), brand_mask);
+            __m128i color_miss = _mm_and_si128(
+                _mm_xor_si128(_mm_loadu_si128((const __m128i*)(color + row)), color_wanted), color_mask);
+            match = _mm_and_si128(match, _mm_cmpeq_epi32(_mm_or_si128(brand_miss, color_miss), zero));
+            bits |= uint64_t(_mm_movemask_ps(_mm_castsi128_ps(match))) << lane;
+        }
+        bitmap[word] = bits;
+    }
+    return full_words;
+}
+
+// AVX2 kernel: 8 rows per compare, 64 rows per bitmap word
+__attribute__((target("avx2")))
+size_t filterFleetAvx2(const FleetFilter& filter, uint64_t* bitmap, size_t rows) {
+    const int* rent = vehicle_inventory.daily_rent.data();
+    const int* seats = vehicle_inventory.seating_capacity.data();
+    const int* condition = vehicle_inventory.vehicle_condition.data();
+    const uint8_t* rented = vehicle_inventory.is_rented.data();
+    const __m256i seats_floor = _mm256_set1_epi32(max(filter.min_seats, INT_MIN + 1) - 1);
+    const __m256i rent_ceiling = _mm256_set1_epi32(min(filter.max_rent, INT_MAX - 1) + 1);
+    const __m256i condition_floor = _mm256_set1_epi32(max(filter.min_condition, INT_MIN + 1) - 1);
+    const bool check_rented = filter.available_only;
+    const uint32_t* brand = vehicle_inventory.brand_code.data();
+    const uint32_t* color = vehicle_inventory.color_code.data();
+    const __m256i brand_wanted = _mm256_set1_epi32((int)filter.brand_code);
+    const __m256i brand_mask = _mm256_set1_epi32(filter.match_brand ? -1 : 0);
+    const __m256i color_wanted = _mm256_set1_epi32((int)filter.color_code);
+    const __m256i color_mask = _mm256_set1_epi32(filter.match_color ? -1 : 0);
+    const __m256i zero = _mm256_setzero_si256();
+    
+    size_t full_words = rows / 64;
+    for (size_t word = 0; word < full_words; ++word) {
+        uint64_t bits = 0;
+        for (size_t lane = 0; lane < 64; lane += 8) {
+            size_t row = word * 64 + lane;
+            __m256i match = _mm256_and_si256(
+                _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)(seats + row)), seats_floor),
+                _mm256_cmpgt_epi32(rent_ceiling, _mm256_loadu_si256((const __m256i*)(rent + row))));
+            match = _mm256_and_si256(match, 
+                _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)(condition + row)), condition_floor));
+            if (check_rented) {
+                __m256i rented_lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(rented + row)));
+                match = _mm256_and_si256(match, _mm256_cmpeq_epi32(rented_lanes, zero));
+            }
+            __m256i brand_miss = _mm256_and_si256(
+                _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(brand + row)), brand_wanted), brand_mask);
+            __m256i color_miss = _mm256_and_si256(
+                _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(color + row)), color_wanted), color_mask);
+            match = _mm256_and_si256(match, _mm256_cmpeq_epi32(_mm256_or_si256(brand_miss, color_miss), zero));
+            bits |= uint64_t(uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(match)))) << lane;
+        }
+        bitmap[word] = bits;
+    }
+    return full_words;
+}
+#endif
+
+enum class FilterKernel {
+    Scalar,
+    Sse,
+    Avx2
+};
+
+// Widest kernel the running CPU supports
+FilterKernel bestFilterKernel() {
+#ifdef FLEET_FILTER_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        return FilterKernel::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return FilterKernel::Sse;
+    }
+#endif
+    return FilterKernel::Scalar;
+}
+
+// Evaluate a filter over the whole inventory into a selection bitmap
+void filterFleet(const FleetFilter& filter, SelectionBitmap& selection, 
+                 FilterKernel kernel = bestFilterKernel()) {
+    size_t rows = vehicle_inventory.size();
+    selection.assign((rows + 63) / 64, 0);
+    size_t done_words = 0;
+#ifdef FLEET_FILTER_SIMD
+    if (kernel == FilterKernel::Avx2) {
+        done_words = filterFleetAvx2(filter, selection.data(), rows);
+    } else if (kernel == FilterKernel::Sse) {
+        done_words = filterFleetSse(filter, selection.data(), rows);
+    }
+#else
+    (void)kernel;
+#endif
+    filterFleetScalar(filter, selection.data(), done_words, rows);
+    if (vehicle_inventory.dead_rows != 0) {
+        for (size_t word = 0; word < selection.size(); ++word) {
+            selection[word] &= vehicle_inventory.live_rows[word];
+        }
+    }
+}
+
+// Call the visitor with every selected slot, in inventory order
+template <typename Visitor>
+void forEachSelected(const SelectionBitmap& selection, Visitor visit) {
+    for (size_t word = 0; word < selection.size(); ++word) {
+        uint64_t bits = selection[word];
+        while (bits != 0) {
+            visit(word * 64 + __builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
+}
+
+//======================= FLEET SEARCH =======================//
+
+// Fleet search over the secondary indexes. Unlike a FleetFilter every field
+// can be bounded on both sides, and model can be matched too. Defaults
+// select the whole fleet.
+struct FleetSearch {
+    int min_seats = INT_MIN;
+    int max_seats = INT_MAX;
+    int min_rent = INT_MIN;
+    int max_rent = INT_MAX;
+    int min_condition = INT_MIN;
+    bool available_only = false;
+    bool match_brand = false;
+    uint32_t brand_code = 0;
+    bool match_model = false;
+    uint32_t model_code = 0;
+    bool match_color = false;
+    uint32_t color_code = 0;
+
+    void setBrand(string_view brand) {
+        match_brand = true;
+        brand_code = vehicle_inventory.brand_pool.find(brand);
+    }
+
+    void setModel(string_view model) {
+        match_model = true;
+        model_code = vehicle_inventory.model_pool.find(model);
+    }
+
+    void setColor(string_view color) {
+        match_color = true;
+        color_code = vehicle_inventory.color_pool.find(color);
+    }
+
+    bool boundsSeats() const { return min_seats != INT_MIN || max_seats != INT_MAX; }
+    bool boundsRent() const { return min_rent != INT_MIN || max_rent != INT_MAX; }
+
+    bool boundsNumbers() const { return boundsSeats() || boundsRent() || min_condition != INT_MIN; }
+
+    bool numbersMatch(size_t slot) const {
+        const FleetStore& fleet = vehicle_inventory;
+        return fleet.seating_capacity[slot] >= min_seats && fleet.seating_capacity[slot] <= max_seats
+            && fleet.daily_rent[slot] >= min_rent && fleet.daily_rent[slot] <= max_rent
+            && fleet.vehicle_condition[slot] >= min_condition;
+    }
+
+    // Check one live slot against every predicate
+    bool matches(size_t slot) const {
+        const FleetStore& fleet = vehicle_inventory;
+        return numbersMatch(slot)
+            && (!match_brand || fleet.brand_code[slot] == brand_code)
+            && (!match_model || fleet.model_code[slot] == model_code)
+            && (!match_color || fleet.color_code[slot] == color_code)
+            && (!available_only || ((loadShared(fleet.indexes.available_rows[slot / 64]) >> (slot % 64)) & 1));
+    }
+};
+
+// Run a search into a selection bitmap, driving it from whichever index
+// promises the fewest candidates:
+//  - a sorted index when one range predicate is narrow, checking each pair it
+//    yields against the row,
+//  - the AND of the brand/model/color bitmaps when one of those is rarer,
+//  - otherwise the SIMD scan, since a broad query touches most rows anyway.
+// Builds the indexes on first use; concurrent callers must have had
+// prepareConcurrentRentals build them first.
+void searchFleet(const FleetSearch& search, SelectionBitmap& selection) {
+    FleetStore& fleet = vehicle_inventory;
+    if (!fleet.indexes.ready) {
+        fleet.buildIndexes();
+    }
+    const FleetIndexes& indexes = fleet.indexes;
+    size_t rows = fleet.size();
+    selection.assign((rows + 63) / 64, 0);
+
+    const SortedIndex* range_index = nullptr;
+    int low = 0, high = 0;
+    size_t range_estimate = SIZE_MAX;
+    auto consider = [&](bool bounded, const SortedIndex& index, int index_low, int index_high) {
+        if (!bounded) {
+            return;
+        }
+        size_t estimate = index.estimate(index_low, index_high);
+        if (estimate < range_estimate) {
+            range_index = &index;
+            low = index_low;
+            high = index_high;
+            range_estimate = estimate;
+        }
+    };
+    consider(search.boundsRent(), indexes.rent, search.min_rent, search.max_rent);
+    consider(search.boundsSeats(), indexes.seats, search.min_seats, search.max_seats);
+    consider(search.min_condition != INT_MIN, indexes.condition, search.min_condition, INT_MAX);
+
+    // Bitmaps of the code predicates, rarest first. Unknown names are
+    // NO_CODE, whose count is zero, so they select nothing.
+    pair<size_t, const vector<uint64_t>*> bitmaps[3];
+    int bitmap_count = 0;
+    auto useBitmap = [&](bool wanted, const CodeBitmaps& index, uint32_t code) {
+        if (wanted) {
+            bitmaps[bitmap_count++] = {index.count(code), &index.bitmap(code)};
+        }
+    };
+    useBitmap(search.match_brand, indexes.brand, search.brand_code);
+    useBitmap(search.match_model, indexes.model, search.model_code);
+    useBitmap(search.match_color, indexes.color, search.color_code);
+    for (int i = 1; i < bitmap_count; ++i) {
+        for (int j = i; j > 0 && bitmaps[j].first < bitmaps[j - 1].first; --j) {
+            swap(bitmaps[j], bitmaps[j - 1]);
+        }
+    }
+    size_t code_count = bitmap_count != 0 ? bitmaps[0].first : SIZE_MAX;
+
+    if (code_count == 0 || range_estimate == 0) {
+        return;
+    }
+    if (range_index != nullptr && range_estimate <= code_count && range_estimate < rows / 8) {
+        const vector<int>& column = range_index == &indexes.rent ? fleet.daily_rent
+                                  : range_index == &indexes.seats ? fleet.seating_capacity : fleet.vehicle_condition;
+        range_index->forRange(low, high, [&](int value, size_t slot) {
+            if (column[slot] == value && fleet.isLive(slot) && search.matches(slot)) {
+                selection[slot / 64] |= uint64_t(1) << (slot % 64);
+            }
+        });
+        return;
+    }
+    if (bitmap_count != 0) {
+        bool check_numbers = search.boundsNumbers();
+        size_t words = bitmaps[0].second->size();
+        for (int i = 1; i < bitmap_count; ++i) {
+            words = min(words, bitmaps[i].second->size());
+        }
+        for (size_t word = 0; word < words; ++word) {
+            uint64_t bits = (*bitmaps[0].second)[word];
+            for (int i = 1; i < bitmap_count && bits != 0; ++i) {
+                bits &= (*bitmaps[i].second)[word];
+            }
+            if (search.available_only && bits != 0) {
+                bits &= loadShared(indexes.available_rows[word]);
+            }
+            if (check_numbers) {
+                for (uint64_t pending = bits; pending != 0; pending &= pending - 1) {
+                    if (!search.numbersMatch(word * 64 + __builtin_ctzll(pending))) {
+                        bits &= ~(pending & -pending);
+                    }
+                }
+            }
+            selection[word] = bits;
+        }
+        return;
+    }
+
+    // Broad query: scan the columns, then apply what the scan kernels cannot express
+    FleetFilter filter;
+    filter.min_seats = search.min_seats;
+    filter.max_rent = search.max_rent;
+    filter.min_condition = search.min_condition;
+    filterFleet(filter, selection);
+    bool check_rest = search.max_seats != INT_MAX || search.min_rent != INT_MIN;
+    for (size_t word = 0; word < selection.size(); ++word) {
+        uint64_t bits = selection[word];
+        if (search.available_only) {
+            bits &= loadShared(indexes.available_rows[word]);
+        }
+        if (check_rest) {
+            for (uint64_t pending = bits; pending != 0; pending &= pending - 1) {
+                size_t slot = word * 64 + __builtin_ctzll(pending);
+                if (fleet.seating_capacity[slot] > search.max_seats || fleet.daily_rent[slot] < search.min_rent) {
+                    bits &= ~(pending & -pending);
+                }
+            }
+        }
+        selection[word] = bits;
+    }
+}
+
+// Number of slots a selection holds
+size_t countSelected(const SelectionBitmap& selection) {
+    size_t count = 0;
+    for (uint64_t word : selection) {
+        count += __builtin_popcountll(word);
+    }
+    return count;
+}
+
+//======================= LATE FEE ACCRUAL =======================//
+
+// Selection kernels for the nightly late fee run. A rental is due another
+// charge once it has run a whole day past the deadline beyond the days already
+// accrued, i.e. deadline <= now - DAY * (accrued + 1). Comparing against that
+// threshold keeps the division out of the scan. The kernels take raw columns so
+// the benchmark can drive them over synthetic data.
+struct AccrualColumns {
+    const time_t* deadline;
+    const uint8_t* rented;
+    const int32_t* accrued;
+    size_t rows;
+};
+
+void selectAccruableScalar(const AccrualColumns& columns, time_t now, uint64_t* bitmap, size_t first_word) {
+    for (size_t row = first_word * 64; row < columns.rows; ++row) {
+        bool due = columns.rented[row] != 0 
+                && columns.deadline[row] <= now - int64_t(SECONDS_PER_DAY) * (columns.accrued[row] + 1);
+        bitmap[row / 64] |= uint64_t(due) << (row % 64);
+    }
+}
+
+#if defined(FLEET_FILTER_SIMD) && defined(__x86_64__)
+#define ACCRUAL_SIMD 1
+static_assert(sizeof(time_t) == 8, "AVX2 accrual kernel compares 64-bit deadlines");
+
+// AVX2 kernel: 4 rows per 64-bit compare, 64 rows per bitmap word
+__attribute__((target("avx2")))
+size_t selectAccruableAvx2(const AccrualColumns& columns, time_t now, uint64_t* bitmap) {
+    const __m256i day = _mm256_set1_epi64x(SECONDS_PER_DAY);
+    const __m256i first_threshold = _mm256_set1_epi64x(now - SECONDS_PER_DAY);
+    const __m256i zero = _mm256_setzero_si256();
+    
+    size_t full_words = columns.rows / 64;
+    for (size_t word = 0; word < full_words; ++word) {
+        uint64_t bits = 0;
+        for (size_t lane = 0; lane < 64; lane += 4) {
+            size_t row = word * 64 + lane;
+            __m256i accrued = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(columns.accrued + row)));
+            __m256i threshold = _mm256_sub_epi64(first_threshold, _mm256_mul_epi32(accrued, day));
+            __m256i deadline = _mm256_loadu_si256((const __m256i*)(columns.deadline + row));
+            int32_t rented_bytes;
+            memcpy(&rented_bytes, columns.rented + row, sizeof(rented_bytes));
+            __m256i rented = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(rented_bytes));
+            __m256i rejected = _mm256_or_si256(_mm256_cmpgt_epi64(deadline, threshold), 
+                                               _mm256_cmpeq_epi64(rented, zero));
+            bits |= uint64_t(~_mm256_movemask_pd(_mm256_castsi256_pd(rejected)) & 0xF) << lane;
+        }
+        bitmap[word] = bits;
+    }
+    return full_words;
+}
+#endif
+
+// Rows due a late fee charge at the given time. There is no SSE kernel, the
+// 64-bit compare needs SSE4.2 and buys little over the scalar loop.
+void selectAccruableRentals(const AccrualColumns& columns, time_t now, SelectionBitmap& selection,
+                            FilterKernel kernel = bestFilterKernel()) {
+    selection.assign((columns.rows + 63) / 64, 0);
+    size_t done_words = 0;
+#ifdef ACCRUAL_SIMD
+    if (kernel == FilterKernel::Avx2) {
+        done_words = selectAccruableAvx2(columns, now, selection.data());
+    }
+#else
+    (void)kernel;
+#endif
+    selectAccruableScalar(columns, now, selection.data(), done_words);
+}
+
+AccrualColumns fleetAccrualColumns() {
+    const FleetStore& fleet = vehicle_inventory;
+    return {fleet.return_deadline.data(), fleet.is_rented.data(), fleet.accrued_days.data(), fleet.size()};
+}
+
+//======================= RENTALS TABLE =======================//
+
+enum class RenterRole {
+    Client,
+    Staff
+};
+
+// One open rental. Records live in rental_table and are linked into a
+// per-renter list so both "who has this car" and "what does this user
+// have" are answered without scanning.
+struct Rental {
+    int renter_id;
+    RenterRole renter_role;
+    int vehicle_id;
+    time_t start_time;
+    time_t deadline;
+    int prev_by_renter;
+    int next_by_renter;
+};
+
+vector<Rental> rental_table;
+vector<int> free_rental_slots;
+vector<int> rental_slot_by_vehicle;  // vehicle ID -> rental slot, -1 when available
+
+// Ends of a renter's rental list, kept in the order the vehicles were rented
+struct RenterRentals {
+    int first = -1;
+    int last = -1;
+};
+
+vector<RenterRentals> client_rentals;  // indexed by client ID
+vector<RenterRentals> staff_rentals;   // indexed by staff ID
+
+vector<RenterRentals>& renterRentals(RenterRole role) {
+    return role == RenterRole::Client ? client_rentals : staff_rentals;
+}
+
+// Concurrent renting: a vehicle is reserved by one compare-and-swap on its
+// is_rented flag, so threads racing for a popular car never block each other
+// and the losers simply see AlreadyRented. The winner then updates its own
+// account and rental list under that renter's lock stripe. Adding or removing
+// vehicles and accounts still needs exclusive access to the tables.
+const int RENTER_LOCK_STRIPES = 64;
+mutex renter_locks[RENTER_LOCK_STRIPES];
+mutex rental_slots_lock;  // guards free_rental_slots and the growth of rental_table
+
+int renterStripe(RenterRole role, int renter_id) {
+    return (renter_id * 2 + (role == RenterRole::Staff)) % RENTER_LOCK_STRIPES;
+}
+
+mutex& renterLock(RenterRole role, int renter_id) {
+    return renter_locks[renterStripe(role, renter_id)];
+}
+
+// Reserve an available vehicle for the caller. False if someone else holds it.
+bool claimVehicle(int vehicle_slot) {
+    return vehicle_inventory.claim(vehicle_slot);
+}
+
+// First rental slot held by a renter, -1 if they have nothing rented
+int firstRental(RenterRole role, int renter_id) {
+    const vector<RenterRentals>& lists = renterRentals(role);
+    return renter_id < (int)lists.size() ? lists[renter_id].first : -1;
+}
+
+// Rental slot currently holding a vehicle, -1 if the vehicle is not rented
+int findRentalByVehicle(int vehicle_id) {
+    if (vehicle_id <= 0 || vehicle_id >= (int)rental_slot_by_vehicle.size()) {
+        return -1;
+    }
+    return loadShared(rental_slot_by_vehicle[vehicle_id]);
+}
+
+// Rental slot for a vehicle the given renter holds, -1 otherwise. Called with
+// the renter's lock held, so a match cannot be closed by another thread.
+int findHeldRental(RenterRole role, int renter_id, int vehicle_id) {
+    int slot = findRentalByVehicle(vehicle_id);
+    if (slot == -1) {
+        return -1;
+    }
+    const Rental& rental = rental_table[slot];
+    if (loadShared(rental.renter_id) != renter_id || loadShared(rental.renter_role) != role 
+            || loadShared(rental.vehicle_id) != vehicle_id) {
+        return -1;
+    }
+    return slot;
+}
+
+// One open rental waiting for its deadline to pass
+struct DeadlineEntry {
+    time_t deadline;
+    int rental_slot;
+    int vehicle_id;
+    int renter_id;
+    RenterRole renter_role;
+
+    bool operator>(const DeadlineEntry& other) const {
+        return tie(deadline, rental_slot, vehicle_id, renter_id, renter_role) 
+             > tie(other.deadline, other.rental_slot, other.vehicle_id, other.renter_id, other.renter_role);
+    }
+    bool operator==(const DeadlineEntry& other) const {
+        return !(*this > other) && !(other > *this);
+    }
+};
+
+// Open rentals ordered by deadline, so finding the ones that just became
+// overdue costs O(expired) instead of a scan over every deadline. Each renter
+// lock stripe has its own heap, filled by openRental under that lock, so
+// concurrent renters never share one. Returned rentals are not searched for in
+// the heaps; their entries are dropped when they surface, or in bulk once they
+// outnumber the open rentals of their stripe.
+class OverdueTracker {
+public:
+    // Called once per rental as it becomes overdue, with the renter's lock held
+    using Hook = function<void(const Rental& rental, int rental_slot)>;
+
+    void addHook(Hook hook) { hooks.push_back(move(hook)); }
+
+    // Queue a newly opened rental; the caller holds the renter's lock
+    void track(int rental_slot);
+    // Note that a rental is closing; the caller holds the renter's lock
+    void untrack(int rental_slot);
+    // Move every rental whose deadline has passed into the overdue set and run the hooks.
+    // Returns the number of rentals that became overdue.
+    size_t advance(time_t now);
+    // Rentals currently overdue and still open, oldest deadline first
+    vector<DeadlineEntry> overdueRentals();
+    void clear();
+    // Re-queue every open rental, after the tables were loaded wholesale
+    void rebuild();
+
+private:
+    struct Stripe {
+        vector<DeadlineEntry> pending;  // min-heap on deadline
+        vector<DeadlineEntry> overdue;
+        size_t open_rentals = 0;
+    };
+    Stripe stripes[RENTER_LOCK_STRIPES];
+    vector<Hook> hooks;
+
+    static DeadlineEntry entryFor(int rental_slot);
+    static bool isOpen(const DeadlineEntry& entry);
+};
+
+OverdueTracker overdue_tracker;
+
+DeadlineEntry OverdueTracker::entryFor(int rental_slot) {
+    const Rental& rental = rental_table[rental_slot];
+    return {rental.deadline, rental_slot, rental.vehicle_id, rental.renter_id, rental.renter_role};
+}
+
+// True while the rental an entry was queued for is still open. The entry's
+// renter lock is held, so once the owner matches the rental cannot change.
+bool OverdueTracker::isOpen(const DeadlineEntry& entry) {
+    return findHeldRental(entry.renter_role, entry.renter_id, entry.vehicle_id) == entry.rental_slot 
+        && rental_table[entry.rental_slot].deadline == entry.deadline;
+}
+
+void OverdueTracker::track(int rental_slot) {
+    DeadlineEntry entry = entryFor(rental_slot);
+    Stripe& stripe = stripes[renterStripe(entry.renter_role, entry.renter_id)];
+    stripe.pending.push_back(entry);
+    push_heap(stripe.pending.begin(), stripe.pending.end(), greater<DeadlineEntry>());
+    ++stripe.open_rentals;
+}
+
+void OverdueTracker::untrack(int rental_slot) {
+    const Rental& rental = rental_table[rental_slot];
+    Stripe& stripe = stripes[renterStripe(rental.renter_role, rental.renter_id)];
+    stripe.open_rentals -= stripe.open_rentals > 0;
+    // Once returned rentals dominate a stripe, drop them in one linear pass.
+    // The closing rental is still open here and is dropped by a later pass.
+    auto closed = [](const DeadlineEntry& entry) { return !isOpen(entry); };
+    size_t limit = 2 * stripe.open_rentals + 64;
+    if (stripe.pending.size() > limit) {
+        stripe.pending.erase(remove_if(stripe.pending.begin(), stripe.pending.end(), closed), stripe.pending.end());
+        make_heap(stripe.pending.begin(), stripe.pending.end(), greater<DeadlineEntry>());
+    }
+    if (stripe.overdue.size() > limit) {
+        stripe.overdue.erase(remove_if(stripe.overdue.begin(), stripe.overdue.end(), closed), stripe.overdue.end());
+    }
+}
+
+size_t OverdueTracker::advance(time_t now) {
+    size_t expired = 0;
+    for (int index = 0; index < RENTER_LOCK_STRIPES; ++index) {
+        lock_guard<mutex> guard(renter_locks[index]);
+        Stripe& stripe = stripes[index];
+        while (!stripe.pending.empty() && stripe.pending.front().deadline < now) {
+            pop_heap(stripe.pending.begin(), stripe.pending.end(), greater<DeadlineEntry>());
+            DeadlineEntry entry = stripe.pending.back();
+            stripe.pending.pop_back();
+            // A rental closed and reopened within the same second leaves an identical twin
+            bool duplicate = !stripe.overdue.empty() && stripe.overdue.back() == entry;
+            if (duplicate || !isOpen(entry)) {
+                continue;
+            }
+            stripe.overdue.push_back(entry);
+            ++expired;
+            for (const Hook& hook : hooks) {
+                hook(rental_table[entry.rental_slot], entry.rental_slot);
+            }
+        }
+    }
+    return expired;
+}
+
+vector<DeadlineEntry> OverdueTracker::overdueRentals() {
+    vector<DeadlineEntry> result;
+    for (int index = 0; index < RENTER_LOCK_STRIPES; ++index) {
+        lock_guard<mutex> guard(renter_locks[index]);
+        vector<DeadlineEntry>& overdue = stripes[index].overdue;
+        overdue.erase(remove_if(overdue.begin(), overdue.end(), 
+                                [](const DeadlineEntry& entry) { return !isOpen(entry); }), overdue.end());
+        result.insert(result.end(), overdue.begin(), overdue.end());
+    }
+    sort(result.begin(), result.end(), [](const DeadlineEntry& a, const DeadlineEntry& b) { return b > a; });
+    return result;
+}
+
+void OverdueTracker::clear() {
+    for (Stripe& stripe : stripes) {
+        stripe.pending.clear();
+        stripe.overdue.clear();
+        stripe.open_rentals = 0;
+    }
+}
+
+void OverdueTracker::rebuild() {
+    clear();
+    for (int slot = 0; slot < (int)rental_table.size(); ++slot) {
+        if (findRentalByVehicle(rental_table[slot].vehicle_id) == slot) {
+            track(slot);
+        }
+    }
+}
+
+// Record a new rental and mark the vehicle as rented out until the deadline.
+// Concurrent callers must already hold the vehicle and the renter's lock.
+int openRental(RenterRole role, int renter_id, int vehicle_slot, time_t start_time, time_t deadline) {
+    int vehicle_id = vehicle_inventory.vehicle_id[vehicle_slot];
+    int slot;
+    {
+        lock_guard<mutex> guard(rental_slots_lock);
+        if (free_rental_slots.empty()) {
+            slot = (int)rental_table.size();
+            rental_table.push_back(Rental());
+        } else {
+            slot = free_rental_slots.back();
+            free_rental_slots.pop_back();
+        }
+    }
+    
+    vector<RenterRentals>& lists = renterRentals(role);
+    if (renter_id >= (int)lists.size()) {
+        lists.resize(renter_id + 1);
+    }
+    if (vehicle_id >= (int)rental_slot_by_vehicle.size()) {
+        rental_slot_by_vehicle.resize(vehicle_id + 1, -1);
+    }
+    
+    Rental& rental = rental_table[slot];
+    storeShared(rental.renter_id, renter_id);
+    storeShared(rental.renter_role, role);
+    storeShared(rental.vehicle_id, vehicle_id);
+    rental.start_time = start_time;
+    rental.deadline = deadline;
+    rental.prev_by_renter = lists[renter_id].last;
+    rental.next_by_renter = -1;
+    if (lists[renter_id].last != -1) {
+        rental_table[lists[renter_id].last].next_by_renter = slot;
+    } else {
+        lists[renter_id].first = slot;
+    }
+    lists[renter_id].last = slot;
+    storeShared(rental_slot_by_vehicle[vehicle_id], slot);
+    
+    storeShared(vehicle_inventory.return_deadline[vehicle_slot], deadline);
+    vehicle_inventory.accrued_days[vehicle_slot] = 0;
+    vehicle_inventory.touch(vehicle_slot);
+    vehicle_inventory.setRented(vehicle_slot, true);
+    overdue_tracker.track(slot);
+    return slot;
+}
+
+// Drop a rental from both indexes and make its vehicle available again.
+// The vehicle is released last, once nothing else refers to the rental.
+void closeRental(int slot) {
+    Rental& rental = rental_table[slot];
+    int vehicle_id = rental.vehicle_id;
+    overdue_tracker.untrack(slot);
+    RenterRentals& list = renterRentals(rental.renter_role)[rental.renter_id];
+    if (rental.prev_by_renter != -1) {
+        rental_table[rental.prev_by_renter].next_by_renter = rental.next_by_renter;
+    } else {
+        list.first = rental.next_by_renter;
+    }
+    if (rental.next_by_renter != -1) {
+        rental_table[rental.next_by_renter].prev_by_renter = rental.prev_by_renter;
+    } else {
+        list.last = rental.prev_by_renter;
+    }
+    storeShared(rental_slot_by_vehicle[vehicle_id], -1);
+    {
+        lock_guard<mutex> guard(rental_slots_lock);
+        free_rental_slots.push_back(slot);
+    }
+    
+    int vehicle_slot = findVehicleSlot(vehicle_id);
+    if (vehicle_slot != -1) {
+        storeShared(vehicle_inventory.return_deadline[vehicle_slot], time_t(0));
+        vehicle_inventory.accrued_days[vehicle_slot] = 0;
+        vehicle_inventory.touch(vehicle_slot);
+        vehicle_inventory.setRented(vehicle_slot, false);
+    }
+}
+
+// Versioned side of a rental an admin override ended (defined with the versioned tables)
+void versionRentalEnded(RenterRole role, int renter_id);
+
+// Admin override of a vehicle's rental flag. Marking a rented vehicle
+// available ends its rental without a penalty.
+void setVehicleRentedStatus(int vehicle_slot, bool rented) {
+    vehicle_inventory.setRented(vehicle_slot, rented);
+    vehicle_inventory.touch(vehicle_slot);
+    int rental_slot = findRentalByVehicle(vehicle_inventory.vehicle_id[vehicle_slot]);
+    if (!rented && rental_slot != -1) {
+        RenterRole role = rental_table[rental_slot].renter_role;
+        int renter_id = rental_table[rental_slot].renter_id;
+        closeRental(rental_slot);
+        versionRentalEnded(role, renter_id);
+    }
+    versionVehicleEdit(vehicle_slot);
+}
+
+// Rented-vehicle table shown in the client and staff portals
+void showRenterVehicles(RenterRole role, int renter_id) {
+    if (firstRental(role, renter_id) == -1) {
+        cout << "No vehicles currently rented\n\n\n";
+        return;
+    }
+    
+    OutputBuffer out;
+    out.padded("ID", 3).padded("Brand", 15).padded("Model", 15).padded("Rent", 7).padded("Price", 12)
+       .padded("Seats", 6).padded("Color", 10).padded("Due Date", 10).padded("Condition", 10)
+       .padded("Return By", 15).text("\n");
+    
+    time_t current_time = time(0);
+    const FleetStore& fleet = vehicle_inventory;
+    for (int slot = firstRental(role, renter_id); slot != -1; slot = rental_table[slot].next_by_renter) {
+        int vehicle_slot = findVehicleSlot(rental_table[slot].vehicle_id);
+        out.number(fleet.vehicle_id[vehicle_slot], 3).padded(fleet.brand(vehicle_slot), 15)
+           .padded(fleet.model(vehicle_slot), 15).number(fleet.daily_rent[vehicle_slot], 7)
+           .number(fleet.market_price[vehicle_slot], 12).number(fleet.seating_capacity[vehicle_slot], 6)
+           .padded(fleet.color(vehicle_slot), 10).number(rental_table[slot].deadline, 10)
+           .number(fleet.vehicle_condition[vehicle_slot], 10);
+        showDueDate(out, rental_table[slot].deadline, current_time);
+        out.endRow();
+    }
+    out.text("\n\n\n");
+}
+
+//======================= RESERVATIONS =======================//
+
+// Advance bookings. Every vehicle has a calendar of reserved periods
+// [start, end), indexed by vehicle ID. Bookings on one vehicle never overlap,
+// and disjoint intervals sorted by start are sorted by end as well, so a plain
+// sorted array answers the interval-tree question: the only booking that can
+// overlap [from, to) is the first one ending after from, found by binary
+// search. Each calendar is guarded by a lock stripe, so bookings, pickups and
+// availability queries on different vehicles run in parallel.
+struct Reservation {
+    int reservation_id;
+    int vehicle_id;
+    int renter_id;
+    RenterRole renter_role;
+    time_t start;
+    time_t end;
+};
+
+const time_t RENTAL_PERIOD = SECONDS_PER_DAY * 7;  // length of a walk-in rental
+const int MAX_RESERVATION_DAYS = 3650;  // longest period one booking may span
+
+vector<vector<Reservation>> vehicle_calendars;  // vehicle ID -> bookings sorted by start
+vector<int> reservation_vehicle;                // reservation ID -> vehicle ID, 0 once released
+int reservation_counter = 0;
+mutex reservation_ids_lock;  // guards reservation_counter and reservation_vehicle
+
+const int CALENDAR_LOCK_STRIPES = 64;
+mutex calendar_locks[CALENDAR_LOCK_STRIPES];
+
+mutex& calendarLock(int vehicle_id) {
+    return calendar_locks[vehicle_id % CALENDAR_LOCK_STRIPES];
+}
+
+// Booking list of a vehicle; grows the table, so concurrent callers rely on prepareConcurrentRentals()
+vector<Reservation>& vehicleCalendar(int vehicle_id) {
+    if (vehicle_id >= (int)vehicle_calendars.size()) {
+        vehicle_calendars.resize(vehicle_id + 1);
+    }
+    return vehicle_calendars[vehicle_id];
+}
+
+// First booking ending after the given time; the only candidate for an overlap starting there
+vector<Reservation>::iterator firstEndingAfter(vector<Reservation>& calendar, time_t time) {
+    return upper_bound(calendar.begin(), calendar.end(), time, 
+                       [](time_t value, const Reservation& booking) { return value < booking.end; });
+}
+
+// End of a vehicle's current rental. An overdue vehicle may come back at any moment.
+time_t rentedUntil(int vehicle_slot, time_t now) {
+    if (!loadShared(vehicle_inventory.is_rented[vehicle_slot])) {
+        return 0;
+    }
+    return max(loadShared(vehicle_inventory.return_deadline[vehicle_slot]), now);
+}
+
+// Whether [from, to) is clear of the current rental and every booking. Caller holds the calendar lock.
+bool isVehicleFree(int vehicle_slot, time_t from, time_t to, time_t now) {
+    if (rentedUntil(vehicle_slot, now) > from) {
+        return false;
+    }
+    int vehicle_id = vehicle_inventory.vehicle_id[vehicle_slot];
+    if (vehicle_id >= (int)vehicle_calendars.size()) {
+        return true;
+    }
+    vector<Reservation>& calendar = vehicle_calendars[vehicle_id];
+    auto next = firstEndingAfter(calendar, from);
+    return next == calendar.end() || next->start >= to;
+}
+
+void forgetReservationId(int reservation_id) {
+    lock_guard<mutex> guard(reservation_ids_lock);
+    reservation_vehicle[reservation_id] = 0;
+}
+
+// Cancel every booking on a vehicle that is leaving the fleet; the removal record covers them in the log
+void dropReservations(int vehicle_id) {
+    if (vehicle_id >= (int)vehicle_calendars.size()) {
+        return;
+    }
+    for (const Reservation& booking : vehicle_calendars[vehicle_id]) {
+        forgetReservationId(booking.reservation_id);
+    }
+    vector<Reservation>().swap(vehicle_calendars[vehicle_id]);
+}
+
+// Put a booking into its vehicle's calendar and the ID table, e.g. from the log.
+// Caller holds the calendar lock.
+void insertReservation(const Reservation& reservation) {
+    vector<Reservation>& calendar = vehicleCalendar(reservation.vehicle_id);
+    auto position = lower_bound(calendar.begin(), calendar.end(), reservation.start, 
+                                [](const Reservation& booking, time_t start) { return booking.start < start; });
+    calendar.insert(position, reservation);
+    lock_guard<mutex> guard(reservation_ids_lock);
+    if (reservation.reservation_id >= (int)reservation_vehicle.size()) {
+        reservation_vehicle.resize(reservation.reservation_id + 1, 0);
+    }
+    reservation_vehicle[reservation.reservation_id] = reservation.vehicle_id;
+    reservation_counter = max(reservation_counter, reservation.reservation_id);
+}
+
+// Book [start, end) on a vehicle for a renter. Bookings that ended unused are
+// dropped on the way. Caller holds the calendar lock; reservation_id is set on success.
+OperationStatus bookVehicle(int vehicle_slot, Reservation& reservation, time_t now) {
+    if (rentedUntil(vehicle_slot, now) > reservation.start) {
+        return OperationStatus::AlreadyRented;
+    }
+    vector<Reservation>& calendar = vehicleCalendar(reservation.vehicle_id);
+    auto expired = firstEndingAfter(calendar, now);
+    for (auto booking = calendar.begin(); booking != expired; ++booking) {
+        forgetReservationId(booking->reservation_id);
+    }
+    calendar.erase(calendar.begin(), expired);
+    if (!isVehicleFree(vehicle_slot, reservation.start, reservation.end, now)) {
+        return OperationStatus::Reserved;
+    }
+    {
+        lock_guard<mutex> guard(reservation_ids_lock);
+        reservation.reservation_id = ++reservation_counter;
+    }
+    insertReservation(reservation);
+    return OperationStatus::Success;
+}
+
+// Vehicle a reservation is for, 0 if it was cancelled, picked up or never existed
+int reservationVehicle(int reservation_id) {
+    lock_guard<mutex> guard(reservation_ids_lock);
+    if (reservation_id <= 0 || reservation_id >= (int)reservation_vehicle.size()) {
+        return 0;
+    }
+    return reservation_vehicle[reservation_id];
+}
+
+// Remove a booking. With an owner given, only that renter's booking matches.
+// Caller holds the calendar lock of the booking's vehicle.
+bool releaseReservation(int vehicle_id, int reservation_id, const RenterRole* role = nullptr, int renter_id = 0) {
+    if (vehicle_id <= 0 || vehicle_id >= (int)vehicle_calendars.size()) {
+        return false;
+    }
+    vector<Reservation>& calendar = vehicle_calendars[vehicle_id];
+    auto booking = find_if(calendar.begin(), calendar.end(), 
+                           [&](const Reservation& entry) { return entry.reservation_id == reservation_id; });
+    if (booking == calendar.end() 
+            || (role != nullptr && (booking->renter_role != *role || booking->renter_id != renter_id))) {
+        return false;
+    }
+    calendar.erase(booking);
+    forgetReservationId(reservation_id);
+    return true;
+}
+
+// Rental period for a vehicle picked up now. A booking of the renter's that
+// covers now is taken out of the calendar and sets the deadline
+// (reservation_id reports it); a booking of anyone else's inside the walk-in
+// period refuses the rental.
+bool takeRentalPeriod(vector<Reservation>& calendar, RenterRole role, int renter_id, time_t now, time_t& deadline, 
+                      int& reservation_id) {
+    reservation_id = 0;
+    deadline = now + RENTAL_PERIOD;
+    auto next = firstEndingAfter(calendar, now);
+    if (next == calendar.end() || next->start >= deadline) {
+        return true;
+    }
+    if (next->start > now || next->renter_role != role || next->renter_id != renter_id) {
+        return false;
+    }
+    deadline = next->end;
+    reservation_id = next->reservation_id;
+    calendar.erase(next);
+    return true;
+}
+
+// takeRentalPeriod on a vehicle's calendar; a booking picked up is forgotten.
+// Caller holds the calendar lock.
+bool claimRentalPeriod(RenterRole role, int renter_id, int vehicle_id, time_t now, time_t& deadline, 
+                       int& reservation_id) {
+    if (vehicle_id >= (int)vehicle_calendars.size()) {
+        reservation_id = 0;
+        deadline = now + RENTAL_PERIOD;
+        return true;
+    }
+    if (!takeRentalPeriod(vehicle_calendars[vehicle_id], role, renter_id, now, deadline, reservation_id)) {
+        return false;
+    }
+    if (reservation_id != 0) {
+        forgetReservationId(reservation_id);
+    }
+    return true;
+}
+
+// Vehicles matching the filter that are free for all of [from, to). The
+// filter narrows the fleet with the column kernels first, then each survivor
+// costs one binary search in its calendar; words are split across threads.
+void selectFreeVehicles(const FleetFilter& filter, time_t from, time_t to, SelectionBitmap& selection, 
+                        unsigned workers = workerCount()) {
+    FleetFilter period_filter = filter;
+    period_filter.available_only = false;  // the current rental is checked against the period instead
+    filterFleet(period_filter, selection);
+    time_t now = time(0);
+    parallelFor(selection.size(), workers, [&](size_t begin, size_t end) {
+        for (size_t word = begin; word < end; ++word) {
+            uint64_t bits = selection[word];
+            for (uint64_t remaining = bits; remaining != 0; remaining &= remaining - 1) {
+                size_t slot = word * 64 + __builtin_ctzll(remaining);
+                lock_guard<mutex> guard(calendarLock(vehicle_inventory.vehicle_id[slot]));
+                if (!isVehicleFree((int)slot, from, to, now)) {
+                    bits &= ~(uint64_t(1) << (slot % 64));
+                }
+            }
+            selection[word] = bits;
+        }
+    });
+}
+
+// DD/MM/YYYY at local midnight, the format due dates are shown in
+bool parseDate(const string& text, time_t& date) {
+    int day, month, year;
+    char extra;
+    if (sscanf(text.c_str(), "%d/%d/%d%c", &day, &month, &year, &extra) != 3) {
+        return false;
+    }
+    tm parts = {};
+    parts.tm_mday = day;
+    parts.tm_mon = month - 1;
+    parts.tm_year = year - 1900;
+    parts.tm_isdst = -1;
+    date = mktime(&parts);
+    // mktime rolls 31/02 over into March; only accept dates that exist
+    return date != -1 && parts.tm_mday == day && parts.tm_mon == month - 1 && parts.tm_year == year - 1900;
+}
+
+//======================= VERSIONED TABLES =======================//
+
+// Point-in-time copies of the state rent, return and pay change, so admin
+// listings and reports see one consistent moment without taking any lock a
+// renter needs. Rows live in copy-on-write pages. Opening a snapshot starts a
+// new epoch; the first writer to touch a page in that epoch copies it and
+// links the old page behind the copy, and a snapshot reads, page by page, the
+// newest version written before its epoch. Replaced pages are freed once no
+// open snapshot can reach them. Only the state listings and reports show is
+// versioned; names and prices change under exclusive access and are read live.
+// Renter operations and admin edits write the rows they change as they go.
+// Bulk changes that bypass them (loads, replay, compaction moving fleet slots)
+// mark the tables stale instead, and ensureVersionedTables() resyncs them.
+class EpochDomain {
+public:
+    static constexpr uint64_t IDLE = numeric_limits<uint64_t>::max();
+
+    // The epoch one writer thread is writing in, IDLE between operations
+    struct alignas(64) WriterSlot {
+        atomic<uint64_t> epoch{IDLE};
+    };
+
+    atomic<uint64_t> pages_copied{0};
+    atomic<uint64_t> pages_freed{0};
+
+    ~EpochDomain() {
+        for (const Retired& page : retired) {
+            page.destroy(page.page);
+        }
+    }
+
+    WriterSlot* acquireSlot() {
+        lock_guard<mutex> guard(slots_lock);
+        if (!free_slots.empty()) {
+            WriterSlot* slot = free_slots.back();
+            free_slots.pop_back();
+            return slot;
+        }
+        slots.push_back(make_unique<WriterSlot>());
+        return slots.back().get();
+    }
+
+    void releaseSlot(WriterSlot* slot) {
+        lock_guard<mutex> guard(slots_lock);
+        free_slots.push_back(slot);
+    }
+
+    // Announce a write and return its epoch. The announcement is re-checked so a
+    // snapshot opened meanwhile either sees this writer or is seen by it.
+    uint64_t enter(WriterSlot& slot) {
+        uint64_t epoch = current.load();
+        while (true) {
+            slot.epoch.store(epoch);
+            uint64_t latest = current.load();
+            if (latest == epoch) {
+                return epoch;
+            }
+            epoch = latest;
+        }
+    }
+
+    void exit(WriterSlot& slot) { slot.epoch.store(IDLE, memory_order_release); }
+
+    // A page may only be copied once every writer of an older epoch has finished with it
+    void awaitGrace(uint64_t epoch) {
+        while (settled.load(memory_order_acquire) < epoch) {
+            this_thread::yield();
+        }
+    }
+
+    // Start a new epoch and wait out the writers still in older ones; the
+    // snapshot then sees every write made before the epoch and none after
+    uint64_t openSnapshot() {
+        lock_guard<mutex> guard(snapshot_lock);
+        uint64_t epoch = current.load(memory_order_relaxed) + 1;
+        open_snapshots.push_back(epoch);
+        current.store(epoch);
+        {
+            lock_guard<mutex> slots_guard(slots_lock);
+            for (const auto& slot : slots) {
+                while (slot->epoch.load(memory_order_acquire) < epoch) {
+                    this_thread::yield();
+                }
+            }
+        }
+        settled.store(epoch, memory_order_release);
+        reclaim();
+        return epoch;
+    }
+
+    void closeSnapshot(uint64_t epoch) {
+        lock_guard<mutex> guard(snapshot_lock);
+        open_snapshots.erase(find(open_snapshots.begin(), open_snapshots.end(), epoch));
+        reclaim();
+    }
+
+    // Free what no open snapshot can reach any more
+    void collect() {
+        lock_guard<mutex> guard(snapshot_lock);
+        reclaim();
+    }
+
+    // Hand over a page replaced by a copy made in the given epoch
+    void retire(void* page, uint64_t replaced_in, void (*destroy)(void*)) {
+        lock_guard<mutex> guard(retired_lock);
+        retired.push_back({replaced_in, page, destroy});
+        pages_copied.fetch_add(1, memory_order_relaxed);
+    }
+
+private:
+    struct Retired {
+        uint64_t replaced_in;
+        void* page;
+        void (*destroy)(void*);
+    };
+
+    atomic<uint64_t> current{1};
+    atomic<uint64_t> settled{1};
+    mutex snapshot_lock;  // serializes opening and closing snapshots
+    vector<uint64_t> open_snapshots;
+    mutex slots_lock;
+    vector<unique_ptr<WriterSlot>> slots;
+    vector<WriterSlot*> free_slots;
+    mutex retired_lock;
+    vector<Retired> retired;
+
+    // A snapshot at epoch E reads a page replaced in epoch F only if E <= F.
+    // Called with snapshot_lock held, so no snapshot opens meanwhile.
+    void reclaim() {
+        uint64_t oldest = open_snapshots.empty() ? IDLE : *min_element(open_snapshots.begin(), open_snapshots.end());
+        vector<Retired> freeing;
+        {
+            lock_guard<mutex> guard(retired_lock);
+            auto unreachable = partition(retired.begin(), retired.end(), 
+                                         [oldest](const Retired& page) { return page.replaced_in >= oldest; });
+            freeing.assign(unreachable, retired.end());
+            retired.erase(unreachable, retired.end());
+        }
+        for (const Retired& page : freeing) {
+            page.destroy(page.page);
+        }
+        pages_freed.fetch_add(freeing.size(), memory_order_relaxed);
+    }
+};
+
+EpochDomain table_epochs;
+
+// One table of rows versioned by table_epochs. A page is written in place by
+// writers of the epoch that made it and copied by the first writer of a later
+// one. The newest page's epoch is kept beside the pointer, so a writer never
+// touches a page another writer may just have replaced.
+template <typename Row>
+class VersionedRows {
+public:
+    static const size_t PAGE_ROWS = 1024;
+
+    ~VersionedRows() {
+        for (size_t page = 0; page < page_count; ++page) {
+            delete pages[page].newest.load(memory_order_relaxed);
+        }
+    }
+
+    size_t size() const { return rows; }
+
+    // Hold count rows, new ones zeroed. Needs exclusive access.
+    void resize(size_t count, uint64_t epoch) {
+        size_t needed = (count + PAGE_ROWS - 1) / PAGE_ROWS;
+        if (needed > page_count) {
+            unique_ptr<PageEntry[]> grown(new PageEntry[needed]);
+            for (size_t page = 0; page < needed; ++page) {
+                bool kept = page < page_count;
+                grown[page].newest.store(kept ? pages[page].newest.load(memory_order_relaxed) 
+                                              : new Page{epoch, nullptr, {}}, memory_order_relaxed);
+                grown[page].epoch.store(kept ? pages[page].epoch.load(memory_order_relaxed) : epoch, 
+                                        memory_order_relaxed);
+            }
+            pages.swap(grown);
+            page_count = needed;
+        }
+        rows = count;
+    }
+
+    // Row to change, for a writer inside table_epochs.enter()/exit() at the given epoch
+    Row& write(size_t index, uint64_t epoch) {
+        PageEntry& entry = pages[index / PAGE_ROWS];
+        if (entry.epoch.load(memory_order_acquire) < epoch) {
+            return copyPage(entry, epoch)->rows[index % PAGE_ROWS];
+        }
+        return entry.newest.load(memory_order_relaxed)->rows[index % PAGE_ROWS];
+    }
+
+    // Row as a snapshot opened at the given epoch sees it; EpochDomain::IDLE reads the newest version
+    const Row& read(size_t index, uint64_t epoch) const {
+        const Page* page = pages[index / PAGE_ROWS].newest.load(memory_order_acquire);
+        while (page->epoch >= epoch) {
+            page = page->older;
+        }
+        return page->rows[index % PAGE_ROWS];
+    }
+
+private:
+    struct Page {
+        uint64_t epoch;  // the epoch whose writers made and may change this version
+        Page* older;
+        Row rows[PAGE_ROWS];
+    };
+
+    struct PageEntry {
+        atomic<Page*> newest{nullptr};
+        atomic<uint64_t> epoch{0};  // newest->epoch, published after newest
+    };
+
+    unique_ptr<PageEntry[]> pages;
+    size_t page_count = 0;
+    size_t rows = 0;
+    mutex copy_lock;  // one copy per page and epoch; copies are rare, so one lock serves the table
+
+    Page* copyPage(PageEntry& entry, uint64_t epoch) {
+        // Wait before locking: a writer still finishing in an older epoch may need the lock
+        table_epochs.awaitGrace(epoch);
+        lock_guard<mutex> guard(copy_lock);
+        Page* page = entry.newest.load(memory_order_relaxed);
+        if (page->epoch < epoch) {
+            Page* copy = new Page(*page);
+            copy->epoch = epoch;
+            copy->older = page;
+            entry.newest.store(copy, memory_order_release);
+            entry.epoch.store(epoch, memory_order_release);
+            table_epochs.retire(page, epoch, [](void* old) { delete static_cast<Page*>(old); });
+            page = copy;
+        }
+        return page;
+    }
+};
+
+// Versioned state of one fleet slot
+struct VehicleVersion {
+    int vehicle_id;
+    bool rented;
+    RenterRole holder_role;
+    int holder_id;             // 0 when nobody holds the vehicle
+    uint32_t holder_sequence;  // position in the holder's rentals, in the order they were opened
+    time_t deadline;
+    int64_t revenue;
+
+    bool operator==(const VehicleVersion& other) const {
+        return tie(vehicle_id, rented, holder_role, holder_id, holder_sequence, deadline, revenue) 
+            == tie(other.vehicle_id, other.rented, other.holder_role, other.holder_id, other.holder_sequence, 
+                   other.deadline, other.revenue);
+    }
+};
+
+// Versioned state of one account, by user ID
+struct AccountVersion {
+    int dues;
+    int vehicles_held;
+    uint32_t rentals_opened;
+    double rating;
+
+    bool operator==(const AccountVersion& other) const {
+        return tie(dues, vehicles_held, rentals_opened, rating) 
+            == tie(other.dues, other.vehicles_held, other.rentals_opened, other.rating);
+    }
+};
+
+VersionedRows<VehicleVersion> fleet_versions;          // indexed by fleet slot
+VersionedRows<AccountVersion> client_versions;         // indexed by client ID
+VersionedRows<AccountVersion> staff_versions;          // indexed by staff ID
+
+VersionedRows<AccountVersion>& accountVersions(RenterRole role) {
+    return role == RenterRole::Client ? client_versions : staff_versions;
+}
+
+// Hands the thread's writer slot back when the thread exits
+struct WriterSlotOwner {
+    EpochDomain::WriterSlot* slot = nullptr;
+    ~WriterSlotOwner() {
+        if (slot != nullptr) {
+            table_epochs.releaseSlot(slot);
+        }
+    }
+};
+
+thread_local WriterSlotOwner local_writer_slot;
+
+// Scope of one operation's versioned writes; every row it changes lands in one
+// epoch, so a snapshot sees all of the operation or none of it. Taken after
+// the operation's locks and held without acquiring others.
+class VersionWriter {
+public:
+    VersionWriter() : slot(localSlot()), epoch(table_epochs.enter(slot)) {}
+    ~VersionWriter() { table_epochs.exit(slot); }
+    VersionWriter(const VersionWriter&) = delete;
+    VersionWriter& operator=(const VersionWriter&) = delete;
+
+    uint64_t writeEpoch() const { return epoch; }
+
+    // Null when the row is newer than the last sync; that only happens while
+    // the tables are stale, and the next sync writes it
+    VehicleVersion* vehicle(size_t slot_index) {
+        return slot_index < fleet_versions.size() ? &fleet_versions.write(slot_index, epoch) : nullptr;
+    }
+
+    AccountVersion* account(RenterRole role, int user_id) {
+        VersionedRows<AccountVersion>& table = accountVersions(role);
+        return size_t(user_id) < table.size() ? &table.write(user_id, epoch) : nullptr;
+    }
+
+private:
+    EpochDomain::WriterSlot& slot;
+    uint64_t epoch;
+
+    static EpochDomain::WriterSlot& localSlot() {
+        if (local_writer_slot.slot == nullptr) {
+            local_writer_slot.slot = table_epochs.acquireSlot();
+        }
+        return *local_writer_slot.slot;
+    }
+};
+
+// Versioned side of a rent: the renter's new balance and the vehicle they now hold
+void versionRentalOpened(RenterRole role, int renter_id, int dues, int vehicle_slot, time_t deadline) {
+    VersionWriter versions;
+    uint32_t sequence = 0;
+    if (AccountVersion* account = versions.account(role, renter_id)) {
+        account->dues = dues;
+        ++account->vehicles_held;
+        sequence = ++account->rentals_opened;
+    }
+    if (VehicleVersion* vehicle = versions.vehicle(vehicle_slot)) {
+        *vehicle = {vehicle_inventory.vehicle_id[vehicle_slot], true, role, renter_id, sequence, deadline, 
+                    loadShared(vehicle_inventory.revenue[vehicle_slot])};
+    }
+}
+
+// Versioned side of a return; written while the renter still holds the vehicle
+void versionRentalClosed(RenterRole role, int renter_id, int dues, double rating, int vehicle_slot) {
+    VersionWriter versions;
+    if (AccountVersion* account = versions.account(role, renter_id)) {
+        account->dues = dues;
+        account->rating = rating;
+        --account->vehicles_held;
+    }
+    if (vehicle_slot == -1) {
+        return;
+    }
+    if (VehicleVersion* vehicle = versions.vehicle(vehicle_slot)) {
+        *vehicle = {vehicle_inventory.vehicle_id[vehicle_slot], false, RenterRole::Client, 0, 0, 0, 
+                    loadShared(vehicle_inventory.revenue[vehicle_slot])};
+    }
+}
+
+void versionPayment(RenterRole role, int renter_id, int dues) {
+    VersionWriter versions;
+    if (AccountVersion* account = versions.account(role, renter_id)) {
+        account->dues = dues;
+    }
+}
+
+// Versioned side of a late fee: the renter's balance and rating, and the vehicle's revenue
+void versionLateFee(RenterRole role, int renter_id, int dues, double rating, int vehicle_slot) {
+    VersionWriter versions;
+    if (AccountVersion* account = versions.account(role, renter_id)) {
+        account->dues = dues;
+        account->rating = rating;
+    }
+    if (VehicleVersion* vehicle = versions.vehicle(vehicle_slot)) {
+        vehicle->revenue = loadShared(vehicle_inventory.revenue[vehicle_slot]);
+    }
+}
+
+bool versioned_tables_stale = true;  // set until the first sync, and by changes that skip the row writers
+
+void markVersionedTablesStale() {
+    versioned_tables_stale = true;
+}
+
+// The admin edits below run with exclusive access, so they may grow the
+// tables. While the tables are stale they write nothing; the resync will.
+
+// Versioned side of an added, removed or overridden fleet slot
+void versionVehicleEdit(size_t slot) {
+    if (versioned_tables_stale) {
+        return;
+    }
+    VersionWriter versions;
+    const FleetStore& fleet = vehicle_inventory;
+    if (slot >= fleet_versions.size()) {
+        fleet_versions.resize(fleet.size(), versions.writeEpoch());
+    }
+    VehicleVersion& row = fleet_versions.write(slot, versions.writeEpoch());
+    row.vehicle_id = fleet.vehicle_id[slot];
+    row.rented = fleet.is_rented[slot] != 0;
+    row.deadline = fleet.return_deadline[slot];
+    row.revenue = fleet.revenue[slot];
+    if (findRentalByVehicle(row.vehicle_id) == -1) {
+        row.holder_role = RenterRole::Client;
+        row.holder_id = 0;
+        row.holder_sequence = 0;
+    }
+}
+
+void versionRentalEnded(RenterRole role, int renter_id) {
+    if (versioned_tables_stale) {
+        return;
+    }
+    VersionWriter versions;
+    if (AccountVersion* account = versions.account(role, renter_id)) {
+        --account->vehicles_held;
+    }
+}
+
+// Versioned side of an account being added or given new dues or a new rating
+void versionAccountEdit(RenterRole role, int user_id, int dues, double rating) {
+    if (versioned_tables_stale) {
+        return;
+    }
+    VersionWriter versions;
+    VersionedRows<AccountVersion>& table = accountVersions(role);
+    if (size_t(user_id) >= table.size()) {
+        table.resize(user_id + 1, versions.writeEpoch());
+    }
+    AccountVersion& row = table.write(user_id, versions.writeEpoch());
+    row.dues = dues;
+    row.rating = rating;
+}
+
+void versionAccountRemoved(RenterRole role, int user_id) {
+    if (versioned_tables_stale) {
+        return;
+    }
+    VersionWriter versions;
+    if (AccountVersion* account = versions.account(role, user_id)) {
+        *account = AccountVersion{};
+    }
+}
+
+// A vehicle held by a renter, as a snapshot saw it
+struct HeldVehicle {
+    int renter_id;
+    uint32_t sequence;
+    size_t slot;
+
+    bool operator<(const HeldVehicle& other) const {
+        return tie(renter_id, sequence) < tie(other.renter_id, other.sequence);
+    }
+};
+
+// Consistent read-only view of the versioned tables, held open for as long as
+// the reader needs it. Rows beyond the sizes it was opened with are not part of it.
+class TableSnapshot {
+public:
+    TableSnapshot() : epoch(table_epochs.openSnapshot()), vehicle_rows(fleet_versions.size()), 
+                      client_rows(client_versions.size()), staff_rows(staff_versions.size()) {}
+    ~TableSnapshot() { table_epochs.closeSnapshot(epoch); }
+    TableSnapshot(const TableSnapshot&) = delete;
+    TableSnapshot& operator=(const TableSnapshot&) = delete;
+
+    size_t vehicleCount() const { return vehicle_rows; }
+
+    const VehicleVersion& vehicle(size_t slot) const { return fleet_versions.read(slot, epoch); }
+
+    // Accounts outside the snapshot read as empty
+    AccountVersion account(RenterRole role, int user_id) const {
+        size_t rows = role == RenterRole::Client ? client_rows : staff_rows;
+        if (user_id <= 0 || size_t(user_id) >= rows) {
+            return AccountVersion{};
+        }
+        return accountVersions(role).read(user_id, epoch);
+    }
+
+    // Every vehicle held by the given role, grouped by renter in rental order
+    vector<HeldVehicle> heldVehicles(RenterRole role) const {
+        vector<HeldVehicle> held;
+        for (size_t slot = 0; slot < vehicle_rows; ++slot) {
+            const VehicleVersion& row = vehicle(slot);
+            if (row.holder_id != 0 && row.holder_role == role) {
+                held.push_back({row.holder_id, row.holder_sequence, slot});
+            }
+        }
+        sort(held.begin(), held.end());
+        return held;
+    }
+
+private:
+    uint64_t epoch;
+    size_t vehicle_rows;
+    size_t client_rows;
+    size_t staff_rows;
+};
+
+// Print the brand and model of every vehicle a renter holds in a snapshot's
+// heldVehicles() list, for admin listings
+void listHeldVehicles(OutputBuffer& out, const vector<HeldVehicle>& held, int renter_id) {
+    for (auto vehicle = lower_bound(held.begin(), held.end(), HeldVehicle{renter_id, 0, 0}); 
+            vehicle != held.end() && vehicle->renter_id == renter_id; ++vehicle) {
+        out.text("\t").text(vehicle_inventory.brand(vehicle->slot)).text(" ")
+           .text(vehicle_inventory.model(vehicle->slot)).text("\n");
+    }
+}
+
+// Rebuild the versioned tables from the live ones, or only when they are
+// stale (defined after the user tables). Both need exclusive access.
+void syncVersionedTables();
+void ensureVersionedTables();
+
+//======================= EVENT STREAM =======================//
+
+// Every mutation is also published as a small fixed-size event, so auditing,
+// analytics or notifications can follow changes from their own threads
+// instead of polling the tables. Events go out as records are appended to the
+// transaction log, before commit makes them durable, so after a crash a
+// consumer may have seen events that recovery does not restore. Renters push into one shared MPSC
+// ring and never wait: when it is full the event is dropped and counted. A
+// dispatcher thread numbers the events and copies them into one SPSC ring per
+// subscriber. When a subscriber falls behind and its ring fills, its policy
+// decides: Drop skips the event for that subscriber and counts it, Wait holds
+// the dispatcher until the consumer catches up, and the shared ring absorbs
+// the slack meanwhile.
+
+enum class EventType : uint8_t {
+    Rented = 1,
+    Returned,
+    LateFee,
+    Payment,
+    Reserved,
+    ReservationReleased,
+    VehicleAdded,
+    VehicleRemoved,
+    VehicleChanged,
+    VehicleStatusSet,
+    AccountAdded,
+    AccountRemoved,
+    AccountChanged
+};
+
+const char* eventTypeName(EventType type) {
+    switch (type) {
+        case EventType::Rented: return "rented";
+        case EventType::Returned: return "returned";
+        case EventType::LateFee: return "late_fee";
+        case EventType::Payment: return "payment";
+        case EventType::Reserved: return "reserved";
+        case EventType::ReservationReleased: return "reservation_released";
+        case EventType::VehicleAdded: return "vehicle_added";
+        case EventType::VehicleRemoved: return "vehicle_removed";
+        case EventType::VehicleChanged: return "vehicle_changed";
+        case EventType::VehicleStatusSet: return "vehicle_status_set";
+        case EventType::AccountAdded: return "account_added";
+        case EventType::AccountRemoved: return "account_removed";
+        case EventType::AccountChanged: return "account_changed";
+    }
+    return "unknown";
+}
+
+struct RentalEvent {
+    uint64_t sequence = 0;  // dispatch order from 1; a subscriber that dropped events sees gaps
+    int64_t time = 0;
+    int64_t amount = 0;     // charge, penalty, fee, payment, reservation ID or new field value
+    int32_t account_id = 0;
+    int32_t vehicle_id = 0;
+    int32_t field = 0;      // VehicleField or AccountField of a change event
+    EventType type = EventType::Rented;
+    RenterRole role = RenterRole::Client;
+};
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Bounded ring for one producer thread and one consumer thread. Each side
+// keeps a cached copy of the other's index and only reloads it when the ring
+// looks full (or empty), so the shared cache lines rarely move.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) : slots(roundUpToPowerOfTwo(max<size_t>(capacity, 2))), mask(slots.size() - 1) {}
+
+    bool tryPush(const T& value) {
+        size_t tail = producer.index.load(memory_order_relaxed);
+        if (tail - producer.cached >= slots.size()) {
+            producer.cached = consumer.index.load(memory_order_acquire);
+            if (tail - producer.cached >= slots.size()) {
+                return false;
+            }
+        }
+        slots[tail & mask] = value;
+        producer.index.store(tail + 1, memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        size_t head = consumer.index.load(memory_order_relaxed);
+        if (head == consumer.cached) {
+            consumer.cached = producer.index.load(memory_order_acquire);
+            if (head == consumer.cached) {
+                return false;
+            }
+        }
+        value = slots[head & mask];
+        consumer.index.store(head + 1, memory_order_release);
+        return true;
+    }
+
+    size_t size() const {
+        size_t head = consumer.index.load(memory_order_acquire);
+        return producer.index.load(memory_order_acquire) - head;
+    }
+
+private:
+    struct alignas(64) Side {
+        atomic<size_t> index{0};
+        size_t cached = 0;  // last index seen from the other side
+    };
+    vector<T> slots;
+    size_t mask;
+    Side producer;
+    Side consumer;
+};
+
+// Bounded ring for many producer threads and one consumer (Vyukov's bounded
+// queue). Producers claim a position with one CAS on the tail; each cell's
+// sequence number says whether it is free for that position or holds a value.
+template <typename T>
+class MpscRing {
+public:
+    explicit MpscRing(size_t capacity) : cells(roundUpToPowerOfTwo(max<size_t>(capacity, 2))), mask(cells.size() - 1) {
+        for (size_t i = 0; i < cells.size(); ++i) {
+            cells[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(const T& value) {
+        size_t position = tail.load(memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            intptr_t lag = (intptr_t)cell.sequence.load(memory_order_acquire) - (intptr_t)position;
+            if (lag == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;  // the consumer has not freed this cell yet
+            } else {
+                position = tail.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only
+    bool tryPop(T& value) {
+        Cell& cell = cells[head & mask];
+        if (cell.sequence.load(memory_order_acquire) != head + 1) {
+            return false;
+        }
+        value = cell.value;
+        cell.sequence.store(head + cells.size(), memory_order_release);
+        ++head;
+        return true;
+    }
+
+private:
+    struct Cell {
+        atomic<size_t> sequence{0};
+        T value;
+    };
+    vector<Cell> cells;
+    size_t mask;
+    alignas(64) atomic<size_t> tail{0};
+    alignas(64) size_t head = 0;
+};
+
+enum class OverflowPolicy {
+    Drop,  // skip events while the consumer is behind; dropped() counts them
+    Wait   // hold the dispatcher until the consumer catches up
+};
+
+// One consumer's view of the stream. Poll it from the consumer's own thread.
+class EventSubscription {
+public:
+    const string name;
+    const OverflowPolicy policy;
+
+    EventSubscription(const string& name, size_t capacity, OverflowPolicy policy) 
+        : name(name), policy(policy), ring(capacity) {}
+
+    bool poll(RentalEvent& event) { return ring.tryPop(event); }
+    size_t backlog() const { return ring.size(); }
+    uint64_t dropped() const { return dropped_events.load(memory_order_relaxed); }
+
+private:
+    friend class EventBus;
+    SpscRing<RentalEvent> ring;
+    atomic<uint64_t> dropped_events{0};
+    atomic<bool> closed{false};
+};
+
+class EventBus {
+public:
+    explicit EventBus(size_t capacity = 1 << 16) : inbox(capacity) {}
+    ~EventBus() { stop(); }
+
+    // Called on every mutation; a single relaxed load while nobody subscribes
+    void publish(RentalEvent event) {
+        if (!listening.load(memory_order_relaxed)) {
+            return;
+        }
+        event.time = time(0);
+        if (!inbox.tryPush(event)) {
+            inbox_drops.fetch_add(1, memory_order_relaxed);
+        }
+    }
+
+    // Start receiving every event published from now on. Starts the dispatcher if needed.
+    shared_ptr<EventSubscription> subscribe(const string& name, size_t capacity = 1 << 16, 
+                                            OverflowPolicy policy = OverflowPolicy::Drop) {
+        auto subscription = make_shared<EventSubscription>(name, capacity, policy);
+        lock_guard<mutex> guard(subscriptions_lock);
+        subscriptions.push_back(subscription);
+        subscriptions_version.fetch_add(1, memory_order_release);
+        if (!dispatcher.joinable()) {
+            stopping.store(false, memory_order_relaxed);
+            dispatching.store(true, memory_order_relaxed);
+            dispatcher = thread(&EventBus::dispatchLoop, this);
+        }
+        listening.store(true, memory_order_relaxed);
+        return subscription;
+    }
+
+    void unsubscribe(const shared_ptr<EventSubscription>& subscription) {
+        subscription->closed.store(true, memory_order_release);  // frees a dispatcher waiting on it
+        lock_guard<mutex> guard(subscriptions_lock);
+        subscriptions.erase(remove(subscriptions.begin(), subscriptions.end(), subscription), subscriptions.end());
+        subscriptions_version.fetch_add(1, memory_order_release);
+        listening.store(!subscriptions.empty(), memory_order_relaxed);
+    }
+
+    // Hand out everything published so far, then stop the dispatcher. Subscribers
+    // keep what is already in their rings; publishing resumes on the next subscribe.
+    void stop() {
+        if (!dispatcher.joinable()) {
+            return;
+        }
+        stopping.store(true, memory_order_release);
+        dispatcher.join();
+        listening.store(false, memory_order_relaxed);
+    }
+
+    // False once the dispatcher has handed out its last event
+    bool running() const { return dispatching.load(memory_order_acquire); }
+    uint64_t dispatched() const { return sequence.load(memory_order_relaxed); }
+    // Events lost because renters found the shared ring full
+    uint64_t inboxDrops() const { return inbox_drops.load(memory_order_relaxed); }
+
+private:
+    MpscRing<RentalEvent> inbox;
+    atomic<bool> listening{false};
+    atomic<bool> stopping{true};
+    atomic<bool> dispatching{false};
+    atomic<uint64_t> inbox_drops{0};
+    atomic<uint64_t> sequence{0};
+    thread dispatcher;
+    mutex subscriptions_lock;
+    vector<shared_ptr<EventSubscription>> subscriptions;
+    atomic<uint64_t> subscriptions_version{0};
+
+    void dispatchLoop() {
+        vector<shared_ptr<EventSubscription>> targets;
+        uint64_t targets_version = UINT64_MAX;
+        RentalEvent event;
+        int idle_rounds = 0;
+        while (true) {
+            uint64_t version = subscriptions_version.load(memory_order_acquire);
+            if (version != targets_version) {
+                lock_guard<mutex> guard(subscriptions_lock);
+                targets = subscriptions;
+                targets_version = version;
+            }
+            if (!inbox.tryPop(event)) {
+                if (!stopping.load(memory_order_acquire)) {
+                    backOff(idle_rounds++);
+                    continue;
+                }
+                // Look once more after seeing the stop, so nothing published before it is left behind
+                if (!inbox.tryPop(event)) {
+                    dispatching.store(false, memory_order_release);
+                    return;
+                }
+            }
+            idle_rounds = 0;
+            event.sequence = sequence.fetch_add(1, memory_order_relaxed) + 1;
+            for (const auto& target : targets) {
+                deliver(*target, event);
+            }
+        }
+    }
+
+    static void deliver(EventSubscription& target, const RentalEvent& event) {
+        if (target.ring.tryPush(event)) {
+            return;
+        }
+        if (target.policy == OverflowPolicy::Drop) {
+            target.dropped_events.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+        while (!target.ring.tryPush(event)) {
+            if (target.closed.load(memory_order_acquire)) {
+                return;
+            }
+            this_thread::yield();
+        }
+    }
+
+    // Spin briefly, then yield, then sleep, so an idle dispatcher costs nothing
+    static void backOff(int idle_rounds) {
+        if (idle_rounds < 64) {
+            this_thread::yield();
+        } else {
+            this_thread::sleep_for(chrono::microseconds(100));
+        }
+    }
+};
+
+EventBus event_bus;
+
+void publishEvent(EventType type, RenterRole role, int account_id, int vehicle_id, int64_t amount = 0, int32_t field = 0) {
+    RentalEvent event;
+    event.type = type;
+    event.role = role;
+    event.account_id = account_id;
+    event.vehicle_id = vehicle_id;
+    event.amount = amount;
+    event.field = field;
+    event_bus.publish(event);
+}
+
+// Consumer behind --audit: one JSON line per event until the bus stops
+void writeAuditTrail(EventSubscription& subscription, FILE* output) {
+    RentalEvent event;
+    while (true) {
+        bool running = event_bus.running();
+        bool received = false;
+        while (subscription.poll(event)) {
+            received = true;
+            // Vehicle events carry no account, and so no role
+            const char* role = event.account_id == 0 ? "none" : event.role == RenterRole::Client ? "client" : "staff";
+            fprintf(output, "{\"seq\":%llu,\"time\":%lld,\"event\":\"%s\",\"role\":\"%s\",\"account\":%d,"
+                    "\"vehicle\":%d,\"field\":%d,\"amount\":%lld}\n", (unsigned long long)event.sequence, 
+                    (long long)event.time, eventTypeName(event.type), role, event.account_id, event.vehicle_id, 
+                    event.field, (long long)event.amount);
+        }
+        if (!running) {
+            break;
+        }
+        if (!received) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+    fflush(output);
+}
+
+//======================= WRITE-AHEAD LOG =======================//
+
+// Every committed mutation is appended to the transaction log as a redo
+// record holding its outcome (charges, penalties, new field values), so
+// replay never re-evaluates the clock or business rules. The file starts
+// with a WalHeader, followed by records framed as
+//   uint32 payload length, uint32 CRC-32 of the payload, payload
+// where the payload is the serialized WalRecord below.
+//
+// Each snapshot stores the log generation that follows it. A checkpoint
+// bumps the generation, writes the snapshot, then restarts the log under
+// the new generation; recovery only replays a log whose generation matches
+// the snapshot, so a crash between those two steps cannot apply records twice.
+
+struct WalHeader {
+    char magic[8];
+    uint64_t generation;
+};
+
+const char WAL_MAGIC[8] = {'C', 'R', 'W', 'A', 'L', '0', '0', '1'};
+
+uint64_t wal_generation = 0;
+
+enum class WalRecordType : uint8_t {
+    VehicleAdded = 1,
+    VehicleRemoved,
+    VehicleFieldSet,
+    VehicleStatusSet,
+    AccountAdded,
+    AccountRemoved,
+    AccountFieldSet,
+    Rented,
+    Returned,
+    Payment,
+    LateFeeAccrued,
+    Reserved,
+    ReservationReleased
+};
+
+// Vehicle fields editable through modifyVehicle
+enum class VehicleField : int32_t {
+    Brand = 1, Model, Rent, Price, Seats, Color, Condition
+};
+
+// Account fields editable through modifyClient / modifyStaff
+enum class AccountField : int32_t {
+    Name = 1, Password, Dues, Rating
+};
+
+struct WalRecord {
+    WalRecordType type = WalRecordType::Payment;
+    RenterRole role = RenterRole::Client;
+    int32_t account_id = 0;
+    int32_t vehicle_id = 0;
+    int32_t field = 0;
+    double real = 0;          // staff ratings and rating deductions
+    vector<int64_t> numbers;  // amounts, times and integer field values
+    vector<string> texts;     // names, passwords and string field values
+};
+
+uint32_t crc32(const char* data, size_t length) {
+    // Built once on first use; static initialization is thread-safe, so replay workers can share it
+    static const array<uint32_t, 256> table = [] {
+        array<uint32_t, 256> entries{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            entries[i] = value;
+        }
+        return entries;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ (unsigned char)data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename T>
+void appendBytes(string& out, const T& value) {
+    out.append((const char*)&value, sizeof(value));
+}
+
+// Append one framed record (length, CRC, payload) to the output buffer
+void encodeWalRecord(const WalRecord& record, string& out) {
+    string payload;
+    appendBytes(payload, record.type);
+    appendBytes(payload, record.role);
+    appendBytes(payload, record.account_id);
+    appendBytes(payload, record.vehicle_id);
+    appendBytes(payload, record.field);
+    appendBytes(payload, record.real);
+    appendBytes(payload, (uint32_t)record.numbers.size());
+    for (int64_t number : record.numbers) {
+        appendBytes(payload, number);
+    }
+    appendBytes(payload, (uint32_t)record.texts.size());
+    for (const auto& text : record.texts) {
+        appendBytes(payload, (uint32_t)text.size());
+        payload += text;
+    }
+    appendBytes(out, (uint32_t)payload.size());
+    appendBytes(out, crc32(payload.data(), payload.size()));
+    out += payload;
+}
+
+// Parse a payload produced by encodeWalRecord; false if it is malformed
+bool decodeWalRecord(const char* data, size_t length, WalRecord& record) {
+    size_t position = 0;
+    auto take = [&](void* value, size_t size) {
+        if (length - position < size) {
+            return false;
+        }
+        memcpy(value, data + position, size);
+        position += size;
+        return true;
+    };
+    uint32_t count;
+    if (!take(&record.type, sizeof(record.type)) || !take(&record.role, sizeof(record.role))
+            || !take(&record.account_id, sizeof(record.account_id)) 
+            || !take(&record.vehicle_id, sizeof(record.vehicle_id))
+            || !take(&record.field, sizeof(record.field)) || !take(&record.real, sizeof(record.real))
+            || !take(&count, sizeof(count)) || count > (length - position) / sizeof(int64_t)) {
+        return false;
+    }
+    record.numbers.resize(count);
+    for (auto& number : record.numbers) {
+        take(&number, sizeof(number));
+    }
+    if (!take(&count, sizeof(count)) || count > length - position) {
+        return false;
+    }
+    record.texts.resize(count);
+    for (auto& text : record.texts) {
+        uint32_t text_length;
+        if (!take(&text_length, sizeof(text_length)) || text_length > length - position) {
+            return false;
+        }
+        text.assign(data + position, text_length);
+        position += text_length;
+    }
+    return position == length;
+}
+
+// Append-only log with group commit. Callers append records and later call
+// commit(), which blocks until everything they appended is on disk. A single
+// flusher thread gathers records for up to commit_delay (or until the batch
+// reaches max_batch_bytes) and makes the whole batch durable with one fsync.
+class WriteAheadLog {
+public:
+    size_t max_batch_bytes = 1 << 20;
+    uint64_t flushed_batches = 0;  // number of fsyncs issued, for group commit statistics
+
+    ~WriteAheadLog() { close(); }
+
+    bool isOpen() const { return descriptor >= 0; }
+
+    // Start a fresh log for the given generation, discarding any previous contents
+    bool open(const string& path, uint64_t generation, chrono::microseconds delay) {
+#ifndef _WIN32
+        descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+#endif
+        if (descriptor < 0 || !writeHeader(generation)) {
+            return false;
+        }
+        commit_delay = delay;
+        stopping = false;
+        write_failed = false;
+        flusher = thread(&WriteAheadLog::flushLoop, this);
+        return true;
+    }
+
+    void close() {
+        if (descriptor < 0) {
+            return;
+        }
+        {
+            lock_guard<mutex> guard(state_lock);
+            stopping = true;
+        }
+        work_ready.notify_one();
+        flusher.join();
+#ifndef _WIN32
+        ::close(descriptor);
+#endif
+        descriptor = -1;
+    }
+
+    // Queue a record for the next batch; a no-op while the log is closed
+    void append(const WalRecord& record) {
+        if (descriptor < 0) {
+            return;
+        }
+        lock_guard<mutex> guard(state_lock);
+        encodeWalRecord(record, pending);
+        ++appended_records;
+        if (pending.size() >= max_batch_bytes) {
+            work_ready.notify_one();
+        }
+    }
+
+    // Wait until every record appended so far is durable. False if a write failed.
+    bool commit() {
+        if (descriptor < 0) {
+            return true;
+        }
+        unique_lock<mutex> guard(state_lock);
+        uint64_t target = appended_records;
+        work_ready.notify_one();
+        flushed.wait(guard, [&] { return durable_records >= target || write_failed; });
+        return !write_failed;
+    }
+
+    // Discard the log contents once a snapshot covers them and continue under a new generation
+    bool restart(uint64_t generation) {
+        if (!commit()) {
+            return false;
+        }
+        lock_guard<mutex> guard(state_lock);
+#ifndef _WIN32
+        return ftruncate(descriptor, 0) == 0 && writeHeader(generation);
+#else
+        return writeHeader(generation);
+#endif
+    }
+
+private:
+    int descriptor = -1;
+    chrono::microseconds commit_delay{0};
+    thread flusher;
+    mutex state_lock;
+    condition_variable work_ready;
+    condition_variable flushed;
+    string pending;
+    uint64_t appended_records = 0;
+    uint64_t durable_records = 0;
+    bool stopping = false;
+    bool write_failed = false;
+
+    void flushLoop() {
+        unique_lock<mutex> guard(state_lock);
+        while (true) {
+            work_ready.wait(guard, [&] { return stopping || !pending.empty(); });
+            if (pending.empty()) {
+                return;
+            }
+            // Group window: let concurrent transactions join this batch
+            work_ready.wait_for(guard, commit_delay, 
+                                [&] { return stopping || pending.size() >= max_batch_bytes; });
+            
+            string batch;
+            batch.swap(pending);
+            uint64_t batch_end = appended_records;
+            guard.unlock();
+            bool written = writeDurably(batch);
+            guard.lock();
+            durable_records = batch_end;
+            write_failed = write_failed || !written;
+            ++flushed_batches;
+            flushed.notify_all();
+        }
+    }
+
+    bool writeHeader(uint64_t generation) {
+        WalHeader header;
+        memcpy(header.magic, WAL_MAGIC, sizeof(header.magic));
+        header.generation = generation;
+        return writeDurably(string((const char*)&header, sizeof(header)));
+    }
+
+    bool writeDurably(const string& batch) {
+#ifndef _WIN32
+        size_t written = 0;
+        while (written < batch.size()) {
+            ssize_t result = ::write(descriptor, batch.data() + written, batch.size() - written);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            written += result;
+        }
+        return fdatasync(descriptor) == 0;
+#else
+        return false;
+#endif
+    }
+};
+
+WriteAheadLog transaction_log;
+
+// Record builders used by the portals and admin panel. Each also publishes
+// the change on the event stream.
+void logRental(RenterRole role, int renter_id, int vehicle_id, time_t start_time, time_t deadline, int charge) {
+    WalRecord record;
+    record.type = WalRecordType::Rented;
+    record.role = role;
+    record.account_id = renter_id;
+    record.vehicle_id = vehicle_id;
+    record.numbers = {start_time, deadline, charge};
+    transaction_log.append(record);
+    publishEvent(EventType::Rented, role, renter_id, vehicle_id, charge);
+}
+
+void logReturn(RenterRole role, int renter_id, int vehicle_id, int penalty, double rating_deduction) {
+    WalRecord record;
+    record.type = WalRecordType::Returned;
+    record.role = role;
+    record.account_id = renter_id;
+    record.vehicle_id = vehicle_id;
+    record.real = rating_deduction;
+    record.numbers = {penalty};
+    transaction_log.append(record);
+    publishEvent(EventType::Returned, role, renter_id, vehicle_id, penalty);
+}
+
+void logPayment(RenterRole role, int renter_id, int amount) {
+    WalRecord record;
+    record.type = WalRecordType::Payment;
+    record.role = role;
+    record.account_id = renter_id;
+    record.numbers = {amount};
+    transaction_log.append(record);
+    publishEvent(EventType::Payment, role, renter_id, 0, amount);
+}
+
+// days is the rental's new accrued total, so replaying the record twice cannot double-charge the return
+void logLateFee(RenterRole role, int renter_id, int vehicle_id, int fee, int days, double rating_deduction) {
+    WalRecord record;
+    record.type = WalRecordType::LateFeeAccrued;
+    record.role = role;
+    record.account_id = renter_id;
+    record.vehicle_id = vehicle_id;
+    record.real = rating_deduction;
+    record.numbers = {fee, days};
+    transaction_log.append(record);
+    publishEvent(EventType::LateFee, role, renter_id, vehicle_id, fee);
+}
+
+void logReservation(const Reservation& reservation) {
+    WalRecord record;
+    record.type = WalRecordType::Reserved;
+    record.role = reservation.renter_role;
+    record.account_id = reservation.renter_id;
+    record.vehicle_id = reservation.vehicle_id;
+    record.numbers = {reservation.reservation_id, reservation.start, reservation.end};
+    transaction_log.append(record);
+    publishEvent(EventType::Reserved, reservation.renter_role, reservation.renter_id, reservation.vehicle_id, 
+                 reservation.reservation_id);
+}
+
+// Logged for cancellations and for bookings turned into rentals
+void logReservationReleased(int vehicle_id, int reservation_id) {
+    WalRecord record;
+    record.type = WalRecordType::ReservationReleased;
+    record.vehicle_id = vehicle_id;
+    record.numbers = {reservation_id};
+    transaction_log.append(record);
+    publishEvent(EventType::ReservationReleased, RenterRole::Client, 0, vehicle_id, reservation_id);
+}
+
+void logVehicleAdded(int vehicle_id, const Vehicle& vehicle) {
+    WalRecord record;
+    record.type = WalRecordType::VehicleAdded;
+    record.vehicle_id = vehicle_id;
+    record.numbers = {vehicle.daily_rent, vehicle.market_price, vehicle.seating_capacity, 
+                      vehicle.vehicle_condition, vehicle.return_deadline};
+    record.texts = {vehicle.brand_name, vehicle.vehicle_model, vehicle.vehicle_color};
+    transaction_log.append(record);
+    publishEvent(EventType::VehicleAdded, RenterRole::Client, 0, vehicle_id, vehicle.daily_rent);
+}
+
+void logVehicleRemoved(int vehicle_id) {
+    WalRecord record;
+    record.type = WalRecordType::VehicleRemoved;
+    record.vehicle_id = vehicle_id;
+    transaction_log.append(record);
+    publishEvent(EventType::VehicleRemoved, RenterRole::Client, 0, vehicle_id);
+}
+
+void logVehicleField(int vehicle_id, VehicleField field, int64_t number, const string& text = "") {
+    WalRecord record;
+    record.type = WalRecordType::VehicleFieldSet;
+    record.vehicle_id = vehicle_id;
+    record.field = (int32_t)field;
+    record.numbers = {number};
+    record.texts = {text};
+    transaction_log.append(record);
+    publishEvent(EventType::VehicleChanged, RenterRole::Client, 0, vehicle_id, number, (int32_t)field);
+}
+
+void logVehicleStatus(int vehicle_id, bool rented) {
+    WalRecord record;
+    record.type = WalRecordType::VehicleStatusSet;
+    record.vehicle_id = vehicle_id;
+    record.numbers = {rented};
+    transaction_log.append(record);
+    publishEvent(EventType::VehicleStatusSet, RenterRole::Client, 0, vehicle_id, rented);
+}
+
+void logAccountAdded(RenterRole role, int user_id, const string& name, const string& password) {
+    WalRecord record;
+    record.type = WalRecordType::AccountAdded;
+    record.role = role;
+    record.account_id = user_id;
+    record.texts = {name, password};
+    transaction_log.append(record);
+    publishEvent(EventType::AccountAdded, role, user_id, 0);
+}
+
+void logAccountRemoved(RenterRole role, int user_id) {
+    WalRecord record;
+    record.type = WalRecordType::AccountRemoved;
+    record.role = role;
+    record.account_id = user_id;
+    transaction_log.append(record);
+    publishEvent(EventType::AccountRemoved, role, user_id, 0);
+}
+
+void logAccountField(RenterRole role, int user_id, AccountField field, 
+                     int64_t number, double real = 0, const string& text = "") {
+    WalRecord record;
+    record.type = WalRecordType::AccountFieldSet;
+    record.role = role;
+    record.account_id = user_id;
+    record.field = (int32_t)field;
+    record.real = real;
+    record.numbers = {number};
+    record.texts = {text};
+    transaction_log.append(record);
+    publishEvent(EventType::AccountChanged, role, user_id, 0, number, (int32_t)field);
+}
+
+// Make logged changes durable before confirming them to the user
+void commitTransactions() {
+    if (!transaction_log.commit()) {
+        cout << "Warning: transaction log write failed, recent changes may not survive a restart\n";
+    }
+}
+
+//======================= BASE USER CLASS =======================//
+
+class BaseUser {
+protected:
+    string user_password;
+    
+public:
+    int user_id;
+    string username;
+    static atomic<int> customer_count;
+    static atomic<int> employee_count;
+    
+    void displayAllVehicles();
+    void searchVehicles();
+    bool validatePassword(const string& password);
+};
+
+atomic<int> BaseUser::customer_count{0};
+atomic<int> BaseUser::employee_count{0};
+
+// Username index shared by the client and staff portals. A name may belong to
+// one client and one staff member at the same time, so each entry carries the
+// user ID for both roles (0 when the role has no account under that name).
+//
+// Entries store only the name's hash and the user IDs; the name itself is read
+// back from the account it points at. That keeps the table free of pointers so
+// snapshots can restore it with a single copy instead of rehashing every name.
+struct AccountIndexEntry {
+    uint64_t name_hash = 0;  // 0 marks an empty slot
+    int client_id = 0;
+    int staff_id = 0;
+};
+
+// Username of the account an index entry points at (defined after the user tables)
+const string& accountName(const AccountIndexEntry& entry);
+
+// Stable 64-bit FNV-1a hash, so hashes written to a snapshot stay valid across builds
+uint64_t hashAccountName(const string& name) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char character : name) {
+        hash = (hash ^ character) * 1099511628211ULL;
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+// Open-addressing (linear probing) table with backward-shift deletion
+class AccountIndex {
+public:
+    vector<AccountIndexEntry> slots;
+    size_t entry_count = 0;
+
+    void clear() {
+        slots.clear();
+        entry_count = 0;
+    }
+
+    void reserve(size_t count) {
+        size_t capacity = 16;
+        while (capacity < count * 2) {
+            capacity *= 2;
+        }
+        if (capacity > slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+    AccountIndexEntry* find(const string& name) {
+        if (slots.empty()) {
+            return nullptr;
+        }
+        uint64_t hash = hashAccountName(name);
+        size_t mask = slots.size() - 1;
+        for (size_t position = hash & mask; slots[position].name_hash != 0; position = (position + 1) & mask) {
+            if (slots[position].name_hash == hash && accountName(slots[position]) == name) {
+                return &slots[position];
+            }
+        }
+        return nullptr;
+    }
+
+    // Entry for the name, inserting an empty one if it is not indexed yet
+    AccountIndexEntry& findOrInsert(const string& name) {
+        AccountIndexEntry* existing = find(name);
+        if (existing != nullptr) {
+            return *existing;
+        }
+        if ((entry_count + 1) * 2 > slots.size()) {
+            rehash(slots.empty() ? 16 : slots.size() * 2);
+        }
+        uint64_t hash = hashAccountName(name);
+        size_t mask = slots.size() - 1;
+        size_t position = hash & mask;
+        while (slots[position].name_hash != 0) {
+            position = (position + 1) & mask;
+        }
+        ++entry_count;
+        slots[position] = AccountIndexEntry();
+        slots[position].name_hash = hash;
+        return slots[position];
+    }
+
+    void erase(AccountIndexEntry* entry) {
+        size_t mask = slots.size() - 1;
+        size_t hole = entry - slots.data();
+        // Pull later members of the probe run back so lookups never stop early
+        for (size_t position = (hole + 1) & mask; slots[position].name_hash != 0; position = (position + 1) & mask) {
+            size_t home = slots[position].name_hash & mask;
+            if (((position - home) & mask) >= ((position - hole) & mask)) {
+                slots[hole] = slots[position];
+                hole = position;
+            }
+        }
+        slots[hole] = AccountIndexEntry();
+        --entry_count;
+    }
+
+private:
+    void rehash(size_t capacity) {
+        vector<AccountIndexEntry> old_slots(capacity);
+        old_slots.swap(slots);
+        size_t mask = capacity - 1;
+        for (const auto& entry : old_slots) {
+            if (entry.name_hash == 0) {
+                continue;
+            }
+            size_t position = entry.name_hash & mask;
+            while (slots[position].name_hash != 0) {
+                position = (position + 1) & mask;
+            }
+            slots[position] = entry;
+        }
+    }
+};
+
+AccountIndex account_index;
+
+// Look up the user ID registered under a name for one role, 0 if none
+int findAccountId(const string& name, int AccountIndexEntry::*role) {
+    AccountIndexEntry* entry = account_index.find(name);
+    return entry == nullptr ? 0 : entry->*role;
+}
+
+// Call after the account is reachable through its ID, since the index reads names back from it
+void indexAccountName(const string& name, int AccountIndexEntry::*role, int user_id) {
+    account_index.findOrInsert(name).*role = user_id;
+}
+
+// Call before the account's name changes or the account is dropped
+void unindexAccountName(const string& name, int AccountIndexEntry::*role) {
+    AccountIndexEntry* entry = account_index.find(name);
+    if (entry == nullptr) {
+        return;
+    }
+    entry->*role = 0;
+    if (entry->client_id == 0 && entry->staff_id == 0) {
+        account_index.erase(entry);
+    }
+}
+
+// Dense user ID -> database slot table, maintained the same way as vehicle_slot_by_id
+template <typename User>
+void reindexUsers(vector<int>& slot_by_id, const vector<User>& database, size_t first_slot) {
+    for (size_t slot = first_slot; slot < database.size(); ++slot) {
+        int user_id = database[slot].user_id;
+        if (user_id >= (int)slot_by_id.size()) {
+            slot_by_id.resize(user_id + 1, -1);
+        }
+        slot_by_id[user_id] = (int)slot;
+    }
+}
+
+// Tombstone a user row in O(1): the ID stops resolving at once and the row
+// keeps its place, with user_id 0, until compactUsers squeezes it out
+template <typename User>
+void tombstoneUser(vector<int>& slot_by_id, vector<User>& database, size_t slot, size_t& dead_rows) {
+    slot_by_id[database[slot].user_id] = -1;
+    database[slot].user_id = 0;
+    ++dead_rows;
+}
+
+template <typename User>
+void compactUsers(vector<int>& slot_by_id, vector<User>& database, size_t& dead_rows) {
+    if (dead_rows == 0) {
+        return;
+    }
+    database.erase(remove_if(database.begin(), database.end(), [](const User& user) { return user.user_id == 0; }),
+                   database.end());
+    reindexUsers(slot_by_id, database, 0);
+    dead_rows = 0;
+}
+
+template <typename User>
+User* findUser(const vector<int>& slot_by_id, vector<User>& database, int user_id) {
+    if (user_id <= 0 || user_id >= (int)slot_by_id.size()) {
+        return nullptr;
+    }
+    int slot = slot_by_id[user_id];
+    return slot < 0 ? nullptr : &database[slot];
+}
+
+// Column headings shared by the full and filtered fleet listings
+void printVehicleHeader(OutputBuffer& out) {
+    out.padded("ID", 3).padded("Brand", 15).padded("Model", 15).padded("Rent", 7).padded("Price", 12)
+       .padded("Seats", 6).padded("Color", 10).padded("Available", 10).padded("Condition", 10)
+       .padded("Due Date", 15).text("\n");
+}
+
+void BaseUser::displayAllVehicles() {
+    time_t current_time = time(0);
+    const FleetStore& fleet = vehicle_inventory;
+    ensureVersionedTables();
+    // Every page shows the same moment, however long the reader lingers between them
+    TableSnapshot snapshot;
+    auto render = [&snapshot, current_time](OutputBuffer& out, size_t slot) {
+        const VehicleVersion& vehicle = snapshot.vehicle(slot);
+        vehicle_row_cache.render(out, slot, vehicle.rented, vehicle.deadline, current_time);
+    };
+    if (fleet.dead_rows == 0) {
+        showPaged(fleet.size(), "vehicles", printVehicleHeader, render);
+        return;
+    }
+    // Skip tombstones left by removals since the last compaction
+    vector<size_t> live_slots;
+    live_slots.reserve(fleet.liveCount());
+    for (size_t slot = 0; slot < fleet.size(); ++slot) {
+        if (fleet.isLive(slot)) {
+            live_slots.push_back(slot);
+        }
+    }
+    showPaged(live_slots.size(), "vehicles", printVehicleHeader, [&live_slots, &render](OutputBuffer& out, size_t index) {
+        render(out, live_slots[index]);
+    });
+}
+
+// Ask for filter conditions
+void promptFleetFilter(FleetFilter& filter) {
+    cout << "Minimum seats: ";
+    cin >> filter.min_seats;
+    cout << "Maximum daily rent: ";
+    cin >> filter.max_rent;
+    cout << "Minimum condition: ";
+    cin >> filter.min_condition;
+    string brand, color;
+    cout << "Brand (any for all): ";
+    cin >> brand;
+    cout << "Color (any for all): ";
+    cin >> color;
+    if (brand != "any") {
+        filter.setBrand(brand);
+    }
+    if (color != "any") {
+        filter.setColor(color);
+    }
+}
+
+// Page through the selected vehicles
+void showSelectedVehicles(const SelectionBitmap& selection) {
+    vector<size_t> matches;
+    forEachSelected(selection, [&matches](size_t slot) { matches.push_back(slot); });
+    time_t current_time = time(0);
+    showPaged(matches.size(), "matches", printVehicleHeader, [&matches, current_time](OutputBuffer& out, size_t index) {
+        vehicle_row_cache.render(out, matches[index], current_time);
+    });
+    cout << matches.size() << " vehicle(s) matched\n\n\n";
+}
+
+// Read a bound where 0 means no bound
+int promptBound(const char* prompt, int unbounded) {
+    int value = 0;
+    cout << prompt;
+    cin >> value;
+    return value == 0 ? unbounded : value;
+}
+
+void BaseUser::searchVehicles() {
+    FleetSearch search;
+    string brand, model, color;
+    cout << "Brand (any for all): ";
+    cin >> brand;
+    cout << "Model (any for all): ";
+    cin >> model;
+    cout << "Color (any for all): ";
+    cin >> color;
+    if (brand != "any") {
+        search.setBrand(brand);
+    }
+    if (model != "any") {
+        search.setModel(model);
+    }
+    if (color != "any") {
+        search.setColor(color);
+    }
+    search.min_seats = promptBound("Minimum seats (0 for any): ", INT_MIN);
+    search.max_seats = promptBound("Maximum seats (0 for any): ", INT_MAX);
+    search.min_rent = promptBound("Minimum daily rent (0 for any): ", INT_MIN);
+    search.max_rent = promptBound("Maximum daily rent (0 for any): ", INT_MAX);
+    search.min_condition = promptBound("Minimum condition (0 for any): ", INT_MIN);
+    cout << "Available only (1/0): ";
+    cin >> search.available_only;
+    SelectionBitmap selection;
+    searchFleet(search, selection);
+    showSelectedVehicles(selection);
+}
+
+bool BaseUser::validatePassword(const string& password) {
+    return (this->user_password == password);
+}
+
+//======================= RENTER POLICIES =======================//
+
+// Money rates are fixed point in units of 1/10000, so a charge is one integer
+// multiply and divide and rounds the same way on every platform
+const int64_t RATE_SCALE = 10000;
+
+int applyRate(int64_t amount, int64_t rate) {
+    return int(amount * rate / RATE_SCALE);
+}
+
+// Everything that differs between renter roles. A new kind of renter is a new
+// policy type plus its own account table; rent, return, dues and the portal
+// come from Renter<Policy>.
+struct ClientPolicy {
+    static constexpr RenterRole ROLE = RenterRole::Client;
+    using Rating = int;
+    static constexpr Rating DEFAULT_RATING = 100;
+    static constexpr int64_t RENT_RATE = RATE_SCALE;           // full price
+    static constexpr int64_t LATE_FEE_RATE = RATE_SCALE / 5;   // a fifth of the rent per day late
+    static constexpr int RATING_LOSS_PER_DAY = 2;
+    static constexpr const char* RENTED_MESSAGE = "Vehicle rented successfully\n";
+    static atomic<int>& userCounter() { return BaseUser::customer_count; }
+};
+
+struct StaffPolicy {
+    static constexpr RenterRole ROLE = RenterRole::Staff;
+    using Rating = double;
+    static constexpr Rating DEFAULT_RATING = 1.00;
+    static constexpr int64_t RENT_RATE = 8500;                 // employee discount
+    static constexpr int64_t LATE_FEE_RATE = 1700;
+    static constexpr int RATING_LOSS_PER_DAY = 2;
+    static constexpr const char* RENTED_MESSAGE = "Vehicle rented successfully (Employee discount applied)\n";
+    static atomic<int>& userCounter() { return BaseUser::employee_count; }
+};
+
+template <typename Policy>
+int rentalCharge(int daily_rent) {
+    return applyRate(daily_rent, Policy::RENT_RATE);
+}
+
+// Total late fee for a rental kept the given number of whole days past its deadline
+template <typename Policy>
+int lateFeeForDays(int daily_rent, int64_t days_late) {
+    return applyRate(int64_t(daily_rent) * days_late, Policy::LATE_FEE_RATE);
+}
+
+// Late fee for a return at the given time, charged per whole day past the deadline
+template <typename Policy>
+int latePenalty(int daily_rent, time_t deadline, time_t now) {
+    if (now <= deadline) {
+        return 0;
+    }
+    return lateFeeForDays<Policy>(daily_rent, (now - deadline) / SECONDS_PER_DAY);
+}
+
+// For listings that mix roles
+int latePenalty(RenterRole role, int daily_rent, time_t deadline, time_t now) {
+    if (role == RenterRole::Client) {
+        return latePenalty<ClientPolicy>(daily_rent, deadline, now);
+    }
+    return latePenalty<StaffPolicy>(daily_rent, deadline, now);
+}
+
+template <typename Policy>
+class Renter : public BaseUser {
+public:
+    using PolicyType = Policy;
+    using Rating = typename Policy::Rating;
+
+protected:
+    int outstanding_dues;
+    Rating rating;
+
+public:
+    friend class Administrator;
+    friend class SnapshotFile;
+    friend class WalReplay;
+    friend class RentalEngine;
+    friend class ReportBuilder;
+    friend class ShardedRuntime;
+    friend void syncVersionedTables();
+    friend bool addClient(const Renter<ClientPolicy>& client);
+    friend bool addStaff(const Renter<StaffPolicy>& staff);
+
+    Renter(string name, string password, Rating rating = Policy::DEFAULT_RATING, int dues = 0) {
+        this->username = move(name);
+        this->user_password = move(password);
+        this->user_id = ++Policy::userCounter();
+        this->outstanding_dues = dues;
+        this->rating = rating;
+    }
+
+    void accessPortal();
+    void rentVehicle();
+    void returnVehicle();
+    OperationStatus rentVehicle(int vehicle_id, int& charge);
+    OperationStatus returnVehicle(int vehicle_id, int& penalty);
+    OperationStatus payDues(int payment_amount);
+    OperationStatus reserveVehicle(int vehicle_id, time_t start, time_t end, int& reservation_id);
+    OperationStatus cancelReservation(int reservation_id);
+    void reserveVehicle();
+    void cancelReservation();
+    void findFreeVehicles();
+    void showRentedVehicles();
+    void checkOutstandingDues();
+    void payDues();
+};
+
+template <typename Policy>
+OperationStatus Renter<Policy>::rentVehicle(int vehicle_id, int& charge) {
+    OperationTimer timer(MetricOp::Rent);
+    charge = 0;
+    int vehicle_slot = findVehicleSlot(vehicle_id);
+    if (vehicle_slot == -1) {
+        return timer.finish(OperationStatus::VehicleNotFound);
+    }
+    if (!claimVehicle(vehicle_slot)) {
+        return timer.finish(OperationStatus::AlreadyRented);
+    }
+    
+    // Held until the rental is open, so a booking made meanwhile sees its deadline
+    lock_guard<mutex> calendar_guard(calendarLock(vehicle_id));
+    auto current_time = time(0);
+    time_t deadline;
+    int reservation_id;
+    if (!claimRentalPeriod(Policy::ROLE, this->user_id, vehicle_id, current_time, deadline, reservation_id)) {
+        vehicle_inventory.setRented(vehicle_slot, false);
+        return timer.finish(OperationStatus::Reserved);
+    }
+    
+    charge = rentalCharge<Policy>(vehicle_inventory.daily_rent[vehicle_slot]);
+    vehicle_inventory.addRevenue(vehicle_slot, charge);
+    lock_guard<mutex> guard(renterLock(Policy::ROLE, this->user_id));
+    this->outstanding_dues += charge;
+    if (reservation_id != 0) {
+        logReservationReleased(vehicle_id, reservation_id);
+    }
+    openRental(Policy::ROLE, this->user_id, vehicle_slot, current_time, deadline);
+    logRental(Policy::ROLE, this->user_id, vehicle_id, current_time, deadline, charge);
+    versionRentalOpened(Policy::ROLE, this->user_id, this->outstanding_dues, vehicle_slot, deadline);
+    return timer.finish(OperationStatus::Success);
+}
+
+template <typename Policy>
+OperationStatus Renter<Policy>::returnVehicle(int vehicle_id, int& penalty) {
+    OperationTimer timer(MetricOp::Return);
+    penalty = 0;
+    lock_guard<mutex> guard(renterLock(Policy::ROLE, this->user_id));
+    int slot = findHeldRental(Policy::ROLE, this->user_id, vehicle_id);
+    if (slot == -1) {
+        return timer.finish(OperationStatus::NotInRentals);
+    }
+    
+    auto current_time = time(0);
+    time_t deadline = rental_table[slot].deadline;
+    Rating rating_deduction = 0;
+    if (current_time > deadline) {
+        // Days already charged by the nightly accrual are not charged again
+        int vehicle_slot = findVehicleSlot(vehicle_id);
+        int daily_rent = vehicle_inventory.daily_rent[vehicle_slot];
+        int64_t accrued = vehicle_inventory.accrued_days[vehicle_slot];
+        int64_t days_late = max<int64_t>((current_time - deadline) / SECONDS_PER_DAY, accrued);
+        penalty = lateFeeForDays<Policy>(daily_rent, days_late) - lateFeeForDays<Policy>(daily_rent, accrued);
+        rating_deduction = Policy::RATING_LOSS_PER_DAY * (days_late - accrued);
+        vehicle_inventory.addRevenue(vehicle_slot, penalty);
+        this->outstanding_dues += penalty;
+        this->rating -= rating_deduction;
+    }
+    
+    // Log before the vehicle is released so its next rental is logged after this return
+    logReturn(Policy::ROLE, this->user_id, vehicle_id, penalty, rating_deduction);
+    versionRentalClosed(Policy::ROLE, this->user_id, this->outstanding_dues, this->rating, findVehicleSlot(vehicle_id));
+    closeRental(slot);
+    return timer.finish(OperationStatus::Success);
+}
+
+template <typename Policy>
+OperationStatus Renter<Policy>::payDues(int payment_amount) {
+    OperationTimer timer(MetricOp::Pay);
+    lock_guard<mutex> guard(renterLock(Policy::ROLE, this->user_id));
+    if (this->outstanding_dues == 0) {
+        return timer.finish(OperationStatus::NoDues);
+    }
+    if (payment_amount <= 0 || payment_amount > this->outstanding_dues) {
+        return timer.finish(OperationStatus::InvalidAmount);
+    }
+    this->outstanding_dues -= payment_amount;
+    logPayment(Policy::ROLE, this->user_id, payment_amount);
+    versionPayment(Policy::ROLE, this->user_id, this->outstanding_dues);
+    return timer.finish(OperationStatus::Success);
+}
+
+template <typename Policy>
+OperationStatus Renter<Policy>::reserveVehicle(int vehicle_id, time_t start, time_t end, int& reservation_id) {
+    OperationTimer timer(MetricOp::Reserve);
+    reservation_id = 0;
+    time_t current_time = time(0);
+    if (start >= end || end <= current_time) {
+        return timer.finish(OperationStatus::InvalidRequest);
+    }
+    int vehicle_slot = findVehicleSlot(vehicle_id);
+    if (vehicle_slot == -1) {
+        return timer.finish(OperationStatus::VehicleNotFound);
+    }
+    
+    Reservation reservation{0, vehicle_id, this->user_id, Policy::ROLE, start, end};
+    lock_guard<mutex> guard(calendarLock(vehicle_id));
+    OperationStatus status = bookVehicle(vehicle_slot, reservation, current_time);
+    if (status == OperationStatus::Success) {
+        reservation_id = reservation.reservation_id;
+        logReservation(reservation);
+    }
+    return timer.finish(status);
+}
+
+template <typename Policy>
+OperationStatus Renter<Policy>::cancelReservation(int reservation_id) {
+    OperationTimer timer(MetricOp::Reserve);
+    int vehicle_id = reservationVehicle(reservation_id);
+    if (vehicle_id == 0) {
+        return timer.finish(OperationStatus::ReservationNotFound);
+    }
+    lock_guard<mutex> guard(calendarLock(vehicle_id));
+    RenterRole role = Policy::ROLE;
+    if (!releaseReservation(vehicle_id, reservation_id, &role, this->user_id)) {
+        return timer.finish(OperationStatus::ReservationNotFound);
+    }
+    logReservationReleased(vehicle_id, reservation_id);
+    return timer.finish(OperationStatus::Success);
+}
+
+// Ask for a first day and a number of days; the period runs from midnight to midnight
+bool promptPeriod(time_t& start, time_t& end) {
+    cout << "Enter start date (DD/MM/YYYY): ";
+    string date_str;
+    cin >> date_str;
+    cout << "Enter number of days: ";
+    string days_str;
+    cin >> days_str;
+    int days = convertStringToInt(days_str);
+    if (!parseDate(date_str, start) || days <= 0 || days > MAX_RESERVATION_DAYS) {
+        return false;
+    }
+    end = start + int64_t(days) * SECONDS_PER_DAY;
+    return true;
+}
+
+template <typename Policy>
+void Renter<Policy>::reserveVehicle() {
+    cout << "Enter the vehicle ID you wish to reserve: ";
+    string vehicle_str;
+    cin >> vehicle_str;
+    time_t start, end;
+    if (!promptPeriod(start, end)) {
+        cout << "Invalid dates\n\n\n";
+        return;
+    }
+    
+    int reservation_id = 0;
+    OperationStatus status = reserveVehicle(convertStringToInt(vehicle_str), start, end, reservation_id);
+    commitTransactions();
+    switch (status) {
+        case OperationStatus::Success: cout << "Vehicle reserved, reservation ID: " << reservation_id << "\n\n\n"; break;
+        case OperationStatus::AlreadyRented: cout << "Vehicle is rented out on those dates\n\n\n"; break;
+        case OperationStatus::Reserved: cout << "Vehicle is already reserved on those dates\n\n\n"; break;
+        case OperationStatus::InvalidRequest: cout << "Invalid dates\n\n\n"; break;
+        default: cout << "Vehicle with specified ID not found\n\n\n"; break;
+    }
+}
+
+template <typename Policy>
+void Renter<Policy>::cancelReservation() {
+    cout << "Enter the reservation ID to cancel: ";
+    string reservation_str;
+    cin >> reservation_str;
+    if (cancelReservation(convertStringToInt(reservation_str)) != OperationStatus::Success) {
+        cout << "Reservation not found\n\n\n";
+        return;
+    }
+    commitTransactions();
+    cout << "Reservation cancelled\n\n\n";
+}
+
+template <typename Policy>
+void Renter<Policy>::findFreeVehicles() {
+    time_t start, end;
+    if (!promptPeriod(start, end)) {
+        cout << "Invalid dates\n\n\n";
+        return;
+    }
+    FleetFilter filter;
+    promptFleetFilter(filter);
+    SelectionBitmap selection;
+    selectFreeVehicles(filter, start, end, selection);
+    showSelectedVehicles(selection);
+}
+
+template <typename Policy>
+void Renter<Policy>::rentVehicle() {
+    cout << "Enter the vehicle ID you wish to rent: ";
+    string vehicle_str;
+    cin >> vehicle_str;
+    
+    int charge = 0;
+    OperationStatus status = rentVehicle(convertStringToInt(vehicle_str), charge);
+    commitTransactions();
+    switch (status) {
+        case OperationStatus::Success: cout << Policy::RENTED_MESSAGE; break;
+        case OperationStatus::AlreadyRented: cout << "Vehicle is currently rented out\n"; break;
+        case OperationStatus::Reserved: cout << "Vehicle is reserved by another renter\n"; break;
+        default: cout << "Vehicle with specified ID not found\n\n\n"; break;
+    }
+}
+
+template <typename Policy>
+void Renter<Policy>::returnVehicle() {
+    cout << "Enter the vehicle ID you wish to return: ";
+    string vehicle_str;
+    cin >> vehicle_str;
+    
+    int penalty = 0;
+    if (returnVehicle(convertStringToInt(vehicle_str), penalty) != OperationStatus::Success) {
+        cout << "Vehicle not found in your rentals\n";
+        return;
+    }
+    commitTransactions();
+    if (penalty > 0) {
+        cout << "Late return penalty applied: " << penalty << "\n";
+    }
+    cout << "Vehicle returned successfully\n\n\n";
+}
+
+template <typename Policy>
+void Renter<Policy>::showRentedVehicles() {
+    showRenterVehicles(Policy::ROLE, this->user_id);
+}
+
+template <typename Policy>
+void Renter<Policy>::checkOutstandingDues() {
+    cout << "Your current outstanding balance: " << this->outstanding_dues << "\n\n\n";
+}
+
+template <typename Policy>
+void Renter<Policy>::payDues() {
+    if (this->outstanding_dues == 0) {
+        cout << "No outstanding dues to pay\n\n\n";
+        return;
+    }
+    
+    cout << "Current outstanding balance: " << this->outstanding_dues << endl;
+    cout << "Enter payment amount: ";
+    string amount_str;
+    cin >> amount_str;
+    
+    if (payDues(convertStringToInt(amount_str)) == OperationStatus::Success) {
+        commitTransactions();
+        cout << "Payment processed successfully\n";
+        cout << "Remaining balance: " << this->outstanding_dues << "\n\n\n";
+    } else {
+        cout << "Invalid payment amount\n";
+    }
+}
+
+template <typename Policy>
+void Renter<Policy>::accessPortal() {
+    bool session_active = true;
+    cout << "Welcome, " << this->username << endl;
+    
+    while (session_active) {
+        cout << "Select an option:\n";
+        cout << "1. View all vehicles\n2. View your rentals\n3. Rent a vehicle\n"
+             << "4. Return a vehicle\n5. Check dues\n6. Pay dues\n7. Search vehicles\n"
+             << "8. Reserve a vehicle\n9. Cancel a reservation\na. Find vehicles free for dates\n0. Logout\n"
+             << "Enter your choice: ";
+        
+        char user_choice;
+        cin >> user_choice;
+        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        
+        switch (user_choice) {
+            case '1': displayAllVehicles(); break;
+            case '2': showRentedVehicles(); break;
+            case '3': rentVehicle(); break;
+            case '4': returnVehicle(); break;
+            case '5': checkOutstandingDues(); break;
+            case '6': payDues(); break;
+            case '7': searchVehicles(); break;
+            case '8': reserveVehicle(); break;
+            case '9': cancelReservation(); break;
+            case 'a': findFreeVehicles(); break;
+            case '0': session_active = false; break;
+            default: cout << "Invalid selection\n"; break;
+        }
+    }
+}
+
+//======================= CUSTOMER CLASS =======================//
+
+using Client = Renter<ClientPolicy>;
+
+vector<Client> client_database;
+vector<int> client_slot_by_id;
+size_t dead_client_rows = 0;  // tombstoned rows awaiting compaction
+
+Client* findClient(int client_id) {
+    return findUser(client_slot_by_id, client_database, client_id);
+}
+
+Client* findClientByName(const string& name) {
+    return findClient(findAccountId(name, &AccountIndexEntry::client_id));
+}
+
+// Register a client in the database and the username index.
+// Returns false without adding anything when the name is already taken.
+bool addClient(const Client& client) {
+    if (findAccountId(client.username, &AccountIndexEntry::client_id) != 0) {
+        return false;
+    }
+    client_database.push_back(client);
+    reindexUsers(client_slot_by_id, client_database, client_database.size() - 1);
+    indexAccountName(client.username, &AccountIndexEntry::client_id, client.user_id);
+    versionAccountEdit(RenterRole::Client, client.user_id, client.outstanding_dues, client.rating);
+    return true;
+}
+
+void compactClients() {
+    compactUsers(client_slot_by_id, client_database, dead_client_rows);
+}
+
+// Drop the client at the given slot from the ID table and username index;
+// the row itself is tombstoned and reclaimed by the next compaction
+void eraseClient(size_t slot) {
+    Client& client = client_database[slot];
+    unindexAccountName(client.username, &AccountIndexEntry::client_id);
+    versionAccountRemoved(RenterRole::Client, client.user_id);
+    tombstoneUser(client_slot_by_id, client_database, slot, dead_client_rows);
+    if (dead_client_rows * 2 > client_database.size()) {
+        compactClients();
+    }
+}
+
+// Change a client's username, moving its index entry. Fails if the name is taken.
+bool renameClient(Client& client, const string& new_name) {
+    int owner_id = findAccountId(new_name, &AccountIndexEntry::client_id);
+    if (owner_id != 0 && owner_id != client.user_id) {
+        return false;
+    }
+    unindexAccountName(client.username, &AccountIndexEntry::client_id);
+    client.username = new_name;
+    indexAccountName(client.username, &AccountIndexEntry::client_id, client.user_id);
+    logAccountField(RenterRole::Client, client.user_id, AccountField::Name, 0, 0, new_name);
+    return true;
+}
+
+void handleClientLogin() {
+    bool login_session = true;
+    
+    while (login_session) {
+        cout << "Client Portal Options:\n";
+        cout << "1. Login\n2. Register\n0. Exit\nEnter your choice: ";
+        char choice;
+        cin >> choice;
+        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        
+        switch (choice) {
+            case '1': {
+                cout << "Enter your username:\n";
+                string name;
+                getline(cin, name);
+                cout << "Enter your password:\n";
+                string password;
+                cin >> password;
+                
+                OperationTimer timer(MetricOp::Login);
+                Client* client = findClientByName(name);
+                bool authenticated = client != nullptr && client->validatePassword(password);
+                timer.finish(authenticated ? OperationStatus::Success : OperationStatus::AuthenticationFailed);
+                if (authenticated) {
+                    client->accessPortal();
+                } else {
+                    cout << "Authentication failed: Invalid credentials\n";
+                }
+                break;
+            }
+            case '2': {
+                cout << "Enter desired username:\n";
+                string name;
+                getline(cin, name);
+                cout << "Enter password:\n";
+                string password;
+                cin >> password;
+                cout << "Confirm password:\n";
+                string confirm_password;
+                cin >> confirm_password;
+                
+                if (password != confirm_password) {
+                    cout << "Registration failed: Passwords do not match\n";
+                    break;
+                }
+                
+                if (findClientByName(name) != nullptr) {
+                    cout << "Registration failed: Username already exists\n";
+                    break;
+                }
+                
+                Client new_client(name, password);
+                addClient(new_client);
+                logAccountAdded(RenterRole::Client, new_client.user_id, name, password);
+                commitTransactions();
+                cout << "Registration successful\nPlease login to access your account\n\n\n";
+                break;
+            }
+            case '0': login_session = false; break;
+            default: cout << "Invalid selection\n"; break;
+        }
+    }
+}
+
+//======================= EMPLOYEE CLASS =======================//
+
+using StaffMember = Renter<StaffPolicy>;
+
+vector<StaffMember> staff_database;
+vector<int> staff_slot_by_id;
+size_t dead_staff_rows = 0;  // tombstoned rows awaiting compaction
+
+StaffMember* findStaff(int staff_id) {
+    return findUser(staff_slot_by_id, staff_database, staff_id);
+}
+
+StaffMember* findStaffByName(const string& name) {
+    return findStaff(findAccountId(name, &AccountIndexEntry::staff_id));
+}
+
+// Register a staff member in the database and the username index.
+// Returns false without adding anything when the name is already taken.
+bool addStaff(const StaffMember& staff) {
+    if (findAccountId(staff.username, &AccountIndexEntry::staff_id) != 0) {
+        return false;
+    }
+    staff_database.push_back(staff);
+    reindexUsers(staff_slot_by_id, staff_database, staff_database.size() - 1);
+    indexAccountName(staff.username, &AccountIndexEntry::staff_id, staff.user_id);
+    versionAccountEdit(RenterRole::Staff, staff.user_id, staff.outstanding_dues, staff.rating);
+    return true;
+}
+
+void compactStaff() {
+    compactUsers(staff_slot_by_id, staff_database, dead_staff_rows);
+}
+
+// Drop the staff member at the given slot from the ID table and username index;
+// the row itself is tombstoned and reclaimed by the next compaction
+void eraseStaff(size_t slot) {
+    StaffMember& staff = staff_database[slot];
+    unindexAccountName(staff.username, &AccountIndexEntry::staff_id);
+    versionAccountRemoved(RenterRole::Staff, staff.user_id);
+    tombstoneUser(staff_slot_by_id, staff_database, slot, dead_staff_rows);
+    if (dead_staff_rows * 2 > staff_database.size()) {
+        compactStaff();
+    }
+}
+
+// Change a staff member's username, moving its index entry. Fails if the name is taken.
+bool renameStaff(StaffMember& staff, const string& new_name) {
+    int owner_id = findAccountId(new_name, &AccountIndexEntry::staff_id);
+    if (owner_id != 0 && owner_id != staff.user_id) {
+        return false;
+    }
+    unindexAccountName(staff.username, &AccountIndexEntry::staff_id);
+    staff.username = new_name;
+    indexAccountName(staff.username, &AccountIndexEntry::staff_id, staff.user_id);
+    logAccountField(RenterRole::Staff, staff.user_id, AccountField::Name, 0, 0, new_name);
+    return true;
+}
+
+const string& accountName(const AccountIndexEntry& entry) {
+    if (entry.client_id != 0) {
+        return findClient(entry.client_id)->username;
+    }
+    return findStaff(entry.staff_id)->username;
+}
+
+void handleStaffLogin() {
+    bool login_session = true;
+    
+    while (login_session) {
+        cout << "Staff Portal Options:\n";
+        cout << "1. Login\n0. Exit\nEnter your choice: ";
+        char choice;
+        cin >> choice;
+        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        
+        switch (choice) {
+            case '1': {
+                cout << "Enter your username:\n";
+                string name;
+                getline(cin, name);
+                cout << "Enter your password:\n";
+                string password;
+                cin >> password;
+                
+                OperationTimer timer(MetricOp::Login);
+                StaffMember* staff = findStaffByName(name);
+                bool authenticated = staff != nullptr && staff->validatePassword(password);
+                timer.finish(authenticated ? OperationStatus::Success : OperationStatus::AuthenticationFailed);
+                if (authenticated) {
+                    staff->accessPortal();
+                } else {
+                    cout << "Authentication failed: Invalid credentials\n";
+                }
+                break;
+            }
+            case '0': login_session = false; break;
+            default: cout << "Invalid selection\n"; break;
+        }
+    }
+}
+
+//======================= RENTAL ENGINE =======================//
+
+// Typed requests for the headless engine. The portals and batch mode both go
+// through these, so every operation has one implementation and one log format.
+struct AccountRef {
+    RenterRole role;
+    int user_id;
+};
+
+struct RentalRequest {
+    RenterRole role;
+    int renter_id;
+    int vehicle_id;
+};
+
+struct ReservationRequest {
+    RenterRole role;
+    int renter_id;
+    int vehicle_id;
+    time_t start;
+    time_t end;
+};
+
+struct PaymentRequest {
+    RenterRole role;
+    int renter_id;
+    int amount;
+};
+
+struct Credentials {
+    RenterRole role;
+    string username;
+    string password;
+};
+
+struct VehicleSpec {
+    string brand;
+    string model;
+    int rent;
+    int price;
+    int seats;
+    string color;
+};
+
+struct VehicleUpdate {
+    int vehicle_id;
+    VehicleField field;
+    int number;     // rent, price, seats or condition
+    string text;    // brand, model or color
+};
+
+struct AccountUpdate {
+    AccountRef account;
+    AccountField field;
+    double number;  // dues or rating
+    string text;    // name or password
+};
+
+// value carries the operation's result: charge for rent, penalty for return,
+// remaining dues for pay/dues, and the new or authenticated ID for add/login/reserve
+struct EngineResult {
+    OperationStatus status;
+    int64_t value;
+};
+
+// Business operations without any prompts. Each call validates, applies and
+// logs one change; callers decide when to commit the log. rent, returnVehicle,
+// pay, dues, reserve and cancelReservation may run on many threads at once after
+// prepareConcurrentRentals();
+// the other operations change table structure and need exclusive access.
+class RentalEngine {
+public:
+    EngineResult rent(const RentalRequest& request);
+    EngineResult returnVehicle(const RentalRequest& request);
+    EngineResult pay(const PaymentRequest& request);
+    EngineResult dues(const AccountRef& account);
+    EngineResult reserve(const ReservationRequest& request);
+    EngineResult cancelReservation(const AccountRef& account, int reservation_id);
+    EngineResult login(const Credentials& credentials);
+    EngineResult addAccount(const Credentials& credentials);
+    EngineResult updateAccount(const AccountUpdate& update);
+    EngineResult removeAccount(const AccountRef& account);
+    EngineResult addVehicle(const VehicleSpec& spec);
+    EngineResult updateVehicle(const VehicleUpdate& update);
+    EngineResult setVehicleStatus(int vehicle_id, bool rented);
+    EngineResult removeVehicle(int vehicle_id);
+    EngineResult accrueLateFees(time_t now);
+
+private:
+    // Run action on the client or staff member an account reference points at
+    template <typename Action>
+    EngineResult withAccount(RenterRole role, int user_id, Action action) {
+        if (role == RenterRole::Client) {
+            Client* client = findClient(user_id);
+            return client ? action(*client) : EngineResult{OperationStatus::AccountNotFound, 0};
+        }
+        StaffMember* staff = findStaff(user_id);
+        return staff ? action(*staff) : EngineResult{OperationStatus::AccountNotFound, 0};
+    }
+};
+
+RentalEngine rental_engine;
+
+// Bring the versioned tables in line with the live ones after a load, replay or
+// compaction. Rows that already match are left alone, so a page is only copied
+// when it really changed. Needs exclusive access.
+void syncVersionedTables() {
+    {
+        VersionWriter versions;
+        uint64_t epoch = versions.writeEpoch();
+        const FleetStore& fleet = vehicle_inventory;
+        fleet_versions.resize(fleet.size(), epoch);
+        client_versions.resize(max<size_t>(client_versions.size(), BaseUser::customer_count + 1), epoch);
+        staff_versions.resize(max<size_t>(staff_versions.size(), BaseUser::employee_count + 1), epoch);
+        
+        auto store = [epoch](auto& table, size_t index, const auto& row) {
+            if (!(table.read(index, EpochDomain::IDLE) == row)) {
+                table.write(index, epoch) = row;
+            }
+        };
+        // Rentals are numbered in each renter's list order
+        vector<uint32_t> sequence(rental_table.size());
+        auto syncAccounts = [&](RenterRole role, const auto& database) {
+            VersionedRows<AccountVersion>& table = accountVersions(role);
+            vector<bool> present(table.size());
+            for (const auto& user : database) {
+                if (user.user_id == 0) {
+                    continue;
+                }
+                AccountVersion row{user.outstanding_dues, 0, 0, double(user.rating)};
+                for (int slot = firstRental(role, user.user_id); slot != -1; slot = rental_table[slot].next_by_renter) {
+                    sequence[slot] = ++row.rentals_opened;
+                    ++row.vehicles_held;
+                }
+                present[user.user_id] = true;
+                store(table, user.user_id, row);
+            }
+            for (size_t user_id = 0; user_id < table.size(); ++user_id) {
+                if (!present[user_id]) {
+                    store(table, user_id, AccountVersion{});
+                }
+            }
+        };
+        syncAccounts(RenterRole::Client, client_database);
+        syncAccounts(RenterRole::Staff, staff_database);
+        
+        for (size_t slot = 0; slot < fleet.size(); ++slot) {
+            VehicleVersion row{fleet.vehicle_id[slot], fleet.is_rented[slot] != 0, RenterRole::Client, 0, 0, 
+                               fleet.return_deadline[slot], fleet.revenue[slot]};
+            int rental_slot = findRentalByVehicle(row.vehicle_id);
+            if (rental_slot != -1) {
+                row.holder_role = rental_table[rental_slot].renter_role;
+                row.holder_id = rental_table[rental_slot].renter_id;
+                row.holder_sequence = sequence[rental_slot];
+            }
+            store(fleet_versions, slot, row);
+        }
+    }
+    versioned_tables_stale = false;
+    table_epochs.collect();
+}
+
+void ensureVersionedTables() {
+    if (versioned_tables_stale) {
+        syncVersionedTables();
+    }
+}
+
+// Size every rental index up front so worker threads never resize them
+void prepareConcurrentRentals() {
+    rental_slot_by_vehicle.resize(max<size_t>(rental_slot_by_vehicle.size(), Vehicle::vehicle_counter + 1), -1);
+    client_rentals.resize(max<size_t>(client_rentals.size(), BaseUser::customer_count + 1));
+    staff_rentals.resize(max<size_t>(staff_rentals.size(), BaseUser::employee_count + 1));
+    vehicle_calendars.resize(max<size_t>(vehicle_calendars.size(), Vehicle::vehicle_counter + 1));
+    // At most one open rental per vehicle, so the table never outgrows this
+    rental_table.reserve(vehicle_inventory.size());
+    // Searches running alongside the renters must not be the ones to build the indexes
+    if (!vehicle_inventory.indexes.ready) {
+        vehicle_inventory.buildIndexes();
+    }
+    // Listings and reports alongside the renters read snapshots of these
+    ensureVersionedTables();
+}
+
+EngineResult RentalEngine::rent(const RentalRequest& request) {
+    return withAccount(request.role, request.renter_id, [&](auto& renter) {
+        int charge = 0;
+        OperationStatus status = renter.rentVehicle(request.vehicle_id, charge);
+        return EngineResult{status, charge};
+    });
+}
+
+EngineResult RentalEngine::returnVehicle(const RentalRequest& request) {
+    return withAccount(request.role, request.renter_id, [&](auto& renter) {
+        int penalty = 0;
+        OperationStatus status = renter.returnVehicle(request.vehicle_id, penalty);
+        return EngineResult{status, penalty};
+    });
+}
+
+EngineResult RentalEngine::pay(const PaymentRequest& request) {
+    return withAccount(request.role, request.renter_id, [&](auto& renter) {
+        OperationStatus status = renter.payDues(request.amount);
+        lock_guard<mutex> guard(renterLock(request.role, request.renter_id));
+        return EngineResult{status, renter.outstanding_dues};
+    });
+}
+
+EngineResult RentalEngine::dues(const AccountRef& account) {
+    return withAccount(account.role, account.user_id, [&](auto& renter) {
+        lock_guard<mutex> guard(renterLock(account.role, account.user_id));
+        return EngineResult{OperationStatus::Success, renter.outstanding_dues};
+    });
+}
+
+EngineResult RentalEngine::reserve(const ReservationRequest& request) {
+    return withAccount(request.role, request.renter_id, [&](auto& renter) {
+        int reservation_id = 0;
+        OperationStatus status = renter.reserveVehicle(request.vehicle_id, request.start, request.end, reservation_id);
+        return EngineResult{status, reservation_id};
+    });
+}
+
+EngineResult RentalEngine::cancelReservation(const AccountRef& account, int reservation_id) {
+    return withAccount(account.role, account.user_id, [&](auto& renter) {
+        return EngineResult{renter.cancelReservation(reservation_id), reservation_id};
+    });
+}
+
+EngineResult RentalEngine::login(const Credentials& credentials) {
+    OperationTimer timer(MetricOp::Login);
+    BaseUser* user = nullptr;
+    if (credentials.role == RenterRole::Client) {
+        user = findClientByName(credentials.username);
+    } else {
+        user = findStaffByName(credentials.username);
+    }
+    if (user == nullptr || !user->validatePassword(credentials.password)) {
+        return timer.finish(EngineResult{OperationStatus::AuthenticationFailed, 0});
+    }
+    return timer.finish(EngineResult{OperationStatus::Success, user->user_id});
+}
+
+EngineResult RentalEngine::addAccount(const Credentials& credentials) {
+    OperationTimer timer(MetricOp::AdminAdd);
+    if (credentials.role == RenterRole::Client) {
+        if (findClientByName(credentials.username) != nullptr) {
+            return timer.finish(EngineResult{OperationStatus::NameTaken, 0});
+        }
+        Client new_client(credentials.username, credentials.password);
+        addClient(new_client);
+        logAccountAdded(RenterRole::Client, new_client.user_id, credentials.username, credentials.password);
+        return timer.finish(EngineResult{OperationStatus::Success, new_client.user_id});
+    }
+    if (findStaffByName(credentials.username) != nullptr) {
+        return timer.finish(EngineResult{OperationStatus::NameTaken, 0});
+    }
+    StaffMember new_staff(credentials.username, credentials.password);
+    addStaff(new_staff);
+    logAccountAdded(RenterRole::Staff, new_staff.user_id, credentials.username, credentials.password);
+    return timer.finish(EngineResult{OperationStatus::Success, new_staff.user_id});
+}
+
+EngineResult RentalEngine::updateAccount(const AccountUpdate& update) {
+    OperationTimer timer(MetricOp::AdminModify);
+    RenterRole role = update.account.role;
+    if (role == RenterRole::Client) {
+        Client* client = findClient(update.account.user_id);
+        if (client == nullptr) {
+            return timer.finish(EngineResult{OperationStatus::AccountNotFound, 0});
+        }
+        switch (update.field) {
+            case AccountField::Name:
+                return timer.finish(EngineResult{
+                    renameClient(*client, update.text) ? OperationStatus::Success : OperationStatus::NameTaken, 0});
+            case AccountField::Password:
+                client->user_password = update.text;
+                logAccountField(role, client->user_id, AccountField::Password, 0, 0, client->user_password);
+                break;
+            case AccountField::Dues:
+                client->outstanding_dues = int(update.number);
+                logAccountField(role, client->user_id, AccountField::Dues, client->outstanding_dues);
+                break;
+            case AccountField::Rating:
+                client->rating = int(update.number);
+                logAccountField(role, client->user_id, AccountField::Rating, client->rating);
+                break;
+            default:
+                return timer.finish(EngineResult{OperationStatus::InvalidRequest, 0});
+        }
+        if (update.field == AccountField::Dues || update.field == AccountField::Rating) {
+            versionAccountEdit(role, client->user_id, client->outstanding_dues, client->rating);
+        }
+        return timer.finish(EngineResult{OperationStatus::Success, 0});
+    }
+    
+    StaffMember* staff = findStaff(update.account.user_id);
+    if (staff == nullptr) {
+        return timer.finish(EngineResult{OperationStatus::AccountNotFound, 0});
+    }
+    switch (update.field) {
+        case AccountField::Name:
+            return timer.finish(EngineResult{
+                renameStaff(*staff, update.text) ? OperationStatus::Success : OperationStatus::NameTaken, 0});
+        case AccountField::Password:
+            staff->user_password = update.text;
+            logAccountField(role, staff->user_id, AccountField::Password, 0, 0, staff->user_password);
+            break;
+        case AccountField::Dues:
+            staff->outstanding_dues = int(update.number);
+            logAccountField(role, staff->user_id, AccountField::Dues, staff->outstanding_dues);
+            break;
+        case AccountField::Rating:
+            staff->rating = update.number;
+            logAccountField(role, staff->user_id, AccountField::Rating, 0, staff->rating);
+            break;
+        default:
+            return timer.finish(EngineResult{OperationStatus::InvalidRequest, 0});
+    }
+    if (update.field == AccountField::Dues || update.field == AccountField::Rating) {
+        versionAccountEdit(role, staff->user_id, staff->outstanding_dues, staff->rating);
+    }
+    return timer.finish(EngineResult{OperationStatus::Success, 0});
+}
+
+EngineResult RentalEngine::removeAccount(const AccountRef& account) {
+    OperationTimer timer(MetricOp::AdminRemove);
+    return timer.finish(withAccount(account.role, account.user_id, [&](auto& user) {
+        if (user.outstanding_dues > 0) {
+            return EngineResult{OperationStatus::HasDues, 0};
+        }
+        if (firstRental(account.role, account.user_id) != -1) {
+            return EngineResult{OperationStatus::HasRentals, 0};
+        }
+        if (account.role == RenterRole::Client) {
+            eraseClient(findClient(account.user_id) - client_database.data());
+        } else {
+            eraseStaff(findStaff(account.user_id) - staff_database.data());
+        }
+        logAccountRemoved(account.role, account.user_id);
+        return EngineResult{OperationStatus::Success, 0};
+    }));
+}
+
+EngineResult RentalEngine::addVehicle(const VehicleSpec& spec) {
+    OperationTimer timer(MetricOp::AdminAdd);
+    Vehicle new_vehicle(spec.brand, spec.model, spec.rent, spec.price, spec.seats, spec.color);
+    ::addVehicle(new_vehicle);
+    logVehicleAdded(new_vehicle.vehicle_id, new_vehicle);
+    return timer.finish(EngineResult{OperationStatus::Success, new_vehicle.vehicle_id});
+}
+
+EngineResult RentalEngine::updateVehicle(const VehicleUpdate& update) {
+    OperationTimer timer(MetricOp::AdminModify);
+    int slot = findVehicleSlot(update.vehicle_id);
+    if (slot == -1) {
+        return timer.finish(EngineResult{OperationStatus::VehicleNotFound, 0});
+    }
+    FleetStore& fleet = vehicle_inventory;
+    switch (update.field) {
+        case VehicleField::Brand: fleet.setBrand(slot, update.text); break;
+        case VehicleField::Model: fleet.setModel(slot, update.text); break;
+        case VehicleField::Color: fleet.setColor(slot, update.text); break;
+        case VehicleField::Rent: fleet.setRent(slot, update.number); break;
+        case VehicleField::Price: fleet.market_price[slot] = update.number; break;
+        case VehicleField::Seats: fleet.setSeats(slot, update.number); break;
+        case VehicleField::Condition: fleet.setCondition(slot, update.number); break;
+        default: return timer.finish(EngineResult{OperationStatus::InvalidRequest, 0});
+    }
+    fleet.touch(slot);
+    logVehicleField(update.vehicle_id, update.field, update.number, update.text);
+    return timer.finish(EngineResult{OperationStatus::Success, 0});
+}
+
+EngineResult RentalEngine::setVehicleStatus(int vehicle_id, bool rented) {
+    OperationTimer timer(MetricOp::AdminModify);
+    int slot = findVehicleSlot(vehicle_id);
+    if (slot == -1) {
+        return timer.finish(EngineResult{OperationStatus::VehicleNotFound, 0});
+    }
+    setVehicleRentedStatus(slot, rented);
+    logVehicleStatus(vehicle_id, rented);
+    return timer.finish(EngineResult{OperationStatus::Success, 0});
+}
+
+EngineResult RentalEngine::removeVehicle(int vehicle_id) {
+    OperationTimer timer(MetricOp::AdminRemove);
+    int slot = findVehicleSlot(vehicle_id);
+    if (slot == -1) {
+        return timer.finish(EngineResult{OperationStatus::VehicleNotFound, 0});
+    }
+    if (vehicle_inventory.is_rented[slot]) {
+        return timer.finish(EngineResult{OperationStatus::VehicleInUse, 0});
+    }
+    logVehicleRemoved(vehicle_id);
+    eraseVehicle(slot);
+    dropReservations(vehicle_id);
+    return timer.finish(EngineResult{OperationStatus::Success, 0});
+}
+
+// Nightly late fee run: charge every open rental for the whole days it has
+// run past its deadline since it was last charged, and remember the new total
+// so a second run in the same period charges nothing. value is the number of
+// rentals charged. Charges for different vehicles run in parallel; renters
+// holding several overdue vehicles are serialized by their lock stripe. Needs
+// exclusive access like the other admin operations.
+EngineResult RentalEngine::accrueLateFees(time_t now) {
+    FleetStore& fleet = vehicle_inventory;
+    SelectionBitmap selection;
+    selectAccruableRentals(fleetAccrualColumns(), now, selection);
+    vector<uint32_t> due_slots;
+    forEachSelected(selection, [&due_slots](size_t slot) { due_slots.push_back((uint32_t)slot); });
+    
+    atomic<int64_t> charged{0};
+    parallelFor(due_slots.size(), workerCount(), [&](size_t begin, size_t end) {
+        int64_t local_charged = 0;
+        for (size_t i = begin; i < end; ++i) {
+            size_t vehicle_slot = due_slots[i];
+            int vehicle_id = fleet.vehicle_id[vehicle_slot];
+            int rental_slot = findRentalByVehicle(vehicle_id);
+            if (rental_slot == -1) {
+                continue;  // flagged rented by the admin without a rental behind it
+            }
+            const Rental& rental = rental_table[rental_slot];
+            EngineResult result = withAccount(rental.renter_role, rental.renter_id, [&](auto& renter) {
+                using Policy = typename remove_reference_t<decltype(renter)>::PolicyType;
+                using Rating = typename Policy::Rating;
+                int daily_rent = fleet.daily_rent[vehicle_slot];
+                int64_t accrued = fleet.accrued_days[vehicle_slot];
+                int64_t days_late = (now - rental.deadline) / SECONDS_PER_DAY;
+                int fee = lateFeeForDays<Policy>(daily_rent, days_late) - lateFeeForDays<Policy>(daily_rent, accrued);
+                Rating rating_deduction = Rating(Policy::RATING_LOSS_PER_DAY * (days_late - accrued));
+                fleet.accrued_days[vehicle_slot] = (int32_t)days_late;
+                fleet.addRevenue(vehicle_slot, fee);
+                {
+                    lock_guard<mutex> guard(renterLock(Policy::ROLE, rental.renter_id));
+                    renter.outstanding_dues += fee;
+                    renter.rating -= rating_deduction;
+                    versionLateFee(Policy::ROLE, rental.renter_id, renter.outstanding_dues, double(renter.rating), 
+                                   (int)vehicle_slot);
+                }
+                logLateFee(Policy::ROLE, rental.renter_id, vehicle_id, fee, (int)days_late, rating_deduction);
+                return EngineResult{OperationStatus::Success, fee};
+            });
+            local_charged += result.status == OperationStatus::Success;
+        }
+        charged += local_charged;
+    });
+    return EngineResult{OperationStatus::Success, charged.load()};
+}
+
+// Run the accrual at most once per day period; called from the interactive loop
+int64_t last_accrual_period = -1;
+
+void accrueLateFeesIfDue(time_t now) {
+    int64_t period = now / SECONDS_PER_DAY;
+    if (period == last_accrual_period) {
+        return;
+    }
+    last_accrual_period = period;
+    if (rental_engine.accrueLateFees(now).value > 0) {
+        commitTransactions();
+    }
+}
+
+//======================= ADMINISTRATOR CLASS =======================//
+
+class Administrator : public BaseUser {
+public:
+    void accessAdminPortal();
+    void addNewVehicle();
+    void modifyVehicle();
+    void removeVehicle();
+    void viewAllClients();
+    void addNewClient();
+    void modifyClient();
+    void removeClient();
+    void viewAllStaff();
+    void addNewStaff();
+    void modifyStaff();
+    void removeStaff();
+    void viewOverdueRentals();
+    void saveOperationMetrics();
+    void importRecords();
+    void showReports();
+};
+
+Administrator system_admin;
+
+void Administrator::addNewVehicle() {
+    VehicleSpec spec;
+    cout << "Enter vehicle brand: ";
+    cin >> spec.brand;
+    cout << "Enter vehicle model: ";
+    cin >> spec.model;
+    cout << "Enter daily rent: ";
+    cin >> spec.rent;
+    cout << "Enter market price: ";
+    cin >> spec.price;
+    cout << "Enter seating capacity: ";
+    cin >> spec.seats;
+    cout << "Enter vehicle color: ";
+    cin >> spec.color;
+    
+    rental_engine.addVehicle(spec);
+    commitTransactions();
+    cout << "Vehicle added successfully\n";
+}
+
+void Administrator::addNewClient() {
+    Credentials credentials{RenterRole::Client, "", ""};
+    cout << "Enter client name: ";
+    cin >> credentials.username;
+    cout << "Enter client password: ";
+    cin >> credentials.password;
+    
+    if (rental_engine.addAccount(credentials).status == OperationStatus::NameTaken) {
+        cout << "Username already exists\n";
+        return;
+    }
+    commitTransactions();
+    cout << "Client added successfully\n";
+}
+
+void Administrator::addNewStaff() {
+    Credentials credentials{RenterRole::Staff, "", ""};
+    cout << "Enter staff name: ";
+    cin >> credentials.username;
+    cout << "Enter staff password: ";
+    cin >> credentials.password;
+    
+    if (rental_engine.addAccount(credentials).status == OperationStatus::NameTaken) {
+        cout << "Username already exists\n";
+        return;
+    }
+    commitTransactions();
+    cout << "Staff member added successfully\n";
+}
+
+// Balances and rentals come from one snapshot taken before the first page
+void Administrator::viewAllClients() {
+    compactClients();
+    ensureVersionedTables();
+    TableSnapshot snapshot;
+    vector<HeldVehicle> held = snapshot.heldVehicles(RenterRole::Client);
+    showPaged(client_database.size(), "clients", [](OutputBuffer& out) { out.text("ID\tName\tDues\tRating\n"); }, 
+              [&snapshot, &held](OutputBuffer& out, size_t slot) {
+        const Client& client = client_database[slot];
+        AccountVersion account = snapshot.account(RenterRole::Client, client.user_id);
+        out.number(client.user_id).text("\t").text(client.username).text("\t")
+           .number(account.dues).text("\t").number((long long)account.rating).text("\n");
+        out.text("\tRented Vehicles:\n");
+        listHeldVehicles(out, held, client.user_id);
+    });
+}
+
+void Administrator::viewAllStaff() {
+    compactStaff();
+    ensureVersionedTables();
+    TableSnapshot snapshot;
+    vector<HeldVehicle> held = snapshot.heldVehicles(RenterRole::Staff);
+    showPaged(staff_database.size(), "staff", [](OutputBuffer& out) { out.text("ID\tName\n"); }, 
+              [&held](OutputBuffer& out, size_t slot) {
+        const StaffMember& staff = staff_database[slot];
+        out.number(staff.user_id).text("\t").text(staff.username).text("\n");
+        out.text("\tRented Vehicles:\n");
+        listHeldVehicles(out, held, staff.user_id);
+    });
+}
+
+void Administrator::removeVehicle() {
+    cout << "Enter vehicle ID to remove: ";
+    string vehicle_str;
+    cin >> vehicle_str;
+    
+    switch (rental_engine.removeVehicle(convertStringToInt(vehicle_str)).status) {
+        case OperationStatus::Success:
+            commitTransactions();
+            cout << "Vehicle removed successfully\n";
+            break;
+        case OperationStatus::VehicleInUse: cout << "Cannot remove: Vehicle is currently rented\n"; break;
+        default: cout << "Vehicle not found\n"; break;
+    }
+}
+
+void Administrator::removeClient() {
+    cout << "Enter client ID to remove: ";
+    int client_id;
+    cin >> client_id;
+    
+    switch (rental_engine.removeAccount({RenterRole::Client, client_id}).status) {
+        case OperationStatus::Success:
+            commitTransactions();
+            cout << "Client removed successfully\n";
+            break;
+        case OperationStatus::HasDues: cout << "Cannot remove: Client has outstanding dues\n"; break;
+        case OperationStatus::HasRentals: cout << "Cannot remove: Client has rented vehicles\n"; break;
+        default: cout << "Client not found\n"; break;
+    }
+}
+
+void Administrator::removeStaff() {
+    cout << "Enter staff ID to remove: ";
+    string staff_str;
+    cin >> staff_str;
+    
+    switch (rental_engine.removeAccount({RenterRole::Staff, convertStringToInt(staff_str)}).status) {
+        case OperationStatus::Success:
+            commitTransactions();
+            cout << "Staff removed successfully\n";
+            break;
+        case OperationStatus::HasDues: cout << "Cannot remove: Staff has outstanding dues\n"; break;
+        case OperationStatus::HasRentals: cout << "Cannot remove: Staff has rented vehicles\n"; break;
+        default: cout << "Staff not found\n"; break;
+    }
+}
+
+void Administrator::modifyVehicle() {
+    cout << "Enter vehicle ID to modify: ";
+    string vehicle_str;
+    cin >> vehicle_str;
+    
+    int vehicle_id = convertStringToInt(vehicle_str);
+    if (findVehicleSlot(vehicle_id) == -1) {
+        cout << "Vehicle not found\n";
+        return;
+    }
+    
+    FleetStore& fleet = vehicle_inventory;
+    bool updating = true;
+    while (updating) {
+        cout << "Select field to update:\n";
+        cout << "1. Brand\n2. Model\n3. Rent\n4. Price\n5. Seats\n6. Color\n"
+             << "7. Rental Status\n8. Condition\n0. Finish\nEnter choice: ";
+        
+        char choice;
+        cin >> choice;
+        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        
+        int slot = findVehicleSlot(vehicle_id);
+        VehicleUpdate update{vehicle_id, VehicleField::Brand, 0, ""};
+        switch (choice) {
+            case '1':
+                cout << "Current brand: " << fleet.brand(slot) << "\n";
+                cout << "Enter new brand: ";
+                cin >> update.text;
+                rental_engine.updateVehicle(update);
+                break;
+            case '2':
+                cout << "Current model: " << fleet.model(slot) << "\n";
+                cout << "Enter new model: ";
+                update.field = VehicleField::Model;
+                cin >> update.text;
+                rental_engine.updateVehicle(update);
+                break;
+            case '3':
+                cout << "Current rent: " << fleet.daily_rent[slot] << "\n";
+                cout << "Enter new rent: ";
+                update.field = VehicleField::Rent;
+                cin >> update.number;
+                rental_engine.updateVehicle(update);
+                break;
+            case '4':
+                cout << "Current price: " << fleet.market_price[slot] << "\n";
+                cout << "Enter new price: ";
+                update.field = VehicleField::Price;
+                cin >> update.number;
+                rental_engine.updateVehicle(update);
+                break;
+            case '5':
+                cout << "Current seats: " << fleet.seating_capacity[slot] << "\n";
+                cout << "Enter new seats: ";
+                update.field = VehicleField::Seats;
+                cin >> update.number;
+                rental_engine.updateVehicle(update);
+                break;
+            case '6':
+                cout << "Current color: " << fleet.color(slot) << "\n";
+                cout << "Enter new color: ";
+                update.field = VehicleField::Color;
+                cin >> update.text;
+                rental_engine.updateVehicle(update);
+                break;
+            case '7':
+                cout << "Currently " << (fleet.is_rented[slot] ? "rented" : "not rented") << "\n";
+                cout << "Enter new status: ";
+                {
+                    bool rented_status;
+                    cin >> rented_status;
+                    rental_engine.setVehicleStatus(vehicle_id, rented_status);
+                }
+                break;
+            case '8':
+                cout << "Current condition: " << fleet.vehicle_condition[slot] << "\n";
+                cout << "Enter new condition: ";
+                update.field = VehicleField::Condition;
+                cin >> update.number;
+                rental_engine.updateVehicle(update);
+                break;
+            case '0':
+                updating = false;
+                break;
+            default:
+                cout << "Invalid choice\n";
+                break;
+        }
+        commitTransactions();
+    }
+}
+
+void Administrator::modifyClient() {
+    cout << "Enter client ID to modify: ";
+    int client_id;
+    cin >> client_id;
+    
+    Client* found_client = findClient(client_id);
+    if (found_client == nullptr) {
+        cout << "Client not found\n";
+        return;
+    }
+    
+    Client& client = *found_client;
+    bool updating = true;
+    while (updating) {
+        cout << "Select field to update:\n";
+        cout << "1. Name\n2. Password\n3. Dues\n4. Rating\n0. Finish\nEnter choice: ";
+        
+        char choice;
+        cin >> choice;
+        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        
+        AccountUpdate update{{RenterRole::Client, client_id}, AccountField::Name, 0, ""};
+        switch (choice) {
+            case '1':
+                cout << "Current name: " << client.username << "\n";
+                cout << "Enter new name: ";
+                cin >> update.text;
+                if (rental_engine.updateAccount(update).status == OperationStatus::NameTaken) {
+                    cout << "Username already exists\n";
+                }
+                break;
+            case '2':
+                cout << "Enter new password: ";
+                update.field = AccountField::Password;
+                cin >> update.text;
+                rental_engine.updateAccount(update);
+                break;
+            case '3':
+                cout << "Current dues: " << client.outstanding_dues << "\n";
+                cout << "Enter new dues: ";
+                {
+                    int new_dues;
+                    cin >> new_dues;
+                    update.field = AccountField::Dues;
+                    update.number = new_dues;
+                    rental_engine.updateAccount(update);
+                }
+                break;
+            case '4':
+                cout << "Current rating: " << client.rating << "\n";
+                cout << "Enter new rating: ";
+                {
+                    int new_rating;
+                    cin >> new_rating;
+                    update.field = AccountField::Rating;
+                    update.number = new_rating;
+                    rental_engine.updateAccount(update);
+                }
+                break;
+            case '0':
+                updating = false;
+                break;
+            default:
+                cout << "Invalid choice\n";
+                break;
+        }
+        commitTransactions();
+    }
+}
+
+void Administrator::modifyStaff() {
+    cout << "Enter staff ID to modify: ";
+    string staff_str;
+    cin >> staff_str;
+    int staff_id = convertStringToInt(staff_str);
+    
+    StaffMember* found_staff = findStaff(staff_id);
+    if (found_staff == nullptr) {
+        cout << "Staff not found\n";
+        return;
+    }
+    
+    StaffMember& staff = *found_staff;
+    bool updating = true;
+    while (updating) {
+        cout << "Select field to update:\n";
+        cout << "1. Name\n2. Password\n3. Dues\n4. Rating\n0. Finish\nEnter choice: ";
+        
+        char choice;
+        cin >> choice;
+        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        
+        AccountUpdate update{{RenterRole::Staff, staff_id}, AccountField::Name, 0, ""};
+        switch (choice) {
+            case '1':
+                cout << "Current name: " << staff.username << "\n";
+                cout << "Enter new name: ";
+                cin >> update.text;
+                if (rental_engine.updateAccount(update).status == OperationStatus::Success) {
+                    cout << "Name updated to " << staff.username << endl;
+                } else {
+                    cout << "Username already exists\n";
+                }
+                break;
+            case '2':
+                cout << "Enter new password: ";
+                update.field = AccountField::Password;
+                cin >> update.text;
+                rental_engine.updateAccount(update);
+                cout << "Password updated successfully\n";
+                break;
+            case '3':
+                cout << "Current dues: " << staff.outstanding_dues << "\n";
+                cout << "Enter new dues: ";
+                {
+                    int new_dues;
+                    cin >> new_dues;
+                    update.field = AccountField::Dues;
+                    update.number = new_dues;
+                    rental_engine.updateAccount(update);
+                }
+                cout << "Dues updated to " << staff.outstanding_dues << endl;
+                break;
+            case '4':
+                cout << "Current rating: " << staff.rating << "\n";
+                cout << "Enter new rating: ";
+                update.field = AccountField::Rating;
+                cin >> update.number;
+                rental_engine.updateAccount(update);
+                cout << "Rating updated to " << staff.rating << endl;
+                break;
+            case '0':
+                updating = false;
+                break;
+            default:
+                cout << "Invalid choice\n";
+                break;
+        }
+        commitTransactions();
+    }
+}
+
+void Administrator::viewOverdueRentals() {
+    time_t current_time = time(0);
+    overdue_tracker.advance(current_time);
+    vector<DeadlineEntry> overdue = overdue_tracker.overdueRentals();
+    if (overdue.empty()) {
+        cout << "No overdue rentals\n\n\n";
+        return;
+    }
+    
+    cout << setw(3) << "ID" << setw(15) << "Brand" << setw(15) << "Model" << setw(8) << "Role" 
+         << setw(15) << "Renter" << setw(10) << "Days Late" << setw(10) << "Penalty" << endl;
+    for (const DeadlineEntry& entry : overdue) {
+        int vehicle_slot = findVehicleSlot(entry.vehicle_id);
+        bool by_client = entry.renter_role == RenterRole::Client;
+        const string& renter = by_client ? findClient(entry.renter_id)->username : findStaff(entry.renter_id)->username;
+        cout << setw(3) << entry.vehicle_id << setw(15) << vehicle_inventory.brand(vehicle_slot) 
+             << setw(15) << vehicle_inventory.model(vehicle_slot) << setw(8) << (by_client ? "Client" : "Staff") 
+             << setw(15) << renter << setw(10) << (current_time - entry.deadline) / SECONDS_PER_DAY 
+             << setw(10) << latePenalty(entry.renter_role, vehicle_inventory.daily_rent[vehicle_slot], 
+                                        entry.deadline, current_time) << endl;
+    }
+    cout << overdue.size() << " overdue rental(s)\n\n\n";
+}
+
+void Administrator::saveOperationMetrics() {
+    cout << "Enter file name: ";
+    string path;
+    cin >> path;
+    if (dumpOperationMetrics(path)) {
+        cout << "Operation metrics saved to " << path << "\n\n\n";
+    } else {
+        cout << "Cannot write " << path << "\n\n\n";
+    }
+}
+
+void Administrator::accessAdminPortal() {
+    bool session_active = true;
+    cout << "Welcome, " << this->username << endl;
+    
+    while (session_active) {
+        cout << "Administrator Panel Options:\n";
+        cout << "1. View all vehicles\n2. Add vehicle\n3. Modify vehicle\n4. Remove vehicle\n"
+             << "5. View all clients\n6. Add client\n7. Modify client\n8. Remove client\n"
+             << "9. View all staff\na. Add staff\nb. Modify staff\nc. Remove staff\n"
+             << "d. Search vehicles\ne. Overdue rentals\nf. Operation metrics\ng. Save operation metrics\n"
+             << "h. Import from CSV\ni. Reports\n0. Logout\nEnter your choice: ";
+        
+        char choice;
+        cin >> choice;
+        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        
+        switch (choice) {
+            case '1': displayAllVehicles(); break;
+            case '2': addNewVehicle(); break;
+            case '3': modifyVehicle(); break;
+            case '4': removeVehicle(); break;
+            case '5': viewAllClients(); break;
+            case '6': addNewClient(); break;
+            case '7': modifyClient(); break;
+            case '8': removeClient(); break;
+            case '9': viewAllStaff(); break;
+            case 'a': addNewStaff(); break;
+            case 'b': modifyStaff(); break;
+            case 'c': removeStaff(); break;
+            case 'd': searchVehicles(); break;
+            case 'e': viewOverdueRentals(); break;
+            case 'f': printOperationMetrics(); cout << "\n\n"; break;
+            case 'g': saveOperationMetrics(); break;
+            case 'h': importRecords(); break;
+            case 'i': showReports(); break;
+            case '0': session_active = false; break;
+            default: cout << "Invalid selection\n"; break;
+        }
+    }
+}
+
+bool validAdminCredentials(const string& name, const string& password) {
+    return name == "admin" && password == "admin";
+}
+
+void handleAdminLogin() {
+    bool login_session = true;
+    
+    while (login_session) {
+        cout << "Administrator Portal Options:\n";
+        cout << "1. Login\n0. Exit\nEnter your choice: ";
+        char choice;
+        cin >> choice;
+        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        
+        switch (choice) {
+            case '1': {
+                cout << "Enter username:\n";
+                string name;
+                getline(cin, name);
+                cout << "Enter password:\n";
+                string password;
+                cin >> password;
+                
+                if (validAdminCredentials(name, password)) {
+                    cout << "Authentication successful\n";
+                    system_admin.accessAdminPortal();
+                    break;
+                }
+                cout << "Authentication failed: Invalid credentials\n";
+                break;
+            }
+            case '0': login_session = false; break;
+            default: cout << "Invalid selection\n"; break;
+        }
+    }
+}
+
+//======================= SNAPSHOTS =======================//
+
+// Drop every table and counter, leaving an empty system
+void clearAllTables() {
+    vehicle_inventory.clear();
+    vehicle_slot_by_id.clear();
+    client_database.clear();
+    client_slot_by_id.clear();
+    dead_client_rows = 0;
+    staff_database.clear();
+    staff_slot_by_id.clear();
+    dead_staff_rows = 0;
+    account_index.clear();
+    rental_table.clear();
+    free_rental_slots.clear();
+    rental_slot_by_vehicle.clear();
+    client_rentals.clear();
+    staff_rentals.clear();
+    vehicle_calendars.clear();
+    reservation_vehicle.clear();
+    reservation_counter = 0;
+    overdue_tracker.clear();
+    vehicle_row_cache.clear();
+    Vehicle::vehicle_counter = 0;
+    BaseUser::customer_count = 0;
+    BaseUser::employee_count = 0;
+    markVersionedTablesStale();
+}
+
+// Reclaim every tombstoned row. Needs exclusive access: the slots of live rows move.
+void compactTables() {
+    compactVehicles();
+    compactClients();
+    compactStaff();
+}
+
+// Read-only view of a whole file, memory-mapped where the platform allows it
+class MappedFile {
+public:
+    const char* data = nullptr;
+    size_t size = 0;
+
+    MappedFile() {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (data != nullptr && size > 0) {
+            munmap((void*)data, size);
+        }
+#endif
+    }
+
+    bool open(const string& path) {
+#ifndef _WIN32
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return false;
+        }
+        struct stat file_status;
+        if (fstat(descriptor, &file_status) != 0 || file_status.st_size == 0) {
+            close(descriptor);
+            return false;
+        }
+        void* mapping = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        close(descriptor);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        madvise(mapping, file_status.st_size, MADV_SEQUENTIAL);
+        data = (const char*)mapping;
+        size = file_status.st_size;
+        return true;
+#else
+        ifstream file(path, ios::binary);
+        if (!file) {
+            return false;
+        }
+        buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+        return size > 0;
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    vector<char> buffer;
+#endif
+};
+
+enum class SnapshotStatus {
+    Loaded,
+    Missing,
+    Invalid
+};
+
+// Snapshot file layout:
+//   SnapshotHeader, then section_count SnapshotSection directory entries,
+//   then each section's payload starting on an 8-byte boundary.
+// Fixed-width columns and index tables are stored exactly as they sit in
+// memory. Loading copies each into its vector in one pass; the tables are
+// not used in place. String columns are stored as an offsets array plus one
+// byte blob. Accounts are still rebuilt one object per record, with names
+// and passwords copied out of those blobs into each account's strings.
+// Snapshots are tied to the byte order and type sizes of the build that wrote them.
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t file_size;
+};
+
+struct SnapshotSection {
+    uint32_t id;
+    uint32_t element_size;
+    uint64_t offset;
+    uint64_t count;
+};
+
+enum SnapshotSectionId : uint32_t {
+    SECTION_COUNTERS = 1,
+    SECTION_VEHICLE_ID, SECTION_VEHICLE_PRICE, SECTION_VEHICLE_RENT, SECTION_VEHICLE_SEATS,
+    SECTION_VEHICLE_CONDITION, SECTION_VEHICLE_RENTED, SECTION_VEHICLE_DEADLINE,
+    // Per-vehicle strings; only read from snapshots written before the string pools
+    SECTION_VEHICLE_BRAND_OFFSETS, SECTION_VEHICLE_BRAND_BYTES,
+    SECTION_VEHICLE_MODEL_OFFSETS, SECTION_VEHICLE_MODEL_BYTES,
+    SECTION_VEHICLE_COLOR_OFFSETS, SECTION_VEHICLE_COLOR_BYTES,
+    SECTION_VEHICLE_SLOTS,
+    SECTION_CLIENT_ID, SECTION_CLIENT_DUES, SECTION_CLIENT_RATING,
+    SECTION_CLIENT_NAME_OFFSETS, SECTION_CLIENT_NAME_BYTES,
+    SECTION_CLIENT_PASSWORD_OFFSETS, SECTION_CLIENT_PASSWORD_BYTES,
+    SECTION_CLIENT_SLOTS,
+    SECTION_STAFF_ID, SECTION_STAFF_DUES, SECTION_STAFF_RATING,
+    SECTION_STAFF_NAME_OFFSETS, SECTION_STAFF_NAME_BYTES,
+    SECTION_STAFF_PASSWORD_OFFSETS, SECTION_STAFF_PASSWORD_BYTES,
+    SECTION_STAFF_SLOTS,
+    SECTION_ACCOUNT_INDEX,
+    SECTION_RENTALS, SECTION_FREE_RENTAL_SLOTS, SECTION_RENTAL_BY_VEHICLE,
+    SECTION_CLIENT_RENTALS, SECTION_STAFF_RENTALS,
+    SECTION_VEHICLE_ACCRUED_DAYS,
+    SECTION_VEHICLE_BRAND_CODES, SECTION_VEHICLE_MODEL_CODES, SECTION_VEHICLE_COLOR_CODES,
+    SECTION_BRAND_POOL_OFFSETS, SECTION_BRAND_POOL_BYTES,
+    SECTION_MODEL_POOL_OFFSETS, SECTION_MODEL_POOL_BYTES,
+    SECTION_COLOR_POOL_OFFSETS, SECTION_COLOR_POOL_BYTES,
+    SECTION_VEHICLE_REVENUE,
+    SECTION_RESERVATIONS, SECTION_RESERVATION_COUNTER,
+    SECTION_COUNT_PLUS_ONE
+};
+
+const char SNAPSHOT_MAGIC[8] = {'C', 'R', 'S', 'N', 'A', 'P', '0', '1'};
+const uint32_t SNAPSHOT_VERSION = 2;
+
+class SnapshotFile {
+public:
+    static bool save(const string& path);
+    static SnapshotStatus load(const string& path);
+
+private:
+    struct PendingSection {
+        SnapshotSection section;
+        const char* payload;
+    };
+
+    vector<PendingSection> pending;
+    vector<unique_ptr<vector<char>>> owned_payloads;
+    const MappedFile* source = nullptr;
+    const SnapshotSection* directory[SECTION_COUNT_PLUS_ONE] = {};
+
+    void addRaw(uint32_t id, uint32_t element_size, uint64_t count, const void* payload) {
+        pending.push_back({{id, element_size, 0, count}, (const char*)payload});
+    }
+
+    template <typename T>
+    void addColumn(uint32_t id, const vector<T>& column) {
+        static_assert(is_trivially_copyable<T>::value, "snapshot columns must be plain data");
+        addRaw(id, sizeof(T), column.size(), column.data());
+    }
+
+    // Copy a derived column into a buffer owned by the writer
+    template <typename T>
+    void addOwnedColumn(uint32_t id, const vector<T>& column) {
+        owned_payloads.emplace_back(new vector<char>((const char*)column.data(), 
+                                                     (const char*)(column.data() + column.size())));
+        addRaw(id, sizeof(T), column.size(), owned_payloads.back()->data());
+    }
+
+    // Store count strings, fetched through text(i), as an offsets array and a byte blob
+    template <typename Text>
+    void addStrings(uint32_t offsets_id, uint32_t bytes_id, size_t count, Text text) {
+        vector<uint64_t> offsets(count + 1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            offsets[i + 1] = offsets[i] + text(i).size();
+        }
+        vector<char> bytes(offsets[count]);
+        for (size_t i = 0; i < count; ++i) {
+            memcpy(bytes.data() + offsets[i], text(i).data(), text(i).size());
+        }
+        addOwnedColumn(offsets_id, offsets);
+        addOwnedColumn(bytes_id, bytes);
+    }
+
+    // A string pool's values in code order
+    void addPool(uint32_t offsets_id, uint32_t bytes_id, const StringPool& pool) {
+        addStrings(offsets_id, bytes_id, pool.size(), [&pool](size_t code) { return pool.text((uint32_t)code); });
+    }
+
+    bool write(const string& path);
+
+    bool readDirectory(const MappedFile& file);
+
+    // Replace a column with a section's contents in one copy
+    template <typename T>
+    bool readColumn(uint32_t id, vector<T>& column) const {
+        const SnapshotSection* section = directory[id];
+        if (section == nullptr || section->element_size != sizeof(T)) {
+            return false;
+        }
+        // Sections start 8-byte aligned in a page-aligned mapping, so they can be read as T directly.
+        // Assigning the range writes each element once, where resize would zero the column first.
+        const T* first = (const T*)(source->data + section->offset);
+        column.assign(first, first + section->count);
+        return true;
+    }
+
+    // Rebuild count strings from an offsets/bytes section pair, handing each to store(i, text, length)
+    template <typename Store>
+    bool readStrings(uint32_t offsets_id, uint32_t bytes_id, size_t count, Store store) const {
+        const SnapshotSection* offsets_section = directory[offsets_id];
+        const SnapshotSection* bytes_section = directory[bytes_id];
+        if (offsets_section == nullptr || bytes_section == nullptr 
+                || offsets_section->element_size != sizeof(uint64_t) || offsets_section->count != count + 1) {
+            return false;
+        }
+        const char* offsets_data = source->data + offsets_section->offset;
+        const char* bytes = source->data + bytes_section->offset;
+        uint64_t start;
+        memcpy(&start, offsets_data, sizeof(start));
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t end;
+            memcpy(&end, offsets_data + (i + 1) * sizeof(uint64_t), sizeof(end));
+            if (end < start || end > bytes_section->count) {
+                return false;
+            }
+            store(i, bytes + start, end - start);
+            start = end;
+        }
+        return true;
+    }
+
+    // Refill an empty pool so that every value gets back its saved code
+    bool readPool(uint32_t offsets_id, uint32_t bytes_id, StringPool& pool) const {
+        const SnapshotSection* offsets_section = directory[offsets_id];
+        if (offsets_section == nullptr || offsets_section->count == 0) {
+            return false;
+        }
+        return readStrings(offsets_id, bytes_id, offsets_section->count - 1, 
+            [&pool](size_t, const char* text, size_t length) { pool.intern(string_view(text, length)); })
+            && pool.size() == offsets_section->count - 1;
+    }
+
+    // Read a code column and check every code against its pool
+    bool readCodes(uint32_t id, vector<uint32_t>& codes, const StringPool& pool, size_t count) const {
+        return readColumn(id, codes) && codes.size() == count 
+            && all_of(codes.begin(), codes.end(), [&pool](uint32_t code) { return code < pool.size(); });
+    }
+
+    bool readTables();
+};
+
+bool SnapshotFile::save(const string& path) {
+    // Snapshots hold live rows only
+    compactTables();
+    SnapshotFile writer;
+    const FleetStore& fleet = vehicle_inventory;
+    
+    vector<uint64_t> counters = {(uint64_t)Vehicle::vehicle_counter, (uint64_t)BaseUser::customer_count, 
+                                 (uint64_t)BaseUser::employee_count, account_index.entry_count, wal_generation};
+    writer.addOwnedColumn(SECTION_COUNTERS, counters);
+    
+    writer.addColumn(SECTION_VEHICLE_ID, fleet.vehicle_id);
+    writer.addColumn(SECTION_VEHICLE_PRICE, fleet.market_price);
+    writer.addColumn(SECTION_VEHICLE_RENT, fleet.daily_rent);
+    writer.addColumn(SECTION_VEHICLE_SEATS, fleet.seating_capacity);
+    writer.addColumn(SECTION_VEHICLE_CONDITION, fleet.vehicle_condition);
+    writer.addColumn(SECTION_VEHICLE_RENTED, fleet.is_rented);
+    writer.addColumn(SECTION_VEHICLE_DEADLINE, fleet.return_deadline);
+    writer.addColumn(SECTION_VEHICLE_ACCRUED_DAYS, fleet.accrued_days);
+    writer.addColumn(SECTION_VEHICLE_REVENUE, fleet.revenue);
+    writer.addColumn(SECTION_VEHICLE_BRAND_CODES, fleet.brand_code);
+    writer.addColumn(SECTION_VEHICLE_MODEL_CODES, fleet.model_code);
+    writer.addColumn(SECTION_VEHICLE_COLOR_CODES, fleet.color_code);
+    writer.addPool(SECTION_BRAND_POOL_OFFSETS, SECTION_BRAND_POOL_BYTES, fleet.brand_pool);
+    writer.addPool(SECTION_MODEL_POOL_OFFSETS, SECTION_MODEL_POOL_BYTES, fleet.model_pool);
+    writer.addPool(SECTION_COLOR_POOL_OFFSETS, SECTION_COLOR_POOL_BYTES, fleet.color_pool);
+    writer.addColumn(SECTION_VEHICLE_SLOTS, vehicle_slot_by_id);
+    
+    vector<int> client_ids, client_dues, ratings;
+    for (const auto& client : client_database) {
+        client_ids.push_back(client.user_id);
+        client_dues.push_back(client.outstanding_dues);
+        ratings.push_back(client.rating);
+    }
+    writer.addOwnedColumn(SECTION_CLIENT_ID, client_ids);
+    writer.addOwnedColumn(SECTION_CLIENT_DUES, client_dues);
+    writer.addOwnedColumn(SECTION_CLIENT_RATING, ratings);
+    writer.addStrings(SECTION_CLIENT_NAME_OFFSETS, SECTION_CLIENT_NAME_BYTES, client_database.size(),
+                      [](size_t i) -> const string& { return client_database[i].username; });
+    writer.addStrings(SECTION_CLIENT_PASSWORD_OFFSETS, SECTION_CLIENT_PASSWORD_BYTES, client_database.size(),
+                      [](size_t i) -> const string& { return client_database[i].user_password; });
+    writer.addColumn(SECTION_CLIENT_SLOTS, client_slot_by_id);
+    
+    vector<int> staff_ids, staff_dues;
+    vector<double> staff_ratings;
+    for (const auto& staff : staff_database) {
+        staff_ids.push_back(staff.user_id);
+        staff_dues.push_back(staff.outstanding_dues);
+        staff_ratings.push_back(staff.rating);
+    }
+    writer.addOwnedColumn(SECTION_STAFF_ID, staff_ids);
+    writer.addOwnedColumn(SECTION_STAFF_DUES, staff_dues);
+    writer.addOwnedColumn(SECTION_STAFF_RATING, staff_ratings);
+    writer.addStrings(SECTION_STAFF_NAME_OFFSETS, SECTION_STAFF_NAME_BYTES, staff_database.size(),
+                      [](size_t i) -> const string& { return staff_database[i].username; });
+    writer.addStrings(SECTION_STAFF_PASSWORD_OFFSETS, SECTION_STAFF_PASSWORD_BYTES, staff_database.size(),
+                      [](size_t i) -> const string& { return staff_database[i].user_password; });
+    writer.addColumn(SECTION_STAFF_SLOTS, staff_slot_by_id);
+    
+    writer.addColumn(SECTION_ACCOUNT_INDEX, account_index.slots);
+    writer.addColumn(SECTION_RENTALS, rental_table);
+    writer.addColumn(SECTION_FREE_RENTAL_SLOTS, free_rental_slots);
+    writer.addColumn(SECTION_RENTAL_BY_VEHICLE, rental_slot_by_vehicle);
+    writer.addColumn(SECTION_CLIENT_RENTALS, client_rentals);
+    writer.addColumn(SECTION_STAFF_RENTALS, staff_rentals);
+    // Calendars are flattened in vehicle order; each vehicle's bookings stay sorted
+    vector<Reservation> reservations;
+    for (const auto& calendar : vehicle_calendars) {
+        reservations.insert(reservations.end(), calendar.begin(), calendar.end());
+    }
+    writer.addOwnedColumn(SECTION_RESERVATIONS, reservations);
+    writer.addOwnedColumn(SECTION_RESERVATION_COUNTER, vector<int>{reservation_counter});
+    
+    return writer.write(path);
+}
+
+// Write header, directory and payloads to a temporary file, then rename it into place
+bool SnapshotFile::write(const string& path) {
+    uint64_t offset = sizeof(SnapshotHeader) + pending.size() * sizeof(SnapshotSection);
+    for (auto& entry : pending) {
+        offset = (offset + 7) & ~uint64_t(7);
+        entry.section.offset = offset;
+        offset += entry.section.count * entry.section.element_size;
+    }
+    
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.section_count = pending.size();
+    header.file_size = offset;
+    
+    string temporary_path = path + ".tmp";
+    ofstream file(temporary_path, ios::binary | ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file.write((const char*)&header, sizeof(header));
+    for (const auto& entry : pending) {
+        file.write((const char*)&entry.section, sizeof(entry.section));
+    }
+    uint64_t position = sizeof(SnapshotHeader) + pending.size() * sizeof(SnapshotSection);
+    const char padding[8] = {};
+    for (const auto& entry : pending) {
+        file.write(padding, entry.section.offset - position);
+        file.write(entry.payload, entry.section.count * entry.section.element_size);
+        position = entry.section.offset + entry.section.count * entry.section.element_size;
+    }
+    file.close();
+    if (!file) {
+        remove(temporary_path.c_str());
+        return false;
+    }
+    return rename(temporary_path.c_str(), path.c_str()) == 0;
+}
+
+// Validate the header and index every section that lies inside the file
+bool SnapshotFile::readDirectory(const MappedFile& file) {
+    source = &file;
+    if (file.size < sizeof(SnapshotHeader)) {
+        return false;
+    }
+    SnapshotHeader header;
+    memcpy(&header, file.data, sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 
+            || header.version != SNAPSHOT_VERSION || header.file_size != file.size
+            || sizeof(SnapshotHeader) + uint64_t(header.section_count) * sizeof(SnapshotSection) > file.size) {
+        return false;
+    }
+    
+    const SnapshotSection* sections = (const SnapshotSection*)(file.data + sizeof(SnapshotHeader));
+    for (uint32_t i = 0; i < header.section_count; ++i) {
+        const SnapshotSection& section = sections[i];
+        if (section.id == 0 || section.id >= SECTION_COUNT_PLUS_ONE || section.element_size == 0
+                || section.offset > file.size 
+                || section.count > (file.size - section.offset) / section.element_size) {
+            return false;
+        }
+        directory[section.id] = &section;
+    }
+    return true;
+}
+
+// Rebuild every table from the mapped sections; false if any section is missing or malformed
+bool SnapshotFile::readTables() {
+    vector<uint64_t> counters;
+    if (!readColumn(SECTION_COUNTERS, counters) || counters.size() != 5) {
+        return false;
+    }
+    
+    FleetStore& fleet = vehicle_inventory;
+    bool complete = readColumn(SECTION_VEHICLE_ID, fleet.vehicle_id)
+        && readColumn(SECTION_VEHICLE_PRICE, fleet.market_price)
+        && readColumn(SECTION_VEHICLE_RENT, fleet.daily_rent)
+        && readColumn(SECTION_VEHICLE_SEATS, fleet.seating_capacity)
+        && readColumn(SECTION_VEHICLE_CONDITION, fleet.vehicle_condition)
+        && readColumn(SECTION_VEHICLE_RENTED, fleet.is_rented)
+        && readColumn(SECTION_VEHICLE_DEADLINE, fleet.return_deadline)
+        && readColumn(SECTION_VEHICLE_SLOTS, vehicle_slot_by_id);
+    size_t vehicle_count = fleet.vehicle_id.size();
+    complete = complete && fleet.market_price.size() == vehicle_count && fleet.daily_rent.size() == vehicle_count
+        && fleet.seating_capacity.size() == vehicle_count && fleet.vehicle_condition.size() == vehicle_count
+        && fleet.is_rented.size() == vehicle_count && fleet.return_deadline.size() == vehicle_count;
+    if (!complete) {
+        return false;
+    }
+    fleet.row_version.assign(vehicle_count, 0);
+    fleet.markAllLive();
+    // Snapshots written before late fee accrual have no accrued-days column
+    if (!readColumn(SECTION_VEHICLE_ACCRUED_DAYS, fleet.accrued_days) || fleet.accrued_days.size() != vehicle_count) {
+        fleet.accrued_days.assign(vehicle_count, 0);
+    }
+    if (!readColumn(SECTION_VEHICLE_REVENUE, fleet.revenue) || fleet.revenue.size() != vehicle_count) {
+        fleet.revenue.assign(vehicle_count, 0);
+    }
+    fleet.brand_pool.clear();
+    fleet.model_pool.clear();
+    fleet.color_pool.clear();
+    if (directory[SECTION_VEHICLE_BRAND_CODES] != nullptr) {
+        complete = readPool(SECTION_BRAND_POOL_OFFSETS, SECTION_BRAND_POOL_BYTES, fleet.brand_pool)
+            && readPool(SECTION_MODEL_POOL_OFFSETS, SECTION_MODEL_POOL_BYTES, fleet.model_pool)
+            && readPool(SECTION_COLOR_POOL_OFFSETS, SECTION_COLOR_POOL_BYTES, fleet.color_pool)
+            && readCodes(SECTION_VEHICLE_BRAND_CODES, fleet.brand_code, fleet.brand_pool, vehicle_count)
+            && readCodes(SECTION_VEHICLE_MODEL_CODES, fleet.model_code, fleet.model_pool, vehicle_count)
+            && readCodes(SECTION_VEHICLE_COLOR_CODES, fleet.color_code, fleet.color_pool, vehicle_count);
+    } else {
+        // Older snapshots store every vehicle's strings; intern them on the way in
+        fleet.brand_code.resize(vehicle_count);
+        fleet.model_code.resize(vehicle_count);
+        fleet.color_code.resize(vehicle_count);
+        complete = readStrings(SECTION_VEHICLE_BRAND_OFFSETS, SECTION_VEHICLE_BRAND_BYTES, vehicle_count,
+                [&fleet](size_t i, const char* text, size_t length) { fleet.setBrand(i, string_view(text, length)); })
+            && readStrings(SECTION_VEHICLE_MODEL_OFFSETS, SECTION_VEHICLE_MODEL_BYTES, vehicle_count,
+                [&fleet](size_t i, const char* text, size_t length) { fleet.setModel(i, string_view(text, length)); })
+            && readStrings(SECTION_VEHICLE_COLOR_OFFSETS, SECTION_VEHICLE_COLOR_BYTES, vehicle_count,
+                [&fleet](size_t i, const char* text, size_t length) { fleet.setColor(i, string_view(text, length)); });
+    }
+    
+    vector<int> client_ids, client_dues, ratings;
+    vector<string_view> client_names;
+    complete = complete && readColumn(SECTION_CLIENT_ID, client_ids)
+        && readColumn(SECTION_CLIENT_DUES, client_dues) && readColumn(SECTION_CLIENT_RATING, ratings)
+        && client_dues.size() == client_ids.size() && ratings.size() == client_ids.size()
+        && readColumn(SECTION_CLIENT_SLOTS, client_slot_by_id);
+    if (!complete) {
+        return false;
+    }
+    client_names.resize(client_ids.size());
+    client_database.reserve(client_ids.size());
+    complete = readStrings(SECTION_CLIENT_NAME_OFFSETS, SECTION_CLIENT_NAME_BYTES, client_ids.size(),
+            [&client_names](size_t i, const char* text, size_t length) { client_names[i] = string_view(text, length); })
+        && readStrings(SECTION_CLIENT_PASSWORD_OFFSETS, SECTION_CLIENT_PASSWORD_BYTES, client_ids.size(),
+            [&](size_t i, const char* text, size_t length) {
+                client_database.emplace_back(string(client_names[i]), string(text, length), 
+                                             ratings[i], client_dues[i]);
+                client_database.back().user_id = client_ids[i];
+            });
+    
+    vector<int> staff_ids, staff_dues;
+    vector<double> staff_ratings;
+    vector<string_view> staff_names;
+    complete = complete && readColumn(SECTION_STAFF_ID, staff_ids)
+        && readColumn(SECTION_STAFF_DUES, staff_dues) && readColumn(SECTION_STAFF_RATING, staff_ratings)
+        && staff_dues.size() == staff_ids.size() && staff_ratings.size() == staff_ids.size()
+        && readColumn(SECTION_STAFF_SLOTS, staff_slot_by_id);
+    if (!complete) {
+        return false;
+    }
+    staff_names.resize(staff_ids.size());
+    staff_database.reserve(staff_ids.size());
+    complete = readStrings(SECTION_STAFF_NAME_OFFSETS, SECTION_STAFF_NAME_BYTES, staff_ids.size(),
+            [&staff_names](size_t i, const char* text, size_t length) { staff_names[i] = string_view(text, length); })
+        && readStrings(SECTION_STAFF_PASSWORD_OFFSETS, SECTION_STAFF_PASSWORD_BYTES, staff_ids.size(),
+            [&](size_t i, const char* text, size_t length) {
+                staff_database.emplace_back(string(staff_names[i]), string(text, length), 
+                                            staff_ratings[i], staff_dues[i]);
+                staff_database.back().user_id = staff_ids[i];
+            });
+    
+    complete = complete && readColumn(SECTION_ACCOUNT_INDEX, account_index.slots)
+        && (account_index.slots.size() & (account_index.slots.size() - 1)) == 0
+        && readColumn(SECTION_RENTALS, rental_table)
+        && readColumn(SECTION_FREE_RENTAL_SLOTS, free_rental_slots)
+        && readColumn(SECTION_RENTAL_BY_VEHICLE, rental_slot_by_vehicle)
+        && readColumn(SECTION_CLIENT_RENTALS, client_rentals)
+        && readColumn(SECTION_STAFF_RENTALS, staff_rentals);
+    if (!complete) {
+        return false;
+    }
+    // Reservations are optional; older snapshots have none
+    vector<Reservation> reservations;
+    vector<int> reservation_counters;
+    if (readColumn(SECTION_RESERVATIONS, reservations)) {
+        for (const Reservation& reservation : reservations) {
+            if (reservation.reservation_id <= 0 || reservation.vehicle_id <= 0 || reservation.start >= reservation.end) {
+                return false;
+            }
+            insertReservation(reservation);
+        }
+    }
+    if (readColumn(SECTION_RESERVATION_COUNTER, reservation_counters) && reservation_counters.size() == 1) {
+        reservation_counter = max(reservation_counter, reservation_counters[0]);
+    }
+    
+    Vehicle::vehicle_counter = counters[0];
+    BaseUser::customer_count = counters[1];
+    BaseUser::employee_count = counters[2];
+    account_index.entry_count = counters[3];
+    wal_generation = counters[4];
+    return true;
+}
+
+SnapshotStatus SnapshotFile::load(const string& path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return SnapshotStatus::Missing;
+    }
+    
+    clearAllTables();
+    SnapshotFile reader;
+    if (!reader.readDirectory(file) || !reader.readTables()) {
+        clearAllTables();
+        return SnapshotStatus::Invalid;
+    }
+    overdue_tracker.rebuild();
+    return SnapshotStatus::Loaded;
+}
+
+//======================= RECOVERY =======================//
+
+// Replays the transaction log on top of the loaded snapshot.
+//
+// Frames are located with one sequential pass over the length fields, then
+// checksummed and decoded in parallel. Records that touch shared tables
+// (adds, removals, renames, rentals opening and closing, vehicle attribute
+// edits that intern text or move index entries) are applied in log order on
+// one thread. What remains is per-account field updates (dues, ratings,
+// passwords); those are partitioned by the account they touch and applied in
+// parallel, keeping log order within each partition.
+class WalReplay {
+public:
+    // Number of records applied; 0 when the log is missing, empty or belongs to another generation
+    static size_t replay(const string& path, uint64_t generation);
+
+private:
+    static void applyStructure(const WalRecord& record);
+    static void applyFields(const WalRecord& record);
+    static bool hasFieldUpdate(const WalRecord& record);
+};
+
+bool WalReplay::hasFieldUpdate(const WalRecord& record) {
+    switch (record.type) {
+        case WalRecordType::Rented:
+        case WalRecordType::Returned:
+        case WalRecordType::Payment:
+        case WalRecordType::LateFeeAccrued:
+            return true;
+        case WalRecordType::AccountFieldSet:
+            return record.field != (int32_t)AccountField::Name;
+        default:
+            return false;
+    }
+}
+
+void WalReplay::applyStructure(const WalRecord& record) {
+    switch (record.type) {
+        case WalRecordType::VehicleAdded: {
+            Vehicle vehicle(record.texts[0], record.texts[1], record.numbers[0], record.numbers[1], 
+                            record.numbers[2], record.texts[2], record.numbers[3], record.numbers[4]);
+            vehicle.vehicle_id = record.vehicle_id;
+            Vehicle::vehicle_counter = max(Vehicle::vehicle_counter.load(), record.vehicle_id);
+            addVehicle(vehicle);
+            break;
+        }
+        case WalRecordType::VehicleRemoved: {
+            int slot = findVehicleSlot(record.vehicle_id);
+            if (slot != -1) {
+                eraseVehicle(slot);
+                dropReservations(record.vehicle_id);
+            }
+            break;
+        }
+        case WalRecordType::Reserved:
+            if (findVehicleSlot(record.vehicle_id) != -1 && reservationVehicle((int)record.numbers[0]) == 0) {
+                insertReservation({(int)record.numbers[0], record.vehicle_id, record.account_id, record.role, 
+                                   (time_t)record.numbers[1], (time_t)record.numbers[2]});
+            }
+            break;
+        case WalRecordType::ReservationReleased:
+            releaseReservation(record.vehicle_id, (int)record.numbers[0]);
+            break;
+        case WalRecordType::VehicleStatusSet: {
+            int slot = findVehicleSlot(record.vehicle_id);
+            if (slot != -1) {
+                setVehicleRentedStatus(slot, record.numbers[0] != 0);
+            }
+            break;
+        }
+        case WalRecordType::VehicleFieldSet: {
+            // Text fields intern into the shared pools and indexed fields move
+            // index entries, so these stay on the serial pass
+            int slot = findVehicleSlot(record.vehicle_id);
+            if (slot == -1) {
+                break;
+            }
+            FleetStore& fleet = vehicle_inventory;
+            switch ((VehicleField)record.field) {
+                case VehicleField::Brand: fleet.setBrand(slot, record.texts[0]); break;
+                case VehicleField::Model: fleet.setModel(slot, record.texts[0]); break;
+                case VehicleField::Rent: fleet.setRent(slot, record.numbers[0]); break;
+                case VehicleField::Price: fleet.market_price[slot] = record.numbers[0]; break;
+                case VehicleField::Seats: fleet.setSeats(slot, record.numbers[0]); break;
+                case VehicleField::Color: fleet.setColor(slot, record.texts[0]); break;
+                case VehicleField::Condition: fleet.setCondition(slot, record.numbers[0]); break;
+            }
+            fleet.touch(slot);
+            break;
+        }
+        case WalRecordType::AccountAdded:
+            if (record.role == RenterRole::Client) {
+                Client client(record.texts[0], record.texts[1]);
+                client.user_id = record.account_id;
+                BaseUser::customer_count = max(BaseUser::customer_count.load(), record.account_id);
+                addClient(client);
+            } else {
+                StaffMember staff(record.texts[0], record.texts[1]);
+                staff.user_id = record.account_id;
+                BaseUser::employee_count = max(BaseUser::employee_count.load(), record.account_id);
+                addStaff(staff);
+            }
+            break;
+        case WalRecordType::AccountRemoved:
+            if (record.role == RenterRole::Client && findClient(record.account_id) != nullptr) {
+                eraseClient(findClient(record.account_id) - client_database.data());
+            } else if (record.role == RenterRole::Staff && findStaff(record.account_id) != nullptr) {
+                eraseStaff(findStaff(record.account_id) - staff_database.data());
+            }
+            break;
+        case WalRecordType::AccountFieldSet:
+            if (record.field != (int32_t)AccountField::Name) {
+                break;
+            }
+            if (record.role == RenterRole::Client && findClient(record.account_id) != nullptr) {
+                renameClient(*findClient(record.account_id), record.texts[0]);
+            } else if (record.role == RenterRole::Staff && findStaff(record.account_id) != nullptr) {
+                renameStaff(*findStaff(record.account_id), record.texts[0]);
+            }
+            break;
+        case WalRecordType::Rented: {
+            int slot = findVehicleSlot(record.vehicle_id);
+            if (slot != -1 && findRentalByVehicle(record.vehicle_id) == -1) {
+                openRental(record.role, record.account_id, slot, record.numbers[0], record.numbers[1]);
+                vehicle_inventory.addRevenue(slot, record.numbers[2]);
+            }
+            break;
+        }
+        case WalRecordType::Returned: {
+            int rental_slot = findRentalByVehicle(record.vehicle_id);
+            if (rental_slot != -1) {
+                int slot = findVehicleSlot(record.vehicle_id);
+                if (slot != -1) {
+                    vehicle_inventory.addRevenue(slot, record.numbers[0]);
+                }
+                closeRental(rental_slot);
+            }
+            break;
+        }
+        case WalRecordType::LateFeeAccrued: {
+            int slot = findVehicleSlot(record.vehicle_id);
+            if (slot != -1 && findRentalByVehicle(record.vehicle_id) != -1) {
+                vehicle_inventory.accrued_days[slot] = (int32_t)record.numbers[1];
+                vehicle_inventory.addRevenue(slot, record.numbers[0]);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void WalReplay::applyFields(const WalRecord& record) {
+    Client* client = record.role == RenterRole::Client ? findClient(record.account_id) : nullptr;
+    StaffMember* staff = record.role == RenterRole::Staff ? findStaff(record.account_id) : nullptr;
+    if (client == nullptr && staff == nullptr) {
+        return;
+    }
+    int& dues = client != nullptr ? client->outstanding_dues : staff->outstanding_dues;
+    switch (record.type) {
+        case WalRecordType::Rented:
+            dues += record.numbers[2];
+            break;
+        case WalRecordType::Returned:
+        case WalRecordType::LateFeeAccrued:
+            dues += record.numbers[0];
+            if (client != nullptr) {
+                client->rating -= (int)record.real;
+            } else {
+                staff->rating -= record.real;
+            }
+            break;
+        case WalRecordType::Payment:
+            dues -= record.numbers[0];
+            break;
+        case WalRecordType::AccountFieldSet:
+            switch ((AccountField)record.field) {
+                case AccountField::Password:
+                    (client != nullptr ? client->user_password : staff->user_password) = record.texts[0];
+                    break;
+                case AccountField::Dues:
+                    dues = record.numbers[0];
+                    break;
+                case AccountField::Rating:
+                    if (client != nullptr) {
+                        client->rating = record.numbers[0];
+                    } else {
+                        staff->rating = record.real;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+size_t WalReplay::replay(const string& path, uint64_t generation) {
+    MappedFile file;
+    if (!file.open(path) || file.size < sizeof(WalHeader)) {
+        return 0;
+    }
+    WalHeader header;
+    memcpy(&header, file.data, sizeof(header));
+    if (memcmp(header.magic, WAL_MAGIC, sizeof(header.magic)) != 0 || header.generation != generation) {
+        return 0;
+    }
+    
+    // Locate frames; a length running past the end of file marks a torn tail write
+    vector<pair<size_t, uint32_t>> frames;
+    size_t position = sizeof(WalHeader);
+    while (file.size - position >= 2 * sizeof(uint32_t)) {
+        uint32_t length;
+        memcpy(&length, file.data + position, sizeof(length));
+        if (length > file.size - position - 2 * sizeof(uint32_t)) {
+            break;
+        }
+        frames.push_back({position, length});
+        position += 2 * sizeof(uint32_t) + length;
+    }
+    
+    vector<WalRecord> records(frames.size());
+    vector<char> intact(frames.size(), 0);
+    parallelFor(frames.size(), workerCount(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const char* frame = file.data + frames[i].first;
+            uint32_t checksum;
+            memcpy(&checksum, frame + sizeof(uint32_t), sizeof(checksum));
+            const char* payload = frame + 2 * sizeof(uint32_t);
+            intact[i] = crc32(payload, frames[i].second) == checksum 
+                     && decodeWalRecord(payload, frames[i].second, records[i]);
+        }
+    });
+    // Only the prefix up to the first damaged record is trustworthy
+    size_t usable = find(intact.begin(), intact.end(), 0) - intact.begin();
+    
+    // Records are applied to the live tables alone; the versioned ones catch up in one resync
+    markVersionedTablesStale();
+    unsigned workers = workerCount();
+    vector<vector<const WalRecord*>> partitions(workers);
+    for (size_t i = 0; i < usable; ++i) {
+        applyStructure(records[i]);
+        if (hasFieldUpdate(records[i])) {
+            uint64_t key = uint64_t(records[i].account_id) * 2 + (records[i].role == RenterRole::Staff);
+            partitions[((key * 0x9E3779B97F4A7C15ULL) >> 40) % workers].push_back(&records[i]);
+        }
+    }
+    parallelFor(workers, workers, [&](size_t begin, size_t end) {
+        for (size_t partition = begin; partition < end; ++partition) {
+            for (const WalRecord* record : partitions[partition]) {
+                applyFields(*record);
+            }
+        }
+    });
+    return usable;
+}
+
+// Persist the current state and restart the log under the next generation
+bool checkpoint(const string& snapshot_path) {
+    if (!transaction_log.commit()) {
+        return false;
+    }
+    ++wal_generation;
+    if (!SnapshotFile::save(snapshot_path)) {
+        --wal_generation;
+        return false;
+    }
+    return !transaction_log.isOpen() || transaction_log.restart(wal_generation);
+}
+
+//======================= CSV IMPORT =======================//
+
+// Bulk onboarding from CSV files. The file is memory-mapped and cut into one
+// chunk per worker at line boundaries; workers parse and validate their chunk
+// in place, keeping views into the mapping instead of copying fields. Valid
+// rows are then inserted on one thread in file order, so IDs follow the file
+// and every index and log record is written exactly as an interactive add.
+// Fields are plain comma-separated values without quoting:
+//   vehicles:        brand,model,rent,price,seats,color[,condition]
+//   clients, staff:  name,password
+// A first line starting with "brand," or "name," is a header and is skipped.
+enum class ImportKind {
+    Vehicles,
+    Clients,
+    Staff
+};
+
+struct ImportError {
+    size_t line;
+    string message;
+};
+
+struct ImportReport {
+    bool opened = false;
+    size_t rows = 0;       // non-blank data lines
+    size_t imported = 0;
+    vector<ImportError> errors;  // in line order
+};
+
+// A parsed row; texts are brand/model/color or name/password and point into the mapped file
+struct ImportRow {
+    size_t line;
+    string_view texts[3];
+    int numbers[4];  // rent, price, seats, condition
+};
+
+struct ImportChunk {
+    const char* begin;
+    const char* end;
+    size_t lines = 0;  // line numbers below are relative to the chunk until the chunks are stitched
+    vector<ImportRow> rows;
+    vector<ImportError> errors;
+};
+
+bool isCsvWord(string_view text) {
+    return !text.empty() && none_of(text.begin(), text.end(), [](char c) { return isspace((unsigned char)c); });
+}
+
+// Parse and validate one line; on failure error says why
+bool parseImportRow(ImportKind kind, string_view line, ImportRow& row, string& error) {
+    const int max_fields = 7;
+    string_view fields[max_fields];
+    int field_count = 0;
+    size_t start = 0;
+    while (true) {
+        size_t comma = line.find(',', start);
+        if (field_count == max_fields) {
+            field_count = max_fields + 1;
+            break;
+        }
+        fields[field_count++] = line.substr(start, comma == string_view::npos ? string_view::npos : comma - start);
+        if (comma == string_view::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    
+    if (kind != ImportKind::Vehicles) {
+        if (field_count != 2) {
+            error = "expected 2 fields (name,password), found " + to_string(field_count);
+            return false;
+        }
+        if (!isCsvWord(fields[0]) || !isCsvWord(fields[1])) {
+            error = "name and password must be non-empty and contain no spaces";
+            return false;
+        }
+        row.texts[0] = fields[0];
+        row.texts[1] = fields[1];
+        return true;
+    }
+    
+    if (field_count != 6 && field_count != 7) {
+        error = "expected 6 or 7 fields (brand,model,rent,price,seats,color[,condition]), found " + to_string(field_count);
+        return false;
+    }
+    static const char* const text_names[] = {"brand", "model", "color"};
+    const int text_columns[] = {0, 1, 5};
+    for (int i = 0; i < 3; ++i) {
+        row.texts[i] = fields[text_columns[i]];
+        if (!isCsvWord(row.texts[i])) {
+            error = string(text_names[i]) + " must be non-empty and contain no spaces";
+            return false;
+        }
+    }
+    static const char* const number_names[] = {"rent", "price", "seats", "condition"};
+    const int number_columns[] = {2, 3, 4, 6};
+    const int minimums[] = {1, 0, 1, 0};
+    row.numbers[3] = 100;
+    for (int i = 0; i < (field_count == 7 ? 4 : 3); ++i) {
+        string_view text = fields[number_columns[i]];
+        if (!parseNumber(text, row.numbers[i]) || row.numbers[i] < minimums[i] || (i == 3 && row.numbers[i] > 100)) {
+            error = "invalid " + string(number_names[i]) + " '" + string(text) + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+void parseImportChunk(ImportKind kind, ImportChunk& chunk, bool skip_header) {
+    const char* cursor = chunk.begin;
+    while (cursor < chunk.end) {
+        const char* newline = (const char*)memchr(cursor, '\n', chunk.end - cursor);
+        const char* line_end = newline ? newline : chunk.end;
+        string_view line(cursor, line_end - cursor);
+        cursor = newline ? newline + 1 : chunk.end;
+        ++chunk.lines;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+        if (skip_header && chunk.lines == 1 
+                && line.substr(0, kind == ImportKind::Vehicles ? 6 : 5) == (kind == ImportKind::Vehicles ? "brand," : "name,")) {
+            continue;
+        }
+        ImportRow row;
+        row.line = chunk.lines;
+        string error;
+        if (parseImportRow(kind, line, row, error)) {
+            chunk.rows.push_back(row);
+        } else {
+            chunk.errors.push_back({chunk.lines, move(error)});
+        }
+    }
+}
+
+// Insert one validated row; false with a message when it clashes with existing data
+bool insertImportRow(ImportKind kind, const ImportRow& row, string& error) {
+    if (kind == ImportKind::Vehicles) {
+        Vehicle vehicle(string(row.texts[0]), string(row.texts[1]), row.numbers[0], row.numbers[1], 
+                        row.numbers[2], string(row.texts[2]), row.numbers[3]);
+        addVehicle(vehicle);
+        logVehicleAdded(vehicle.vehicle_id, vehicle);
+        return true;
+    }
+    string name(row.texts[0]);
+    RenterRole role = kind == ImportKind::Clients ? RenterRole::Client : RenterRole::Staff;
+    int AccountIndexEntry::*id_field = role == RenterRole::Client ? &AccountIndexEntry::client_id : &AccountIndexEntry::staff_id;
+    if (findAccountId(name, id_field) != 0) {
+        error = "username '" + name + "' is already taken";
+        return false;
+    }
+    string password(row.texts[1]);
+    int user_id;
+    if (role == RenterRole::Client) {
+        Client client(name, password);
+        addClient(client);
+        user_id = client.user_id;
+    } else {
+        StaffMember staff(name, password);
+        addStaff(staff);
+        user_id = staff.user_id;
+    }
+    logAccountAdded(role, user_id, name, password);
+    return true;
+}
+
+// Import a CSV file. Needs exclusive access; the caller commits the log.
+ImportReport importCsv(ImportKind kind, const string& path, unsigned workers = workerCount()) {
+    ImportReport report;
+    MappedFile file;
+    if (!file.open(path)) {
+        return report;
+    }
+    report.opened = true;
+    
+    // Cut at the first newline after each even split point
+    vector<ImportChunk> chunks;
+    const char* end = file.data + file.size;
+    const char* cursor = file.data;
+    size_t target = max<size_t>(file.size / max(1u, workers), 1 << 16);
+    while (cursor < end) {
+        const char* split = cursor + min<size_t>(target, end - cursor);
+        const char* newline = split < end ? (const char*)memchr(split, '\n', end - split) : nullptr;
+        const char* chunk_end = newline ? newline + 1 : end;
+        ImportChunk chunk;
+        chunk.begin = cursor;
+        chunk.end = chunk_end;
+        chunks.push_back(move(chunk));
+        cursor = chunk_end;
+    }
+    parallelFor(chunks.size(), workers, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            parseImportChunk(kind, chunks[i], i == 0);
+        }
+    });
+    
+    size_t row_count = 0;
+    size_t line_base = 0;
+    for (ImportChunk& chunk : chunks) {
+        for (ImportRow& row : chunk.rows) {
+            row.line += line_base;
+        }
+        for (ImportError& error : chunk.errors) {
+            error.line += line_base;
+        }
+        line_base += chunk.lines;
+        row_count += chunk.rows.size();
+    }
+    
+    if (kind == ImportKind::Vehicles) {
+        vehicle_inventory.reserve(vehicle_inventory.size() + row_count);
+    } else if (kind == ImportKind::Clients) {
+        client_database.reserve(client_database.size() + row_count);
+        account_index.reserve(account_index.entry_count + row_count);
+    } else {
+        staff_database.reserve(staff_database.size() + row_count);
+        account_index.reserve(account_index.entry_count + row_count);
+    }
+    for (ImportChunk& chunk : chunks) {
+        report.rows += chunk.rows.size() + chunk.errors.size();
+        string error;
+        for (const ImportRow& row : chunk.rows) {
+            if (insertImportRow(kind, row, error)) {
+                ++report.imported;
+            } else {
+                chunk.errors.push_back({row.line, move(error)});
+            }
+        }
+        // Parse errors come first in each chunk; restore line order before appending
+        sort(chunk.errors.begin(), chunk.errors.end(), 
+             [](const ImportError& a, const ImportError& b) { return a.line < b.line; });
+        move(chunk.errors.begin(), chunk.errors.end(), back_inserter(report.errors));
+    }
+    return report;
+}
+
+bool parseImportKind(string_view text, ImportKind& kind) {
+    if (text == "vehicles") {
+        kind = ImportKind::Vehicles;
+    } else if (text == "clients") {
+        kind = ImportKind::Clients;
+    } else if (text == "staff") {
+        kind = ImportKind::Staff;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Print the first few errors as path:line: message
+void printImportErrors(ostream& out, const string& path, const ImportReport& report, size_t limit = 10) {
+    for (size_t i = 0; i < report.errors.size() && i < limit; ++i) {
+        out << path << ":" << report.errors[i].line << ": " << report.errors[i].message << "\n";
+    }
+    if (report.errors.size() > limit) {
+        out << "... and " << report.errors.size() - limit << " more error(s)\n";
+    }
+}
+
+void Administrator::importRecords() {
+    cout << "Import (vehicles/clients/staff): ";
+    string kind_text;
+    cin >> kind_text;
+    ImportKind kind;
+    if (!parseImportKind(kind_text, kind)) {
+        cout << "Invalid selection\n\n\n";
+        return;
+    }
+    cout << "Enter file name: ";
+    string path;
+    cin >> path;
+    
+    auto start = chrono::steady_clock::now();
+    ImportReport report = importCsv(kind, path);
+    commitTransactions();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    if (!report.opened) {
+        cout << "Cannot read " << path << "\n\n\n";
+        return;
+    }
+    printImportErrors(cout, path, report);
+    cout << "Imported " << report.imported << " of " << report.rows << " row(s) in " 
+         << int(elapsed.count() * 1000) << " ms\n\n\n";
+}
+
+//======================= REPORTS =======================//
+
+// Read-only summaries and listings over the fleet and account tables. Each
+// summary splits its table into one contiguous range per worker, aggregates
+// into worker-local totals and merges them once at the end. Rental state,
+// revenue, dues and ratings come from one TableSnapshot, so a report describes
+// a single moment and runs alongside rent, return and pay traffic without
+// pausing it or taking their locks. Callers with exclusive access run
+// syncVersionedTables() first; admin edits that change table structure still
+// need exclusive access.
+enum class ReportKind { Revenue, Dues, Utilization, TopRenters, Vehicles, Clients, Staff };
+enum class ReportFormat { Csv, Json };
+
+bool parseReportKind(string_view text, ReportKind& kind) {
+    if (text == "revenue") {
+        kind = ReportKind::Revenue;
+    } else if (text == "dues") {
+        kind = ReportKind::Dues;
+    } else if (text == "utilization") {
+        kind = ReportKind::Utilization;
+    } else if (text == "top-renters") {
+        kind = ReportKind::TopRenters;
+    } else if (text == "vehicles") {
+        kind = ReportKind::Vehicles;
+    } else if (text == "clients") {
+        kind = ReportKind::Clients;
+    } else if (text == "staff") {
+        kind = ReportKind::Staff;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseReportFormat(string_view text, ReportFormat& format) {
+    if (text == "csv") {
+        format = ReportFormat::Csv;
+    } else if (text == "json") {
+        format = ReportFormat::Json;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+struct ReportTable {
+    string name;
+    vector<string> columns;
+    vector<bool> numeric;  // per column: written unquoted in JSON
+    vector<vector<string>> rows;
+};
+
+class ReportBuilder {
+public:
+    static constexpr size_t TOP_RENTERS = 10;
+
+    static ReportTable build(ReportKind kind, unsigned workers = workerCount());
+
+private:
+    // Per pool code: vehicles, vehicles out on rent, revenue billed
+    struct FleetTotals {
+        vector<int64_t> vehicles;
+        vector<int64_t> rented;
+        vector<int64_t> revenue;
+
+        explicit FleetTotals(size_t codes) : vehicles(codes), rented(codes), revenue(codes) {}
+    };
+
+    // Dues buckets by number of decimal digits: "<0", "0", "1-9", "10-99", ...
+    static const int DUES_BUCKETS = 12;
+
+    struct RenterScore {
+        double rating;
+        int user_id;
+        size_t slot;
+    };
+
+    static FleetTotals fleetTotals(const TableSnapshot& snapshot, const vector<uint32_t>& codes, size_t code_count, 
+                                   unsigned workers);
+    static ReportTable revenueByBrand(const TableSnapshot& snapshot, unsigned workers);
+    static ReportTable utilizationByModel(const TableSnapshot& snapshot, unsigned workers);
+    template <typename Account>
+    static void addDuesDistribution(const TableSnapshot& snapshot, const vector<Account>& accounts, const char* role, 
+                                    ReportTable& table, unsigned workers);
+    template <typename Account>
+    static void addTopRenters(const TableSnapshot& snapshot, const vector<Account>& accounts, const char* role, 
+                              ReportTable& table, unsigned workers);
+    static ReportTable vehicleListing(const TableSnapshot& snapshot);
+    template <typename Account>
+    static ReportTable accountListing(const TableSnapshot& snapshot, const vector<Account>& accounts, const char* name);
+};
+
+ReportBuilder::FleetTotals ReportBuilder::fleetTotals(const TableSnapshot& snapshot, const vector<uint32_t>& codes, 
+                                                      size_t code_count, unsigned workers) {
+    const FleetStore& fleet = vehicle_inventory;
+    FleetTotals totals(code_count);
+    mutex merge_mutex;
+    parallelFor(min(fleet.size(), snapshot.vehicleCount()), workers, [&](size_t begin, size_t end) {
+        FleetTotals local(code_count);
+        for (size_t slot = begin; slot < end; ++slot) {
+            if (!fleet.isLive(slot)) {
+                continue;
+            }
+            const VehicleVersion& vehicle = snapshot.vehicle(slot);
+            uint32_t code = codes[slot];
+            ++local.vehicles[code];
+            local.rented[code] += vehicle.rented;
+            local.revenue[code] += vehicle.revenue;
+        }
+        lock_guard<mutex> guard(merge_mutex);
+        for (size_t code = 0; code < code_count; ++code) {
+            totals.vehicles[code] += local.vehicles[code];
+            totals.rented[code] += local.rented[code];
+            totals.revenue[code] += local.revenue[code];
+        }
+    });
+    return totals;
+}
+
+ReportTable ReportBuilder::revenueByBrand(const TableSnapshot& snapshot, unsigned workers) {
+    const FleetStore& fleet = vehicle_inventory;
+    FleetTotals totals = fleetTotals(snapshot, fleet.brand_code, fleet.brand_pool.size(), workers);
+    vector<uint32_t> order;
+    for (uint32_t code = 0; code < fleet.brand_pool.size(); ++code) {
+        if (totals.vehicles[code] > 0) {
+            order.push_back(code);
+        }
+    }
+    sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return totals.revenue[a] != totals.revenue[b] ? totals.revenue[a] > totals.revenue[b] 
+                                                      : fleet.brand_pool.text(a) < fleet.brand_pool.text(b);
+    });
+    
+    ReportTable table{"revenue", {"brand", "vehicles", "rented", "revenue"}, {false, true, true, true}, {}};
+    for (uint32_t code : order) {
+        table.rows.push_back({string(fleet.brand_pool.text(code)), to_string(totals.vehicles[code]), 
+                              to_string(totals.rented[code]), to_string(totals.revenue[code])});
+    }
+    return table;
+}
+
+ReportTable ReportBuilder::utilizationByModel(const TableSnapshot& snapshot, unsigned workers) {
+    const FleetStore& fleet = vehicle_inventory;
+    FleetTotals totals = fleetTotals(snapshot, fleet.model_code, fleet.model_pool.size(), workers);
+    vector<uint32_t> order;
+    for (uint32_t code = 0; code < fleet.model_pool.size(); ++code) {
+        if (totals.vehicles[code] > 0) {
+            order.push_back(code);
+        }
+    }
+    // Busiest first; compare rented/vehicles as cross products to stay exact
+    sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        int64_t left = totals.rented[a] * totals.vehicles[b];
+        int64_t right = totals.rented[b] * totals.vehicles[a];
+        return left != right ? left > right : fleet.model_pool.text(a) < fleet.model_pool.text(b);
+    });
+    
+    ReportTable table{"utilization", {"model", "vehicles", "rented", "utilization_pct"}, {false, true, true, true}, {}};
+    char percent[32];
+    for (uint32_t code : order) {
+        snprintf(percent, sizeof(percent), "%.1f", 100.0 * totals.rented[code] / totals.vehicles[code]);
+        table.rows.push_back({string(fleet.model_pool.text(code)), to_string(totals.vehicles[code]), 
+                              to_string(totals.rented[code]), percent});
+    }
+    return table;
+}
+
+template <typename Account>
+void ReportBuilder::addDuesDistribution(const TableSnapshot& snapshot, const vector<Account>& accounts, 
+                                        const char* role, ReportTable& table, unsigned workers) {
+    using Policy = typename Account::PolicyType;
+    int64_t counts[DUES_BUCKETS] = {};
+    int64_t sums[DUES_BUCKETS] = {};
+    mutex merge_mutex;
+    parallelFor(accounts.size(), workers, [&](size_t begin, size_t end) {
+        int64_t local_counts[DUES_BUCKETS] = {};
+        int64_t local_sums[DUES_BUCKETS] = {};
+        for (size_t slot = begin; slot < end; ++slot) {
+            const Account& account = accounts[slot];
+            if (account.user_id == 0) {
+                continue;
+            }
+            int dues = snapshot.account(Policy::ROLE, account.user_id).dues;
+            int bucket = 1;
+            if (dues < 0) {
+                bucket = 0;
+            } else {
+                for (int remaining = dues; remaining > 0; remaining /= 10) {
+                    ++bucket;
+                }
+            }
+            ++local_counts[bucket];
+            local_sums[bucket] += dues;
+        }
+        lock_guard<mutex> guard(merge_mutex);
+        for (int bucket = 0; bucket < DUES_BUCKETS; ++bucket) {
+            counts[bucket] += local_counts[bucket];
+            sums[bucket] += local_sums[bucket];
+        }
+    });
+    
+    for (int bucket = 0; bucket < DUES_BUCKETS; ++bucket) {
+        if (counts[bucket] == 0) {
+            continue;
+        }
+        string range = bucket == 0 ? "<0" : "0";
+        if (bucket > 1) {
+            string low = "1" + string(bucket - 2, '0');
+            range = low + "-" + string(bucket - 1, '9');
+        }
+        table.rows.push_back({role, range, to_string(counts[bucket]), to_string(sums[bucket])});
+    }
+}
+
+template <typename Account>
+void ReportBuilder::addTopRenters(const TableSnapshot& snapshot, const vector<Account>& accounts, const char* role, 
+                                  ReportTable& table, unsigned workers) {
+    using Policy = typename Account::PolicyType;
+    auto better = [](const RenterScore& a, const RenterScore& b) {
+        return a.rating != b.rating ? a.rating > b.rating : a.user_id < b.user_id;
+    };
+    vector<RenterScore> best;
+    mutex merge_mutex;
+    parallelFor(accounts.size(), workers, [&](size_t begin, size_t end) {
+        vector<RenterScore> local;
+        for (size_t slot = begin; slot < end; ++slot) {
+            const Account& account = accounts[slot];
+            if (account.user_id == 0) {
+                continue;
+            }
+            double rating = snapshot.account(Policy::ROLE, account.user_id).rating;
+            // Heap of this range's leaders with the weakest on top
+            RenterScore score{rating, account.user_id, slot};
+            if (local.size() < TOP_RENTERS) {
+                local.push_back(score);
+                push_heap(local.begin(), local.end(), better);
+            } else if (better(score, local.front())) {
+                pop_heap(local.begin(), local.end(), better);
+                local.back() = score;
+                push_heap(local.begin(), local.end(), better);
+            }
+        }
+        lock_guard<mutex> guard(merge_mutex);
+        best.insert(best.end(), local.begin(), local.end());
+    });
+    
+    size_t kept = min(best.size(), TOP_RENTERS);
+    partial_sort(best.begin(), best.begin() + kept, best.end(), better);
+    char rating_text[32];
+    for (size_t rank = 0; rank < kept; ++rank) {
+        const Account& account = accounts[best[rank].slot];
+        snprintf(rating_text, sizeof(rating_text), "%g", best[rank].rating);
+        table.rows.push_back({role, to_string(rank + 1), to_string(account.user_id), account.username, 
+                              rating_text, to_string(snapshot.account(Policy::ROLE, account.user_id).dues)});
+    }
+}
+
+// Every live vehicle with its rental state; renter_id is 0 for vehicles nobody holds
+ReportTable ReportBuilder::vehicleListing(const TableSnapshot& snapshot) {
+    const FleetStore& fleet = vehicle_inventory;
+    ReportTable table{"vehicles", {"id", "brand", "model", "available", "renter_role", "renter_id", "deadline", "revenue"}, 
+                      {true, false, false, true, false, true, true, true}, {}};
+    size_t rows = min(fleet.size(), snapshot.vehicleCount());
+    table.rows.reserve(fleet.liveCount());
+    for (size_t slot = 0; slot < rows; ++slot) {
+        if (!fleet.isLive(slot)) {
+            continue;
+        }
+        const VehicleVersion& vehicle = snapshot.vehicle(slot);
+        const char* role = vehicle.holder_id == 0 ? "" : vehicle.holder_role == RenterRole::Client ? "client" : "staff";
+        table.rows.push_back({to_string(fleet.vehicle_id[slot]), string(fleet.brand(slot)), string(fleet.model(slot)), 
+                              to_string(!vehicle.rented), role, to_string(vehicle.holder_id), 
+                              to_string(vehicle.deadline), to_string(vehicle.revenue)});
+    }
+    return table;
+}
+
+template <typename Account>
+ReportTable ReportBuilder::accountListing(const TableSnapshot& snapshot, const vector<Account>& accounts, 
+                                          const char* name) {
+    using Policy = typename Account::PolicyType;
+    ReportTable table{name, {"id", "name", "dues", "rating", "vehicles"}, {true, false, true, true, true}, {}};
+    char rating_text[32];
+    for (const Account& account : accounts) {
+        if (account.user_id == 0) {
+            continue;
+        }
+        AccountVersion version = snapshot.account(Policy::ROLE, account.user_id);
+        snprintf(rating_text, sizeof(rating_text), "%g", version.rating);
+        table.rows.push_back({to_string(account.user_id), account.username, to_string(version.dues), rating_text, 
+                              to_string(version.vehicles_held)});
+    }
+    return table;
+}
+
+ReportTable ReportBuilder::build(ReportKind kind, unsigned workers) {
+    TableSnapshot snapshot;
+    switch (kind) {
+        case ReportKind::Revenue:
+            return revenueByBrand(snapshot, workers);
+        case ReportKind::Utilization:
+            return utilizationByModel(snapshot, workers);
+        case ReportKind::Dues: {
+            ReportTable table{"dues", {"role", "dues_range", "accounts", "total_dues"}, {false, false, true, true}, {}};
+            addDuesDistribution(snapshot, client_database, "client", table, workers);
+            addDuesDistribution(snapshot, staff_database, "staff", table, workers);
+            return table;
+        }
+        case ReportKind::TopRenters: {
+            ReportTable table{"top-renters", {"role", "rank", "id", "name", "rating", "dues"}, 
+                              {false, true, true, false, true, true}, {}};
+            addTopRenters(snapshot, client_database, "client", table, workers);
+            addTopRenters(snapshot, staff_database, "staff", table, workers);
+            return table;
+        }
+        case ReportKind::Vehicles:
+            return vehicleListing(snapshot);
+        case ReportKind::Clients:
+            return accountListing(snapshot, client_database, "clients");
+        case ReportKind::Staff:
+            return accountListing(snapshot, staff_database, "staff");
+    }
+    return ReportTable{};
+}
+
+// CSV with a header row; cells holding a comma, quote or line break are quoted
+void writeCsvReport(const ReportTable& table, string& out) {
+    auto cell = [&out](const string& value) {
+        if (value.find_first_of(",\"\r\n") == string::npos) {
+            out += value;
+            return;
+        }
+        out += '"';
+        for (char c : value) {
+            if (c == '"') {
+                out += '"';
+            }
+            out += c;
+        }
+        out += '"';
+    };
+    for (size_t column = 0; column < table.columns.size(); ++column) {
+        out += column == 0 ? "" : ",";
+        cell(table.columns[column]);
+    }
+    out += '\n';
+    for (const auto& row : table.rows) {
+        for (size_t column = 0; column < row.size(); ++column) {
+            out += column == 0 ? "" : ",";
+            cell(row[column]);
+        }
+        out += '\n';
+    }
+}
+
+// One JSON object per row, tagged with the report name
+void writeJsonReport(const ReportTable& table, string& out) {
+    auto quoted = [&out](const string& value) {
+        out += '"';
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if ((unsigned char)c < 0x20) {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", (unsigned char)c);
+                out += escape;
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+    };
+    for (const auto& row : table.rows) {
+        out += "{\"report\":";
+        quoted(table.name);
+        for (size_t column = 0; column < row.size(); ++column) {
+            out += ',';
+            quoted(table.columns[column]);
+            out += ':';
+            if (table.numeric[column]) {
+                out += row[column];
+            } else {
+                quoted(row[column]);
+            }
+        }
+        out += "}\n";
+    }
+}
+
+void renderReport(const ReportTable& table, ReportFormat format, string& out) {
+    if (format == ReportFormat::Csv) {
+        writeCsvReport(table, out);
+    } else {
+        writeJsonReport(table, out);
+    }
+}
+
+// Write a report to a file, or to standard output when the path is "-"
+bool saveReport(const ReportTable& table, ReportFormat format, const string& path) {
+    string text;
+    renderReport(table, format, text);
+    if (path == "-") {
+        cout << text << flush;
+        return true;
+    }
+    FILE* output = fopen(path.c_str(), "w");
+    if (output == nullptr) {
+        return false;
+    }
+    bool written = fwrite(text.data(), 1, text.size(), output) == text.size();
+    return fclose(output) == 0 && written;
+}
+
+void Administrator::showReports() {
+    cout << "Report (revenue/dues/utilization/top-renters/vehicles/clients/staff): ";
+    string kind_text;
+    cin >> kind_text;
+    ReportKind kind;
+    if (!parseReportKind(kind_text, kind)) {
+        cout << "Invalid selection\n\n\n";
+        return;
+    }
+    
+    ensureVersionedTables();
+    auto start = chrono::steady_clock::now();
+    ReportTable table = ReportBuilder::build(kind);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    for (size_t column = 0; column < table.columns.size(); ++column) {
+        cout << (column == 0 ? "" : "\t") << table.columns[column];
+    }
+    cout << "\n";
+    for (const auto& row : table.rows) {
+        for (size_t column = 0; column < row.size(); ++column) {
+            cout << (column == 0 ? "" : "\t") << row[column];
+        }
+        cout << "\n";
+    }
+    cout << table.rows.size() << " row(s) in " << int(elapsed.count() * 1000) << " ms\n";
+    
+    cout << "Save as (csv/json/none): ";
+    string format_text;
+    cin >> format_text;
+    ReportFormat format;
+    if (!parseReportFormat(format_text, format)) {
+        cout << "\n\n";
+        return;
+    }
+    cout << "Enter file name: ";
+    string path;
+    cin >> path;
+    if (saveReport(table, format, path)) {
+        cout << "Report saved to " << path << "\n\n\n";
+    } else {
+        cout << "Cannot write " << path << "\n\n\n";
+    }
+}
+
+//======================= BATCH MODE =======================//
+
+// Line-oriented command stream for driving the engine without prompts. One
+// command per line, fields separated by whitespace; blank lines and lines
+// starting with '#' are skipped. Each command produces one JSON result line:
+//   {"line":3,"op":"rent","status":"ok","value":1000}
+class BatchRunner {
+public:
+    static const size_t COMMIT_INTERVAL = 4096;  // commands per log commit
+    static const int MAX_FIELDS = 8;
+    size_t executed = 0;
+    size_t failed = 0;
+
+    explicit BatchRunner(FILE* output) : output(output) {}
+
+    // Execute one command line; results are held back until the next commit
+    void feed(string_view line);
+    // Commit the log, then release the pending results
+    void finish();
+    // Read commands until end of input
+    void run(FILE* input);
+
+    // Split a line into whitespace-separated fields. Returns the field count,
+    // 0 for blank and comment lines, or MAX_FIELDS + 1 when there are too many.
+    static int splitFields(string_view line, string_view* fields);
+    // Run one parsed command against the engine; op is set to its result name
+    static EngineResult execute(const string_view* fields, int field_count, const char*& op);
+    // Append the JSON result line for one command
+    static void formatResult(string& out, size_t line_number, const char* op, const EngineResult& result);
+
+private:
+    FILE* output;
+    string results;
+    size_t line_number = 0;
+    size_t pending = 0;
+
+    void report(const char* op, const EngineResult& result);
+};
+
+bool parseRole(string_view text, RenterRole& role) {
+    if (text == "client") {
+        role = RenterRole::Client;
+    } else if (text == "staff") {
+        role = RenterRole::Staff;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// MIN-MAX, where either side may be left out to leave it unbounded
+bool parseRange(string_view text, int& low, int& high) {
+    size_t dash = text.find('-');
+    if (dash == string_view::npos) {
+        return false;
+    }
+    string_view low_text = text.substr(0, dash), high_text = text.substr(dash + 1);
+    return (low_text.empty() || parseNumber(low_text, low)) && (high_text.empty() || parseNumber(high_text, high));
+}
+
+// One search term: brand=, model=, color=, seats=MIN-MAX, rent=MIN-MAX, condition=MIN or available
+bool parseSearchTerm(string_view term, FleetSearch& search) {
+    if (term == "available") {
+        search.available_only = true;
+        return true;
+    }
+    size_t equals = term.find('=');
+    if (equals == string_view::npos) {
+        return false;
+    }
+    string_view key = term.substr(0, equals), value = term.substr(equals + 1);
+    if (key == "brand") {
+        search.setBrand(value);
+    } else if (key == "model") {
+        search.setModel(value);
+    } else if (key == "color") {
+        search.setColor(value);
+    } else if (key == "seats") {
+        return parseRange(value, search.min_seats, search.max_seats);
+    } else if (key == "rent") {
+        return parseRange(value, search.min_rent, search.max_rent);
+    } else if (key == "condition") {
+        return parseNumber(value, search.min_condition);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int BatchRunner::splitFields(string_view line, string_view* fields) {
+    int field_count = 0;
+    size_t position = 0;
+    while (position < line.size()) {
+        while (position < line.size() && isspace((unsigned char)line[position])) {
+            ++position;
+        }
+        size_t start = position;
+        while (position < line.size() && !isspace((unsigned char)line[position])) {
+            ++position;
+        }
+        if (position == start) {
+            break;
+        }
+        if (field_count == MAX_FIELDS) {
+            field_count = MAX_FIELDS + 1;
+            break;
+        }
+        fields[field_count++] = line.substr(start, position - start);
+    }
+    return field_count == 0 || fields[0][0] == '#' ? 0 : field_count;
+}
+
+void BatchRunner::feed(string_view line) {
+    ++line_number;
+    string_view fields[MAX_FIELDS];
+    int field_count = splitFields(line, fields);
+    if (field_count == 0) {
+        return;
+    }
+    
+    const char* op = "unknown";
+    EngineResult result{OperationStatus::InvalidRequest, 0};
+    if (field_count <= MAX_FIELDS) {
+        // Commands run one at a time here, so a report can bring the versioned tables up to date first
+        if (fields[0] == "report") {
+            ensureVersionedTables();
+            // A report on standard output must not overtake the result lines still held back
+            if (field_count == 4 && fields[3] == "-") {
+                finish();
+            }
+        }
+        result = execute(fields, field_count, op);
+    }
+    report(op, result);
+    if (++pending >= COMMIT_INTERVAL) {
+        finish();
+    }
+}
+
+EngineResult BatchRunner::execute(const string_view* fields, int field_count, const char*& op) {
+    const EngineResult invalid{OperationStatus::InvalidRequest, 0};
+    string_view command = fields[0];
+    RenterRole role;
+    int id = 0;
+    int number = 0;
+    
+    if (command == "rent" || command == "return") {
+        op = command == "rent" ? "rent" : "return";
+        if (field_count != 4 || !parseRole(fields[1], role) || !parseNumber(fields[2], id) 
+                || !parseNumber(fields[3], number)) {
+            return invalid;
+        }
+        RentalRequest request{role, id, number};
+        return command == "rent" ? rental_engine.rent(request) : rental_engine.returnVehicle(request);
+    }
+    if (command == "pay") {
+        op = "pay";
+        if (field_count != 4 || !parseRole(fields[1], role) || !parseNumber(fields[2], id) 
+                || !parseNumber(fields[3], number)) {
+            return invalid;
+        }
+        return rental_engine.pay({role, id, number});
+    }
+    if (command == "dues") {
+        op = "dues";
+        if (field_count != 3 || !parseRole(fields[1], role) || !parseNumber(fields[2], id)) {
+            return invalid;
+        }
+        return rental_engine.dues({role, id});
+    }
+    if (command == "login" || command == "add-account") {
+        op = command == "login" ? "login" : "add-account";
+        if (field_count != 4 || !parseRole(fields[1], role)) {
+            return invalid;
+        }
+        Credentials credentials{role, string(fields[2]), string(fields[3])};
+        return command == "login" ? rental_engine.login(credentials) : rental_engine.addAccount(credentials);
+    }
+    if (command == "remove-account") {
+        op = "remove-account";
+        if (field_count != 3 || !parseRole(fields[1], role) || !parseNumber(fields[2], id)) {
+            return invalid;
+        }
+        return rental_engine.removeAccount({role, id});
+    }
+    if (command == "modify-account") {
+        op = "modify-account";
+        if (field_count != 5 || !parseRole(fields[1], role) || !parseNumber(fields[2], id)) {
+            return invalid;
+        }
+        AccountUpdate update{{role, id}, AccountField::Name, 0, string(fields[4])};
+        string_view field = fields[3];
+        if (field == "password") {
+            update.field = AccountField::Password;
+        } else if (field == "dues" || field == "rating") {
+            update.field = field == "dues" ? AccountField::Dues : AccountField::Rating;
+            if (!parseNumber(fields[4], update.number)) {
+                return invalid;
+            }
+        } else if (field != "name") {
+            return invalid;
+        }
+        return rental_engine.updateAccount(update);
+    }
+    if (command == "add-vehicle") {
+        op = "add-vehicle";
+        if (field_count != 7) {
+            return invalid;
+        }
+        VehicleSpec spec{string(fields[1]), string(fields[2]), 0, 0, 0, string(fields[6])};
+        if (!parseNumber(fields[3], spec.rent) || !parseNumber(fields[4], spec.price) 
+                || !parseNumber(fields[5], spec.seats)) {
+            return invalid;
+        }
+        return rental_engine.addVehicle(spec);
+    }
+    if (command == "reserve") {
+        op = "reserve";
+        int64_t times[2];
+        if (field_count != 6 || !parseRole(fields[1], role) || !parseNumber(fields[2], id) 
+                || !parseNumber(fields[3], number) || !parseTime(fields[4], times[0]) || !parseTime(fields[5], times[1])) {
+            return invalid;
+        }
+        return rental_engine.reserve({role, id, number, (time_t)times[0], (time_t)times[1]});
+    }
+    if (command == "cancel-reservation") {
+        op = "cancel-reservation";
+        if (field_count != 4 || !parseRole(fields[1], role) || !parseNumber(fields[2], id) 
+                || !parseNumber(fields[3], number)) {
+            return invalid;
+        }
+        return rental_engine.cancelReservation({role, id}, number);
+    }
+    if (command == "available") {
+        op = "available";
+        int64_t times[2];
+        if (field_count != 3 || !parseTime(fields[1], times[0]) || !parseTime(fields[2], times[1]) 
+                || times[0] >= times[1]) {
+            return invalid;
+        }
+        SelectionBitmap selection;
+        selectFreeVehicles(FleetFilter(), (time_t)times[0], (time_t)times[1], selection);
+        return {OperationStatus::Success, (int64_t)countSelected(selection)};
+    }
+    if (command == "search") {
+        op = "search";
+        FleetSearch search;
+        for (int field = 1; field < field_count; ++field) {
+            if (!parseSearchTerm(fields[field], search)) {
+                return invalid;
+            }
+        }
+        SelectionBitmap selection;
+        searchFleet(search, selection);
+        return {OperationStatus::Success, (int64_t)countSelected(selection)};
+    }
+    if (command == "overdue") {
+        op = "overdue";
+        if (field_count != 1) {
+            return invalid;
+        }
+        overdue_tracker.advance(time(0));
+        return {OperationStatus::Success, (int64_t)overdue_tracker.overdueRentals().size()};
+    }
+    if (command == "accrue") {
+        op = "accrue";
+        int64_t now = time(0);
+        if (field_count > 2 || (field_count == 2 && !parseTime(fields[1], now))) {
+            return invalid;
+        }
+        return rental_engine.accrueLateFees((time_t)now);
+    }
+    if (command == "import") {
+        op = "import";
+        ImportKind kind;
+        if (field_count != 3 || !parseImportKind(fields[1], kind)) {
+            return invalid;
+        }
+        string path(fields[2]);
+        ImportReport report = importCsv(kind, path);
+        printImportErrors(cerr, path, report);
+        return {report.opened ? OperationStatus::Success : OperationStatus::InvalidRequest, (int64_t)report.imported};
+    }
+    if (command == "report") {
+        op = "report";
+        ReportKind kind;
+        ReportFormat format;
+        if (field_count != 4 || !parseReportKind(fields[1], kind) || !parseReportFormat(fields[2], format)) {
+            return invalid;
+        }
+        ReportTable table = ReportBuilder::build(kind);
+        bool saved = saveReport(table, format, string(fields[3]));
+        return {saved ? OperationStatus::Success : OperationStatus::InvalidRequest, (int64_t)table.rows.size()};
+    }
+    if (command == "compact") {
+        op = "compact";
+        if (field_count != 1) {
+            return invalid;
+        }
+        int64_t reclaimed = vehicle_inventory.dead_rows + dead_client_rows + dead_staff_rows;
+        compactTables();
+        return {OperationStatus::Success, reclaimed};
+    }
+    if (command == "metrics") {
+        op = "metrics";
+        if (field_count != 2) {
+            return invalid;
+        }
+        return {dumpOperationMetrics(string(fields[1])) ? OperationStatus::Success : OperationStatus::InvalidRequest, 0};
+    }
+    if (command == "remove-vehicle") {
+        op = "remove-vehicle";
+        if (field_count != 2 || !parseNumber(fields[1], id)) {
+            return invalid;
+        }
+        return rental_engine.removeVehicle(id);
+    }
+    if (command == "modify-vehicle") {
+        op = "modify-vehicle";
+        if (field_count != 4 || !parseNumber(fields[1], id)) {
+            return invalid;
+        }
+        static const pair<string_view, VehicleField> text_fields[] = {
+            {"brand", VehicleField::Brand}, {"model", VehicleField::Model}, {"color", VehicleField::Color}};
+        static const pair<string_view, VehicleField> number_fields[] = {
+            {"rent", VehicleField::Rent}, {"price", VehicleField::Price}, 
+            {"seats", VehicleField::Seats}, {"condition", VehicleField::Condition}};
+        for (const auto& [name, field] : text_fields) {
+            if (fields[2] == name) {
+                return rental_engine.updateVehicle({id, field, 0, string(fields[3])});
+            }
+        }
+        if (!parseNumber(fields[3], number)) {
+            return invalid;
+        }
+        if (fields[2] == "status") {
+            return rental_engine.setVehicleStatus(id, number != 0);
+        }
+        for (const auto& [name, field] : number_fields) {
+            if (fields[2] == name) {
+                return rental_engine.updateVehicle({id, field, number, ""});
+            }
+        }
+        return invalid;
+    }
+    return invalid;
+}
+
+void BatchRunner::formatResult(string& out, size_t line_number, const char* op, const EngineResult& result) {
+    char buffer[160];
+    int length = snprintf(buffer, sizeof(buffer), "{\"line\":%zu,\"op\":\"%s\",\"status\":\"%s\",\"value\":%lld}\n",
+                          line_number, op, statusName(result.status), (long long)result.value);
+    out.append(buffer, length);
+}
+
+void BatchRunner::report(const char* op, const EngineResult& result) {
+    formatResult(results, line_number, op, result);
+    ++executed;
+    if (result.status != OperationStatus::Success) {
+        ++failed;
+    }
+}
+
+void BatchRunner::finish() {
+    overdue_tracker.advance(time(0));
+    if (!transaction_log.commit()) {
+        fprintf(stderr, "Warning: transaction log write failed, recent changes may not survive a restart\n");
+    }
+    fwrite(results.data(), 1, results.size(), output);
+    fflush(output);
+    results.clear();
+    pending = 0;
+}
+
+void BatchRunner::run(FILE* input) {
+    vector<char> buffer(1 << 20);
+    string partial;
+    size_t bytes;
+    while ((bytes = fread(buffer.data(), 1, buffer.size(), input)) > 0) {
+        string_view chunk(buffer.data(), bytes);
+        size_t newline;
+        while ((newline = chunk.find('\n')) != string_view::npos) {
+            if (partial.empty()) {
+                feed(chunk.substr(0, newline));
+            } else {
+                partial.append(chunk.data(), newline);
+                feed(partial);
+                partial.clear();
+            }
+            chunk.remove_prefix(newline + 1);
+        }
+        partial.append(chunk.data(), chunk.size());
+    }
+    if (!partial.empty()) {
+        feed(partial);
+    }
+    finish();
+}
+
+//======================= LOAD GENERATOR =======================//
+
+// Synthetic operation mixes and binary traces for driving the engine from many
+// threads. A trace is a fixed header followed by 16-byte records; the header
+// keeps the dataset size so a replay can rebuild a matching synthetic dataset.
+enum class LoadOp : uint8_t {
+    Login, Rent, Return, Pay, ModifyVehicle, ModifyAccount, Count
+};
+
+const char* const LOAD_OP_NAMES[] = {"login", "rent", "return", "pay", "modify-vehicle", "modify-account"};
+const size_t LOAD_OP_COUNT = size_t(LoadOp::Count);
+
+struct TraceRecord {
+    LoadOp op;
+    uint8_t role;        // RenterRole
+    uint8_t field;       // VehicleField or AccountField for modify operations
+    uint8_t reserved;
+    int32_t renter_id;
+    int32_t vehicle_id;
+    int32_t number;      // payment amount or new field value
+};
+
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t vehicles;
+    uint64_t clients;
+    uint64_t staff;
+    uint64_t records;
+};
+
+const char TRACE_MAGIC[8] = {'C', 'R', 'T', 'R', 'A', 'C', 'E', '1'};
+const uint32_t TRACE_VERSION = 1;
+static_assert(sizeof(TraceRecord) == 16, "trace records are written as raw 16-byte structs");
+
+struct LoadProfile {
+    size_t operations = 1000000;
+    size_t vehicles = 100000;        // synthetic dataset size when no snapshot is loaded
+    size_t clients = 100000;
+    size_t staff = 10000;
+    double vehicle_skew = 0.99;      // Zipf exponent in [0, 1): 0 is uniform
+    double renter_skew = 0.99;
+    int staff_percent = 10;          // share of renter operations made by staff
+    uint64_t seed = 12345;
+    // Relative weights, indexed by LoadOp
+    int mix[LOAD_OP_COUNT] = {15, 35, 30, 15, 3, 2};
+};
+
+// Parse "rent=40,return=35,..." into the profile's mix. False on unknown names.
+bool parseLoadMix(const string& text, LoadProfile& profile) {
+    stringstream list(text);
+    string entry;
+    while (getline(list, entry, ',')) {
+        size_t separator = entry.find('=');
+        if (separator == string::npos) {
+            return false;
+        }
+        string name = entry.substr(0, separator);
+        size_t op = 0;
+        while (op < LOAD_OP_COUNT && name != LOAD_OP_NAMES[op]) {
+            ++op;
+        }
+        if (op == LOAD_OP_COUNT) {
+            return false;
+        }
+        profile.mix[op] = max(0, convertStringToInt(entry.substr(separator + 1)));
+    }
+    return true;
+}
+
+// Fill the tables with synthetic vehicles, clients ("user<i>") and staff ("staff<i>")
+void populateSyntheticData(size_t vehicles, size_t clients, size_t staff = 0) {
+    clearAllTables();
+    vehicle_inventory.reserve(vehicles);
+    client_database.reserve(clients);
+    for (size_t i = 0; i < vehicles; ++i) {
+        addVehicle(Vehicle("Toyota", "Corolla", 1000 + i % 500, 2000000, 5, "White"));
+    }
+    for (size_t i = 0; i < clients; ++i) {
+        addClient(Client("user" + to_string(i), "pass"));
+    }
+    for (size_t i = 0; i < staff; ++i) {
+        addStaff(StaffMember("staff" + to_string(i), "pass"));
+    }
+}
+
+// xorshift64* generator; small and fast enough to sit in the generation loop
+class LoadRandom {
+public:
+    explicit LoadRandom(uint64_t seed) : state(seed ? seed : 1) {}
+
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    // Uniform in [0, 1)
+    double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    size_t below(size_t bound) { return bound ? next() % bound : 0; }
+
+private:
+    uint64_t state;
+};
+
+// Zipf-distributed ranks in [0, n) with O(1) sampling (Gray et al.,
+// "Quickly generating billion-record synthetic databases"). Rank 0 is hottest.
+class ZipfSampler {
+public:
+    ZipfSampler(size_t n, double skew) : n(max<size_t>(n, 1)), theta(min(max(skew, 0.0), 0.9999)) {
+        if (theta == 0) {
+            return;
+        }
+        for (size_t i = 1; i <= this->n; ++i) {
+            zetan += 1.0 / pow(double(i), theta);
+        }
+        alpha = 1.0 / (1.0 - theta);
+        half_pow_theta = pow(0.5, theta);
+        double zeta2 = 1.0 + half_pow_theta;
+        eta = (1.0 - pow(2.0 / this->n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    size_t sample(LoadRandom& random) const {
+        if (theta == 0) {
+            return random.below(n);
+        }
+        double u = random.unit();
+        double uz = u * zetan;
+        if (uz < 1.0) {
+            return 0;
+        }
+        if (uz < 1.0 + half_pow_theta) {
+            return min<size_t>(1, n - 1);
+        }
+        return min<size_t>(size_t(n * pow(eta * u - eta + 1.0, alpha)), n - 1);
+    }
+
+private:
+    size_t n;
+    double theta;
+    double zetan = 0;
+    double alpha = 0;
+    double half_pow_theta = 0;
+    double eta = 0;
+};
+
+// Generate a trace against the current tables. The generator keeps its own
+// view of which vehicles are out, so returns name vehicles the renter holds
+// and rents of hot vehicles collide the way they would in production.
+vector<TraceRecord> generateTrace(const LoadProfile& profile) {
+    size_t vehicle_count = Vehicle::vehicle_counter.load();
+    size_t client_count = BaseUser::customer_count.load();
+    size_t staff_count = BaseUser::employee_count.load();
+    ZipfSampler hot_vehicles(vehicle_count, profile.vehicle_skew);
+    ZipfSampler heavy_clients(client_count, profile.renter_skew);
+    ZipfSampler heavy_staff(staff_count, profile.renter_skew);
+    LoadRandom random(profile.seed);
+    
+    int total_weight = 0;
+    for (int weight : profile.mix) {
+        total_weight += weight;
+    }
+    
+    // Vehicles already out at the start can be returned by their holders
+    vector<char> rented(vehicle_count + 1, 0);
+    vector<TraceRecord> outstanding;
+    for (size_t vehicle_id = 1; vehicle_id <= vehicle_count && vehicle_id < rental_slot_by_vehicle.size(); ++vehicle_id) {
+        int slot = rental_slot_by_vehicle[vehicle_id];
+        if (slot != -1) {
+            const Rental& rental = rental_table[slot];
+            rented[vehicle_id] = 1;
+            outstanding.push_back({LoadOp::Return, uint8_t(rental.renter_role), 0, 0, rental.renter_id, int(vehicle_id), 0});
+        }
+    }
+    
+    vector<TraceRecord> trace;
+    trace.reserve(profile.operations);
+    while (trace.size() < profile.operations && total_weight > 0) {
+        int pick = int(random.below(total_weight));
+        size_t op = 0;
+        while (pick >= profile.mix[op]) {
+            pick -= profile.mix[op++];
+        }
+        
+        TraceRecord record = {LoadOp(op), uint8_t(RenterRole::Client), 0, 0, 0, 0, 0};
+        bool staff = staff_count > 0 && int(random.below(100)) < profile.staff_percent;
+        record.role = uint8_t(staff ? RenterRole::Staff : RenterRole::Client);
+        record.renter_id = 1 + int(staff ? heavy_staff.sample(random) : heavy_clients.sample(random));
+        record.vehicle_id = 1 + int(hot_vehicles.sample(random));
+        
+        switch (record.op) {
+            case LoadOp::Rent:
+                if (!rented[record.vehicle_id]) {
+                    rented[record.vehicle_id] = 1;
+                    outstanding.push_back(record);
+                    outstanding.back().op = LoadOp::Return;
+                }
+                break;
+            case LoadOp::Return: {
+                if (outstanding.empty()) {
+                    continue;
+                }
+                size_t index = random.below(outstanding.size());
+                record = outstanding[index];
+                outstanding[index] = outstanding.back();
+                outstanding.pop_back();
+                rented[record.vehicle_id] = 0;
+                break;
+            }
+            case LoadOp::Pay:
+                record.number = 500 + int(random.below(4500));
+                break;
+            case LoadOp::ModifyVehicle:
+                record.field = uint8_t(VehicleField::Rent);
+                record.number = 500 + int(random.below(4500));
+                break;
+            case LoadOp::ModifyAccount:
+                record.role = uint8_t(RenterRole::Client);
+                record.renter_id = 1 + int(heavy_clients.sample(random));
+                record.field = uint8_t(AccountField::Rating);
+                record.number = 50 + int(random.below(51));
+                break;
+            default:
+                break;
+        }
+        trace.push_back(record);
+    }
+    return trace;
+}
+
+bool saveTrace(const string& path, const vector<TraceRecord>& trace) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    TraceHeader header;
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(TraceRecord);
+    header.vehicles = Vehicle::vehicle_counter.load();
+    header.clients = BaseUser::customer_count.load();
+    header.staff = BaseUser::employee_count.load();
+    header.records = trace.size();
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(trace.data(), sizeof(TraceRecord), trace.size(), file) == trace.size();
+    return fclose(file) == 0 && written;
+}
+
+bool loadTrace(const string& path, TraceHeader& header, vector<TraceRecord>& trace) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool valid = fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) == 0
+        && header.version == TRACE_VERSION && header.record_size == sizeof(TraceRecord);
+    if (valid) {
+        trace.resize(header.records);
+        valid = fread(trace.data(), sizeof(TraceRecord), trace.size(), file) == trace.size();
+    }
+    fclose(file);
+    return valid;
+}
+
+// Rent, return, pay and login run concurrently; admin edits take this lock
+// exclusively, as the engine requires for everything else
+shared_mutex admin_edit_lock;
+
+EngineResult executeTraceRecord(const TraceRecord& record) {
+    RenterRole role = RenterRole(record.role);
+    switch (record.op) {
+        case LoadOp::Login: {
+            // Synthetic accounts all use "pass"; against a real snapshot most logins fail
+            BaseUser* user = role == RenterRole::Client 
+                ? (BaseUser*)findClient(record.renter_id) : (BaseUser*)findStaff(record.renter_id);
+            if (user == nullptr) {
+                return {OperationStatus::AccountNotFound, 0};
+            }
+            return rental_engine.login({role, user->username, "pass"});
+        }
+        case LoadOp::Rent:
+            return rental_engine.rent({role, record.renter_id, record.vehicle_id});
+        case LoadOp::Return:
+            return rental_engine.returnVehicle({role, record.renter_id, record.vehicle_id});
+        case LoadOp::Pay:
+            return rental_engine.pay({role, record.renter_id, record.number});
+        case LoadOp::ModifyVehicle: {
+            unique_lock<shared_mutex> exclusive(admin_edit_lock);
+            return rental_engine.updateVehicle({record.vehicle_id, VehicleField(record.field), record.number, ""});
+        }
+        case LoadOp::ModifyAccount: {
+            unique_lock<shared_mutex> exclusive(admin_edit_lock);
+            return rental_engine.updateAccount({{role, record.renter_id}, AccountField(record.field), 
+                                                double(record.number), ""});
+        }
+        default:
+            return {OperationStatus::InvalidRequest, 0};
+    }
+}
+
+// Latencies and failures of the operations one replay thread ran
+struct ReplayStats {
+    vector<uint32_t> latencies[LOAD_OP_COUNT];  // nanoseconds
+    size_t failures[LOAD_OP_COUNT] = {};
+
+    void record(LoadOp op, chrono::steady_clock::time_point start, OperationStatus status) {
+        auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        latencies[size_t(op)].push_back(uint32_t(min<long long>(elapsed, UINT32_MAX)));
+        failures[size_t(op)] += (status != OperationStatus::Success);
+    }
+};
+
+// Replay a trace through the shared engine on the given number of threads and
+// return the elapsed seconds. Each renter's operations stay on one thread, in
+// trace order; every operation is committed before the next one starts, so
+// with a transaction log the latencies include group commit.
+double replayShared(const vector<TraceRecord>& trace, int threads, vector<ReplayStats>& stats) {
+    prepareConcurrentRentals();
+    stats.assign(threads, ReplayStats());
+    
+    auto worker = [&](int index) {
+        ReplayStats& own = stats[index];
+        for (const TraceRecord& record : trace) {
+            if (int(uint32_t(record.renter_id) * 2654435761U % uint32_t(threads)) != index) {
+                continue;
+            }
+            auto start = chrono::steady_clock::now();
+            EngineResult result;
+            if (record.op == LoadOp::ModifyVehicle || record.op == LoadOp::ModifyAccount) {
+                result = executeTraceRecord(record);
+            } else {
+                shared_lock<shared_mutex> shared(admin_edit_lock);
+                result = executeTraceRecord(record);
+            }
+            // Only successful changes were logged; logins and failures have nothing to wait for
+            if (result.status == OperationStatus::Success && record.op != LoadOp::Login) {
+                transaction_log.commit();
+            }
+            own.record(record.op, start, result.status);
+        }
+    };
+    
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int index = 0; index < threads; ++index) {
+        workers.emplace_back(worker, index);
+    }
+    for (thread& running : workers) {
+        running.join();
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Throughput and latency percentiles per operation; unit names what ran the
+// replay, e.g. "thread" or "shard"
+void printReplay(size_t operations, int runners, const char* unit, double seconds, vector<ReplayStats>& stats) {
+    auto percentile = [](vector<uint32_t>& samples, double fraction) {
+        size_t rank = min(samples.size() - 1, size_t(fraction * samples.size()));
+        nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        return samples[rank] / 1000.0;
+    };
+    
+    cout << "Replayed " << operations << " operations on " << runners << " " << unit << "(s) in " 
+         << fixed << setprecision(2) << seconds << " s: " << setprecision(0) << operations / seconds << " ops/s\n";
+    cout << left << setw(16) << "Operation" << right << setw(10) << "Count" << setw(10) << "Failed" 
+         << setw(12) << "Ops/s" << setw(12) << "p50 (us)" << setw(12) << "p99 (us)" << setw(12) << "p999 (us)" << endl;
+    for (size_t op = 0; op < LOAD_OP_COUNT; ++op) {
+        vector<uint32_t> samples;
+        size_t failures = 0;
+        for (ReplayStats& own : stats) {
+            samples.insert(samples.end(), own.latencies[op].begin(), own.latencies[op].end());
+            failures += own.failures[op];
+        }
+        if (samples.empty()) {
+            continue;
+        }
+        cout << left << setw(16) << LOAD_OP_NAMES[op] << right << setw(10) << samples.size() << setw(10) << failures 
+             << setw(12) << setprecision(0) << samples.size() / seconds << setprecision(1) 
+             << setw(12) << percentile(samples, 0.50) << setw(12) << percentile(samples, 0.99) 
+             << setw(12) << percentile(samples, 0.999) << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+// Replay a trace on the given number of threads and print what it measured
+void replayTrace(const vector<TraceRecord>& trace, int threads) {
+    threads = max(threads, 1);
+    vector<ReplayStats> stats;
+    double seconds = replayShared(trace, threads, stats);
+    printReplay(trace.size(), threads, "thread", seconds, stats);
+}
+
+//======================= SHARDED EXECUTION =======================//
+
+// Shared-nothing replay for --load --shards N. Vehicles and accounts are split
+// across N shards with one thread each: vehicle, client or staff ID i belongs
+// to shard i % N. For the length of a run each
+// shard takes its rows out of the global tables into arrays only its own
+// thread touches, so shards share no cache lines apart from their inboxes.
+//
+// A trace record runs on the shard of its account. Renting or returning a
+// vehicle another shard owns becomes a message to that shard, which settles
+// the vehicle's side and answers with the charge or penalty; the account's
+// shard then applies it. Each shard keeps up to SHARD_WINDOW such operations
+// in flight, but one renter's operations still run one at a time in trace
+// order. The vehicle's shard writes the log record, so records for one
+// vehicle are in the order its rentals happened.
+//
+// When the run ends the rows go back into the global tables, so snapshots,
+// listings and the portals see the outcome as if the shared engine had run
+// the trace. Login, rent, return and pay are supported, plus the rent and
+// rating/dues edits the load generator produces.
+
+const size_t SHARD_WINDOW = 256;  // cross-shard operations in flight per shard
+
+enum class ShardMessageKind : uint8_t {
+    Claim,    // rent the vehicle to the sender's renter
+    Release,  // take the vehicle back from the sender's renter
+    SetRent,  // change the vehicle's daily rent
+    Reply     // outcome of one of the above, for the sender's ticket
+};
+
+struct ShardMessage {
+    ShardMessageKind kind;
+    RenterRole role;
+    uint32_t from;            // shard to answer
+    uint32_t ticket;          // the sender's in-flight slot
+    int32_t renter_id;
+    int32_t vehicle_id;
+    int32_t number;           // new daily rent; in a reply, the charge or penalty
+    OperationStatus status;
+    double rating_deduction;
+};
+
+// A vehicle while a shard owns it
+struct ShardVehicle {
+    int vehicle_id = 0;        // 0 for IDs no longer in the fleet
+    int daily_rent = 0;
+    int64_t accrued_days = 0;
+    int64_t revenue = 0;       // billed during the run
+    bool rented = false;
+    RenterRole holder_role = RenterRole::Client;
+    int holder_id = 0;         // 0 when rented by an admin override, or not rented
+    time_t start_time = 0;
+    time_t deadline = 0;
+    bool rental_changed = false;
+    vector<Reservation> calendar;
+};
+
+// An account while a shard owns it
+struct ShardAccount {
+    bool exists = false;
+    bool busy = false;         // an operation of this renter is waiting on another shard
+    int dues = 0;
+    double rating = 0;         // whole numbers for clients
+    string password;
+};
+
+template <typename Policy>
+void settleShardReturn(const ShardVehicle& vehicle, time_t now, int& penalty, double& rating_deduction) {
+    penalty = 0;
+    rating_deduction = 0;
+    if (now <= vehicle.deadline) {
+        return;
+    }
+    // Same rule as Renter::returnVehicle: days the nightly accrual charged are not charged again
+    int64_t days_late = max<int64_t>((now - vehicle.deadline) / SECONDS_PER_DAY, vehicle.accrued_days);
+    penalty = lateFeeForDays<Policy>(vehicle.daily_rent, days_late) 
+            - lateFeeForDays<Policy>(vehicle.daily_rent, vehicle.accrued_days);
+    rating_deduction = Policy::RATING_LOSS_PER_DAY * (days_late - vehicle.accrued_days);
+}
+
+class ShardedRuntime {
+public:
+    explicit ShardedRuntime(unsigned shard_count) : count(max(1u, shard_count)) {
+        // Every message that can be outstanding fits, so a push never has to wait
+        for (unsigned index = 0; index < count; ++index) {
+            shards.push_back(make_unique<Shard>((count + 1) * SHARD_WINDOW));
+        }
+    }
+
+    // Run the trace, one thread per shard, and return the elapsed seconds.
+    // stats[i] collects what shard i ran. The tables must not be used meanwhile.
+    double replay(const vector<TraceRecord>& trace, vector<ReplayStats>& stats) {
+        stats.assign(count, ReplayStats());
+        adopted = 0;
+        finished = 0;
+        messages = 0;
+        chrono::steady_clock::time_point start;
+        vector<thread> workers;
+        for (unsigned index = 0; index < count; ++index) {
+            workers.emplace_back([&, index] {
+                adopt(index);
+                if (adopted.fetch_add(1) + 1 == count) {
+                    start = chrono::steady_clock::now();
+                }
+                while (adopted.load() < count) {
+                    this_thread::yield();
+                }
+                work(index, trace, stats[index]);
+            });
+        }
+        for (thread& worker : workers) {
+            worker.join();
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        handBack();
+        return seconds;
+    }
+
+    // Messages sent between shards by the last replay
+    uint64_t crossShardMessages() const { return messages.load(); }
+
+private:
+    struct Shard {
+        explicit Shard(size_t inbox_capacity) : inbox(inbox_capacity) {}
+
+        MpscRing<ShardMessage> inbox;
+        vector<ShardVehicle> vehicles;   // by ID / shard count, like the accounts
+        vector<ShardAccount> clients;
+        vector<ShardAccount> staff;
+        vector<int> picked_up_bookings;  // reservation IDs to forget on hand-back
+    };
+
+    // An operation of this shard's waiting for another shard's reply
+    struct InFlight {
+        size_t record;
+        chrono::steady_clock::time_point start;
+    };
+
+    const unsigned count;
+    vector<unique_ptr<Shard>> shards;
+    atomic<unsigned> adopted{0};
+    atomic<unsigned> finished{0};
+    atomic<uint64_t> messages{0};
+
+    unsigned accountShard(int user_id) const { return unsigned(user_id) % count; }
+
+    ShardVehicle* findVehicle(Shard& shard, int vehicle_id) {
+        size_t local = size_t(vehicle_id) / count;
+        if (vehicle_id <= 0 || local >= shard.vehicles.size() || shard.vehicles[local].vehicle_id != vehicle_id) {
+            return nullptr;
+        }
+        return &shard.vehicles[local];
+    }
+
+    ShardAccount* findAccount(Shard& shard, RenterRole role, int user_id) {
+        vector<ShardAccount>& accounts = role == RenterRole::Client ? shard.clients : shard.staff;
+        size_t local = size_t(user_id) / count;
+        if (user_id <= 0 || local >= accounts.size() || !accounts[local].exists) {
+            return nullptr;
+        }
+        return &accounts[local];
+    }
+
+    // Copy this shard's rows out of the global tables; the calendars are moved.
+    // Runs on the shard's own thread, so its arrays are allocated near it.
+    void adopt(unsigned index) {
+        Shard& shard = *shards[index];
+        int last_vehicle = Vehicle::vehicle_counter.load();
+        shard.vehicles.assign(last_vehicle / count + 1, ShardVehicle());
+        for (int vehicle_id = index; vehicle_id <= last_vehicle; vehicle_id += count) {
+            int slot = vehicle_id > 0 ? findVehicleSlot(vehicle_id) : -1;
+            if (slot == -1) {
+                continue;
+            }
+            ShardVehicle& vehicle = shard.vehicles[vehicle_id / count];
+            vehicle.vehicle_id = vehicle_id;
+            vehicle.daily_rent = vehicle_inventory.daily_rent[slot];
+            vehicle.accrued_days = vehicle_inventory.accrued_days[slot];
+            vehicle.rented = vehicle_inventory.is_rented[slot];
+            int rental = findRentalByVehicle(vehicle_id);
+            if (rental != -1) {
+                vehicle.holder_role = rental_table[rental].renter_role;
+                vehicle.holder_id = rental_table[rental].renter_id;
+                vehicle.start_time = rental_table[rental].start_time;
+                vehicle.deadline = rental_table[rental].deadline;
+            }
+            if (vehicle_id < (int)vehicle_calendars.size()) {
+                vehicle.calendar.swap(vehicle_calendars[vehicle_id]);
+            }
+        }
+        
+        auto adoptAccounts = [&](vector<ShardAccount>& accounts, int last_id, auto findRenter) {
+            accounts.assign(last_id / count + 1, ShardAccount());
+            for (int user_id = index; user_id <= last_id; user_id += count) {
+                auto* renter = user_id > 0 ? findRenter(user_id) : nullptr;
+                if (renter != nullptr) {
+                    ShardAccount& account = accounts[user_id / count];
+                    account.exists = true;
+                    account.dues = renter->outstanding_dues;
+                    account.rating = renter->rating;
+                    account.password = renter->user_password;
+                }
+            }
+        };
+        adoptAccounts(shard.clients, BaseUser::customer_count.load(), findClient);
+        adoptAccounts(shard.staff, BaseUser::employee_count.load(), findStaff);
+    }
+
+    // Put every shard's rows back into the global tables, then free them. The
+    // versioned tables are left for one resync rather than written row by row.
+    void handBack() {
+        markVersionedTablesStale();
+        for (unsigned index = 0; index < count; ++index) {
+            Shard& shard = *shards[index];
+            for (ShardVehicle& vehicle : shard.vehicles) {
+                int slot = vehicle.vehicle_id != 0 ? findVehicleSlot(vehicle.vehicle_id) : -1;
+                if (slot == -1) {
+                    continue;
+                }
+                if (vehicle.rental_changed) {
+                    int rental = findRentalByVehicle(vehicle.vehicle_id);
+                    if (rental != -1) {
+                        closeRental(rental);
+                    }
+                    if (vehicle.holder_id != 0) {
+                        openRental(vehicle.holder_role, vehicle.holder_id, slot, vehicle.start_time, vehicle.deadline);
+                    }
+                }
+                if (vehicle.daily_rent != vehicle_inventory.daily_rent[slot]) {
+                    vehicle_inventory.setRent(slot, vehicle.daily_rent);
+                    vehicle_inventory.touch(slot);
+                }
+                vehicle_inventory.addRevenue(slot, vehicle.revenue);
+                vehicle.calendar.swap(vehicleCalendar(vehicle.vehicle_id));
+            }
+            for (size_t local = 0; local < shard.clients.size(); ++local) {
+                if (shard.clients[local].exists) {
+                    Client* client = findClient(int(local * count + index));
+                    client->outstanding_dues = shard.clients[local].dues;
+                    client->rating = int(shard.clients[local].rating);
+                }
+            }
+            for (size_t local = 0; local < shard.staff.size(); ++local) {
+                if (shard.staff[local].exists) {
+                    StaffMember* staff = findStaff(int(local * count + index));
+                    staff->outstanding_dues = shard.staff[local].dues;
+                    staff->rating = shard.staff[local].rating;
+                }
+            }
+            for (int reservation_id : shard.picked_up_bookings) {
+                forgetReservationId(reservation_id);
+            }
+            vector<ShardVehicle>().swap(shard.vehicles);
+            vector<ShardAccount>().swap(shard.clients);
+            vector<ShardAccount>().swap(shard.staff);
+            shard.picked_up_bookings.clear();
+        }
+    }
+
+    // The vehicle's side of a request, on the shard that owns the vehicle
+    ShardMessage serve(Shard& shard, ShardMessage request) {
+        ShardMessage reply = request;
+        reply.kind = ShardMessageKind::Reply;
+        reply.number = 0;
+        reply.rating_deduction = 0;
+        ShardVehicle* vehicle = findVehicle(shard, request.vehicle_id);
+        switch (request.kind) {
+            case ShardMessageKind::Claim: {
+                if (vehicle == nullptr) {
+                    reply.status = OperationStatus::VehicleNotFound;
+                    break;
+                }
+                time_t now = time(0), deadline;
+                int reservation_id;
+                if (vehicle->rented) {
+                    reply.status = OperationStatus::AlreadyRented;
+                    break;
+                }
+                if (!takeRentalPeriod(vehicle->calendar, request.role, request.renter_id, now, deadline, reservation_id)) {
+                    reply.status = OperationStatus::Reserved;
+                    break;
+                }
+                int charge = request.role == RenterRole::Client ? rentalCharge<ClientPolicy>(vehicle->daily_rent) 
+                                                                : rentalCharge<StaffPolicy>(vehicle->daily_rent);
+                vehicle->rented = vehicle->rental_changed = true;
+                vehicle->holder_role = request.role;
+                vehicle->holder_id = request.renter_id;
+                vehicle->start_time = now;
+                vehicle->deadline = deadline;
+                vehicle->accrued_days = 0;
+                vehicle->revenue += charge;
+                if (reservation_id != 0) {
+                    shard.picked_up_bookings.push_back(reservation_id);
+                    logReservationReleased(vehicle->vehicle_id, reservation_id);
+                }
+                logRental(request.role, request.renter_id, vehicle->vehicle_id, now, deadline, charge);
+                reply.status = OperationStatus::Success;
+                reply.number = charge;
+                break;
+            }
+            case ShardMessageKind::Release: {
+                if (vehicle == nullptr || vehicle->holder_id != request.renter_id || vehicle->holder_role != request.role) {
+                    reply.status = OperationStatus::NotInRentals;
+                    break;
+                }
+                if (request.role == RenterRole::Client) {
+                    settleShardReturn<ClientPolicy>(*vehicle, time(0), reply.number, reply.rating_deduction);
+                } else {
+                    settleShardReturn<StaffPolicy>(*vehicle, time(0), reply.number, reply.rating_deduction);
+                }
+                vehicle->revenue += reply.number;
+                logReturn(request.role, request.renter_id, vehicle->vehicle_id, reply.number, reply.rating_deduction);
+                vehicle->rented = false;
+                vehicle->rental_changed = true;
+                vehicle->holder_id = 0;
+                vehicle->deadline = 0;
+                vehicle->accrued_days = 0;
+                reply.status = OperationStatus::Success;
+                break;
+            }
+            case ShardMessageKind::SetRent:
+                if (vehicle == nullptr) {
+                    reply.status = OperationStatus::VehicleNotFound;
+                    break;
+                }
+                vehicle->daily_rent = request.number;
+                logVehicleField(vehicle->vehicle_id, VehicleField::Rent, request.number);
+                reply.status = OperationStatus::Success;
+                break;
+            default:
+                reply.status = OperationStatus::InvalidRequest;
+                break;
+        }
+        return reply;
+    }
+
+    void send(unsigned to, const ShardMessage& message) {
+        messages.fetch_add(1, memory_order_relaxed);
+        while (!shards[to]->inbox.tryPush(message)) {
+            this_thread::yield();
+        }
+    }
+
+    // The account's side of a reply, or of a request the vehicle's shard answered locally
+    void settle(ShardAccount* account, LoadOp op, const ShardMessage& reply) {
+        if (account == nullptr) {
+            return;
+        }
+        account->busy = false;
+        if (reply.status == OperationStatus::Success && (op == LoadOp::Rent || op == LoadOp::Return)) {
+            account->dues += reply.number;
+            account->rating -= reply.rating_deduction;
+        }
+    }
+
+    // Operations that only touch the account, run on the account's shard
+    OperationStatus runOnAccount(ShardAccount* account, const TraceRecord& record) {
+        RenterRole role = RenterRole(record.role);
+        if (account == nullptr) {
+            return OperationStatus::AccountNotFound;
+        }
+        switch (record.op) {
+            case LoadOp::Login:
+                // The password executeTraceRecord logs in with
+                return account->password == "pass" ? OperationStatus::Success : OperationStatus::AuthenticationFailed;
+            case LoadOp::Pay:
+                if (account->dues == 0) {
+                    return OperationStatus::NoDues;
+                }
+                if (record.number <= 0 || record.number > account->dues) {
+                    return OperationStatus::InvalidAmount;
+                }
+                account->dues -= record.number;
+                logPayment(role, record.renter_id, record.number);
+                return OperationStatus::Success;
+            case LoadOp::ModifyAccount:
+                if (AccountField(record.field) == AccountField::Dues) {
+                    account->dues = record.number;
+                    logAccountField(role, record.renter_id, AccountField::Dues, account->dues);
+                } else if (AccountField(record.field) == AccountField::Rating) {
+                    account->rating = record.number;
+                    logAccountField(role, record.renter_id, AccountField::Rating, 
+                                    role == RenterRole::Client ? record.number : 0, account->rating);
+                } else {
+                    return OperationStatus::InvalidRequest;
+                }
+                return OperationStatus::Success;
+            default:
+                return OperationStatus::InvalidRequest;
+        }
+    }
+
+    // Replay this shard's records of the trace, serving other shards' requests
+    // throughout, until every shard has finished
+    void work(unsigned index, const vector<TraceRecord>& trace, ReplayStats& stats) {
+        Shard& shard = *shards[index];
+        vector<InFlight> in_flight(SHARD_WINDOW);
+        vector<uint32_t> free_tickets;
+        for (uint32_t ticket = 0; ticket < SHARD_WINDOW; ++ticket) {
+            free_tickets.push_back(ticket);
+        }
+        size_t next = 0;
+        bool done = false;
+        while (true) {
+            bool progressed = false;
+            size_t changes = 0;
+            ShardMessage message;
+            while (shard.inbox.tryPop(message)) {
+                progressed = true;
+                if (message.kind != ShardMessageKind::Reply) {
+                    send(message.from, serve(shard, message));
+                    continue;
+                }
+                const TraceRecord& record = trace[in_flight[message.ticket].record];
+                settle(findAccount(shard, RenterRole(record.role), record.renter_id), record.op, message);
+                stats.record(record.op, in_flight[message.ticket].start, message.status);
+                changes += message.status == OperationStatus::Success;
+                free_tickets.push_back(message.ticket);
+            }
+            
+            while (!free_tickets.empty()) {
+                while (next < trace.size() && accountShard(trace[next].renter_id) != index) {
+                    ++next;
+                }
+                if (next == trace.size()) {
+                    break;
+                }
+                const TraceRecord& record = trace[next];
+                ShardAccount* account = findAccount(shard, RenterRole(record.role), record.renter_id);
+                if (account != nullptr && account->busy) {
+                    break;  // wait for the renter's earlier operation
+                }
+                progressed = true;
+                auto start = chrono::steady_clock::now();
+                ShardMessage request = {ShardMessageKind::Claim, RenterRole(record.role), index, 0, record.renter_id, 
+                                        record.vehicle_id, record.number, OperationStatus::Success, 0};
+                if (record.op == LoadOp::Rent || record.op == LoadOp::Return) {
+                    request.kind = record.op == LoadOp::Rent ? ShardMessageKind::Claim : ShardMessageKind::Release;
+                } else if (record.op == LoadOp::ModifyVehicle && VehicleField(record.field) == VehicleField::Rent) {
+                    request.kind = ShardMessageKind::SetRent;
+                } else {
+                    OperationStatus status = runOnAccount(account, record);
+                    stats.record(record.op, start, status);
+                    changes += status == OperationStatus::Success && record.op != LoadOp::Login;
+                    ++next;
+                    continue;
+                }
+                if (account == nullptr && record.op != LoadOp::ModifyVehicle) {
+                    stats.record(record.op, start, OperationStatus::AccountNotFound);
+                    ++next;
+                    continue;
+                }
+                
+                unsigned owner = record.vehicle_id > 0 ? unsigned(record.vehicle_id) % count : index;
+                if (owner == index) {
+                    ShardMessage reply = serve(shard, request);
+                    settle(account, record.op, reply);
+                    stats.record(record.op, start, reply.status);
+                    changes += reply.status == OperationStatus::Success;
+                } else {
+                    request.ticket = free_tickets.back();
+                    free_tickets.pop_back();
+                    in_flight[request.ticket] = {next, start};
+                    if (account != nullptr) {
+                        account->busy = true;
+                    }
+                    send(owner, request);
+                }
+                ++next;
+            }
+            
+            // Group commit for everything this pass finished
+            if (changes > 0 && !transaction_log.commit()) {
+                fprintf(stderr, "Warning: transaction log write failed, recent changes may not survive a restart\n");
+            }
+            if (!done && next == trace.size() && free_tickets.size() == SHARD_WINDOW) {
+                done = true;
+                finished.fetch_add(1);
+            }
+            // Nobody has anything in flight once every shard is done, so no message can still come
+            if (done && finished.load() == count) {
+                break;
+            }
+            if (!progressed) {
+                this_thread::yield();
+            }
+        }
+    }
+};
+
+// --load --shards N: replay a trace on the sharded runtime and print what it measured
+void replayTraceSharded(const vector<TraceRecord>& trace, int shard_count) {
+    ShardedRuntime runtime(max(shard_count, 1));
+    vector<ReplayStats> stats;
+    double seconds = runtime.replay(trace, stats);
+    printReplay(trace.size(), max(shard_count, 1), "shard", seconds, stats);
+    cout << runtime.crossShardMessages() << " cross-shard message(s)\n";
+}
+
+//======================= SERVER =======================//
+
+// --serve ADDRESS puts the engine behind a socket so many branch counters and
+// kiosks can use it at once. ADDRESS is unix:PATH for a Unix domain socket,
+// or PORT / HOST:PORT for TCP (host defaults to 127.0.0.1). TCP hosts outside
+// the loopback range are refused unless --allow-remote is given. Requests use
+// the batch grammar, one per line, and each is answered in order with the same
+// JSON result line:
+//   {"line":2,"op":"rent","status":"ok","value":1000}
+// A session starts anonymous and can only log in, with
+//   login <client|staff> NAME PASSWORD   or   login admin NAME PASSWORD
+// Clients and staff may then use rent, return, pay, dues, reserve and
+// cancel-reservation on their own account, plus the read-only search and
+// available. Everything else needs an admin session; refusals come back as
+// "unauthorized". Commands that name a file on the server (import, metrics,
+// report to a path) are refused even for admins, since the server would open
+// it with its own permissions; report KIND FORMAT - answers over the session
+// instead. quit closes the session.
+//
+// Each worker thread runs its own epoll loop. All loops wait on the listening
+// socket with EPOLLEXCLUSIVE, and a connection stays with the loop that
+// accepted it. Renter requests and reports run concurrently under a shared
+// admin_edit_lock; other admin requests take it exclusively and write the
+// versioned rows they change as they go. Everything a loop read in one wakeup is
+// committed to the log together, then answered.
+
+#ifdef __linux__
+#define RENTAL_SERVER 1
+
+volatile sig_atomic_t server_interrupted = 0;
+
+void interruptServer(int) {
+    server_interrupted = 1;
+}
+
+// Each connection costs a descriptor, so lift the soft limit to the hard one
+void raiseDescriptorLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+// Fill a socket address from unix:PATH, PORT or HOST:PORT; false if malformed
+bool parseSocketAddress(const string& address, sockaddr_storage& storage, socklen_t& length) {
+    memset(&storage, 0, sizeof(storage));
+    if (address.compare(0, 5, "unix:") == 0) {
+        string path = address.substr(5);
+        sockaddr_un& local = (sockaddr_un&)storage;
+        if (path.empty() || path.size() >= sizeof(local.sun_path)) {
+            return false;
+        }
+        local.sun_family = AF_UNIX;
+        memcpy(local.sun_path, path.c_str(), path.size() + 1);
+        length = sizeof(local);
+        return true;
+    }
+    size_t colon = address.rfind(':');
+    string host = colon == string::npos ? "127.0.0.1" : address.substr(0, colon);
+    string_view port_text = string_view(address).substr(colon == string::npos ? 0 : colon + 1);
+    int port = 0;
+    sockaddr_in& inet = (sockaddr_in&)storage;
+    if (!parseNumber(port_text, port) || port <= 0 || port > 65535 || inet_pton(AF_INET, host.c_str(), &inet.sin_addr) != 1) {
+        return false;
+    }
+    inet.sin_family = AF_INET;
+    inet.sin_port = htons(port);
+    length = sizeof(inet);
+    return true;
+}
+
+// Blocking connection, for the client tool and the benchmark; -1 on failure
+int connectToServer(const string& address) {
+    sockaddr_storage storage;
+    socklen_t length;
+    if (!parseSocketAddress(address, storage, length)) {
+        return -1;
+    }
+    int descriptor = socket(storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (descriptor < 0) {
+        return -1;
+    }
+    if (connect(descriptor, (sockaddr*)&storage, length) != 0) {
+        ::close(descriptor);
+        return -1;
+    }
+    if (storage.ss_family == AF_INET) {
+        int on = 1;
+        setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    return descriptor;
+}
+
+// Write all of data to a blocking socket; false once the peer is gone
+bool sendAll(int descriptor, string_view data) {
+    while (!data.empty()) {
+        ssize_t written = send(descriptor, data.data(), data.size(), MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data.remove_prefix(written);
+    }
+    return true;
+}
+
+struct ServerSession {
+    enum class Identity { Anonymous, Renter, Admin };
+
+    int descriptor = -1;
+    Identity identity = Identity::Anonymous;
+    RenterRole role = RenterRole::Client;
+    int account_id = 0;
+    size_t line_number = 0;
+    string input;        // bytes after the last complete request
+    string output;       // answers not yet written
+    size_t sent = 0;     // bytes of output already written
+    bool closing = false;  // close once output is written
+    bool quit = false;     // requests after quit are ignored
+};
+
+// Who may run a command
+enum class CommandAccess {
+    Open,     // anyone
+    Account,  // an admin, or the renter whose role and ID follow the command
+    Fleet,    // anyone logged in
+    Report,   // an admin, but reads a snapshot and so runs alongside renters
+    Admin,
+    Local     // names a server-side file, so never over a socket
+};
+
+class RentalServer {
+public:
+    static const size_t MAX_LINE = 4096;  // a longer request closes its session
+
+    ~RentalServer() { closeListener(); }
+
+    // Bind and listen on the address; false with the reason in error. Without
+    // allow_remote only Unix sockets and loopback TCP addresses are accepted.
+    bool open(const string& address, bool allow_remote, string& error) {
+        sockaddr_storage storage;
+        socklen_t length;
+        if (!parseSocketAddress(address, storage, length)) {
+            error = "Invalid address " + address;
+            return false;
+        }
+        if (storage.ss_family == AF_INET && !allow_remote 
+                && (ntohl(((sockaddr_in&)storage).sin_addr.s_addr) >> 24) != 127) {
+            error = address + " is not a loopback address (use --allow-remote to listen on it)";
+            return false;
+        }
+        listener = socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener < 0) {
+            error = strerror(errno);
+            return false;
+        }
+        if (storage.ss_family == AF_UNIX) {
+            // A socket file left by a previous run would make bind fail
+            unix_path = ((sockaddr_un&)storage).sun_path;
+            unlink(unix_path.c_str());
+        } else {
+            int on = 1;
+            setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            tcp = true;
+        }
+        if (bind(listener, (sockaddr*)&storage, length) != 0 || ::listen(listener, SOMAXCONN) != 0) {
+            error = strerror(errno);
+            closeListener();
+            return false;
+        }
+        return true;
+    }
+
+    // Serve on the given number of event loop threads until stop() or SIGINT/SIGTERM
+    void run(unsigned threads) {
+        prepareConcurrentRentals();
+        stopping = false;
+        vector<thread> loops;
+        for (unsigned i = 1; i < threads; ++i) {
+            loops.emplace_back(&RentalServer::loop, this);
+        }
+        loop();
+        for (auto& running : loops) {
+            running.join();
+        }
+    }
+
+    void stop() { stopping.store(true, memory_order_relaxed); }
+
+    uint64_t requests() const { return handled_requests.load(memory_order_relaxed); }
+    uint64_t connections() const { return accepted_connections.load(memory_order_relaxed); }
+
+private:
+    int listener = -1;
+    bool tcp = false;
+    string unix_path;
+    atomic<bool> stopping{false};
+    atomic<uint64_t> handled_requests{0};
+    atomic<uint64_t> accepted_connections{0};
+
+    void closeListener() {
+        if (listener < 0) {
+            return;
+        }
+        ::close(listener);
+        listener = -1;
+        if (!unix_path.empty()) {
+            unlink(unix_path.c_str());
+        }
+    }
+
+    void loop() {
+        int epoll_descriptor = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event listen_event{};
+        listen_event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        listen_event.data.fd = listener;
+        epoll_ctl(epoll_descriptor, EPOLL_CTL_ADD, listener, &listen_event);
+        
+        unordered_map<int, unique_ptr<ServerSession>> sessions;
+        auto closeSession = [&](int descriptor) {
+            ::close(descriptor);
+            sessions.erase(descriptor);
+        };
+        vector<epoll_event> events(256);
+        vector<ServerSession*> ready;
+        while (!stopping.load(memory_order_relaxed) && !server_interrupted) {
+            int count = epoll_wait(epoll_descriptor, events.data(), (int)events.size(), 100);
+            if (count < 0 && errno != EINTR) {
+                break;
+            }
+            ready.clear();
+            for (int i = 0; i < count; ++i) {
+                int descriptor = events[i].data.fd;
+                if (descriptor == listener) {
+                    acceptConnections(epoll_descriptor, sessions);
+                    continue;
+                }
+                auto found = sessions.find(descriptor);
+                if (found == sessions.end()) {
+                    continue;
+                }
+                if ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && !readRequests(*found->second)) {
+                    closeSession(descriptor);
+                    continue;
+                }
+                ready.push_back(found->second.get());
+            }
+            // Answers go out only once the changes behind them are durable
+            bool answered = any_of(ready.begin(), ready.end(), [](ServerSession* session) { return !session->output.empty(); });
+            if (answered && !transaction_log.commit()) {
+                fprintf(stderr, "Warning: transaction log write failed, recent changes may not survive a restart\n");
+            }
+            for (ServerSession* session : ready) {
+                if (!writeAnswers(*session) || (session->closing && session->output.empty())) {
+                    closeSession(session->descriptor);
+                }
+            }
+        }
+        for (auto& session : sessions) {
+            ::close(session.first);
+        }
+        ::close(epoll_descriptor);
+    }
+
+    void acceptConnections(int epoll_descriptor, unordered_map<int, unique_ptr<ServerSession>>& sessions) {
+        while (true) {
+            int descriptor = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (descriptor < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;  // drained, or out of descriptors until some session closes
+            }
+            if (tcp) {
+                int on = 1;
+                setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            }
+            // Edge-triggered both ways: reads drain the socket, and EPOLLOUT resumes a blocked write
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.fd = descriptor;
+            if (epoll_ctl(epoll_descriptor, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+                ::close(descriptor);
+                continue;
+            }
+            auto session = make_unique<ServerSession>();
+            session->descriptor = descriptor;
+            sessions.emplace(descriptor, move(session));
+            accepted_connections.fetch_add(1, memory_order_relaxed);
+        }
+    }
+
+    // Read everything available and run each complete request; false if the connection is gone
+    bool readRequests(ServerSession& session) {
+        char buffer[16384];
+        while (true) {
+            ssize_t received = recv(session.descriptor, buffer, sizeof(buffer), 0);
+            if (received > 0) {
+                session.input.append(buffer, received);
+                continue;
+            }
+            if (received == 0) {
+                session.closing = true;
+                break;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return false;
+        }
+        size_t start = 0, newline;
+        while (!session.quit && (newline = session.input.find('\n', start)) != string::npos) {
+            handleRequest(session, string_view(session.input).substr(start, newline - start));
+            start = newline + 1;
+        }
+        session.input.erase(0, start);
+        return session.input.size() <= MAX_LINE;
+    }
+
+    // False on a write error; a full socket buffer leaves the rest for EPOLLOUT
+    bool writeAnswers(ServerSession& session) {
+        while (session.sent < session.output.size()) {
+            ssize_t written = send(session.descriptor, session.output.data() + session.sent, 
+                                   session.output.size() - session.sent, MSG_NOSIGNAL);
+            if (written > 0) {
+                session.sent += written;
+            } else if (written < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            }
+        }
+        session.output.clear();
+        session.sent = 0;
+        return true;
+    }
+
+    void handleRequest(ServerSession& session, string_view line) {
+        ++session.line_number;
+        string_view fields[BatchRunner::MAX_FIELDS];
+        int field_count = BatchRunner::splitFields(line, fields);
+        if (field_count == 0) {
+            return;
+        }
+        const char* op = "unknown";
+        EngineResult result{OperationStatus::InvalidRequest, 0};
+        if (field_count <= BatchRunner::MAX_FIELDS) {
+            result = execute(session, fields, field_count, op);
+        }
+        BatchRunner::formatResult(session.output, session.line_number, op, result);
+        handled_requests.fetch_add(1, memory_order_relaxed);
+    }
+
+    // Names the op after the command; unknown commands fall to the admin rule
+    static CommandAccess commandAccess(string_view command, const char*& op) {
+        static const pair<const char*, CommandAccess> rules[] = {
+            {"rent", CommandAccess::Account}, {"return", CommandAccess::Account}, {"pay", CommandAccess::Account},
+            {"dues", CommandAccess::Account}, {"reserve", CommandAccess::Account}, 
+            {"cancel-reservation", CommandAccess::Account}, {"search", CommandAccess::Fleet}, 
+            {"available", CommandAccess::Fleet}, {"add-account", CommandAccess::Admin}, 
+            {"remove-account", CommandAccess::Admin}, {"modify-account", CommandAccess::Admin}, 
+            {"add-vehicle", CommandAccess::Admin}, {"remove-vehicle", CommandAccess::Admin}, 
+            {"modify-vehicle", CommandAccess::Admin}, {"overdue", CommandAccess::Admin}, 
+            {"accrue", CommandAccess::Admin}, {"import", CommandAccess::Local}, {"report", CommandAccess::Report}, 
+            {"compact", CommandAccess::Admin}, {"metrics", CommandAccess::Local}};
+        for (const auto& [name, access] : rules) {
+            if (command == name) {
+                op = name;
+                return access;
+            }
+        }
+        return CommandAccess::Admin;
+    }
+
+    EngineResult execute(ServerSession& session, const string_view* fields, int field_count, const char*& op) {
+        string_view command = fields[0];
+        if (command == "quit") {
+            op = "quit";
+            session.closing = session.quit = true;
+            return {OperationStatus::Success, 0};
+        }
+        if (command == "login") {
+            op = "login";
+            if (field_count == 4 && fields[1] == "admin") {
+                if (!validAdminCredentials(string(fields[2]), string(fields[3]))) {
+                    return {OperationStatus::AuthenticationFailed, 0};
+                }
+                session.identity = ServerSession::Identity::Admin;
+                return {OperationStatus::Success, 0};
+            }
+            shared_lock<shared_mutex> shared(admin_edit_lock);
+            EngineResult result = BatchRunner::execute(fields, field_count, op);
+            if (result.status == OperationStatus::Success && parseRole(fields[1], session.role)) {
+                session.identity = ServerSession::Identity::Renter;
+                session.account_id = (int)result.value;
+            }
+            return result;
+        }
+        
+        CommandAccess access = commandAccess(command, op);
+        bool admin = session.identity == ServerSession::Identity::Admin;
+        bool allowed = admin || access == CommandAccess::Open;
+        if (session.identity == ServerSession::Identity::Renter) {
+            RenterRole role;
+            int id = 0;
+            allowed = allowed || access == CommandAccess::Fleet 
+                || (access == CommandAccess::Account && field_count >= 3 && parseRole(fields[1], role) 
+                    && parseNumber(fields[2], id) && role == session.role && id == session.account_id);
+        }
+        // A path would be opened with the server's permissions, so only "-" is accepted for reports
+        bool local_file = access == CommandAccess::Local 
+            || (access == CommandAccess::Report && field_count == 4 && fields[3] != "-");
+        if (!allowed || local_file) {
+            return {OperationStatus::Unauthorized, 0};
+        }
+        if (access == CommandAccess::Admin) {
+            unique_lock<shared_mutex> exclusive(admin_edit_lock);
+            EngineResult result = BatchRunner::execute(fields, field_count, op);
+            // Added vehicles and accounts must be sized into the tables renters index without locking,
+            // and a compaction resynced into the versioned tables reports read under the shared lock
+            if (result.status == OperationStatus::Success && command != "overdue") {
+                prepareConcurrentRentals();
+            }
+            return result;
+        }
+        shared_lock<shared_mutex> shared(admin_edit_lock);
+        if (access == CommandAccess::Report) {
+            return sendReport(session, fields, field_count);
+        }
+        return BatchRunner::execute(fields, field_count, op);
+    }
+
+    // report KIND FORMAT -: the report goes back over the session, ahead of its result line
+    static EngineResult sendReport(ServerSession& session, const string_view* fields, int field_count) {
+        ReportKind kind;
+        ReportFormat format;
+        if (field_count != 4 || !parseReportKind(fields[1], kind) || !parseReportFormat(fields[2], format)) {
+            return {OperationStatus::InvalidRequest, 0};
+        }
+        ReportTable table = ReportBuilder::build(kind);
+        renderReport(table, format, session.output);
+        return {OperationStatus::Success, (int64_t)table.rows.size()};
+    }
+};
+
+// --connect ADDRESS: send stdin to the server line by line and print the answers
+int runServerClient(const string& address) {
+    int descriptor = connectToServer(address);
+    if (descriptor < 0) {
+        cerr << "Cannot connect to " << address << "\n";
+        return 1;
+    }
+    thread printer([descriptor] {
+        char buffer[16384];
+        ssize_t received;
+        while ((received = recv(descriptor, buffer, sizeof(buffer), 0)) > 0) {
+            fwrite(buffer, 1, received, stdout);
+            fflush(stdout);
+        }
+    });
+    string line;
+    while (getline(cin, line)) {
+        line += '\n';
+        if (!sendAll(descriptor, line)) {
+            break;
+        }
+    }
+    // The server answers what it already has, then closes, which ends the printer
+    shutdown(descriptor, SHUT_WR);
+    printer.join();
+    ::close(descriptor);
+    return 0;
+}
+#endif
+
+//======================= BENCHMARKS =======================//
+
+// Time rent/return pairs against fleets of increasing size. Run with: car --bench
+void runLookupBenchmark() {
+    const int fleet_sizes[] = {1000, 100000, 1000000};
+    const int operations = 200000;
+    
+    cout << setw(10) << "Vehicles" << setw(15) << "Rent (ns)" << setw(15) << "Return (ns)" << endl;
+    for (int fleet_size : fleet_sizes) {
+        vehicle_inventory.clear();
+        vehicle_slot_by_id.clear();
+        rental_table.clear();
+        free_rental_slots.clear();
+        rental_slot_by_vehicle.clear();
+        Vehicle::vehicle_counter = 0;
+        vehicle_inventory.reserve(fleet_size);
+        for (int i = 0; i < fleet_size; ++i) {
+            addVehicle(Vehicle("Toyota", "Corolla", 1000 + i % 500, 2000000, 5, "White"));
+        }
+        
+        Client renter("bench", "bench");
+        vector<int> vehicle_ids(operations);
+        unsigned int seed = 12345;
+        for (auto& vehicle_id : vehicle_ids) {
+            seed = seed * 1103515245 + 12345;
+            vehicle_id = 1 + (seed >> 8) % fleet_size;
+        }
+        
+        chrono::nanoseconds rent_time(0), return_time(0);
+        int penalty = 0;
+        for (int vehicle_id : vehicle_ids) {
+            auto start = chrono::steady_clock::now();
+            renter.rentVehicle(vehicle_id, penalty);
+            auto middle = chrono::steady_clock::now();
+            renter.returnVehicle(vehicle_id, penalty);
+            auto end = chrono::steady_clock::now();
+            rent_time += middle - start;
+            return_time += end - middle;
+        }
+        
+        cout << setw(10) << fleet_size 
+             << setw(15) << rent_time.count() / operations 
+             << setw(15) << return_time.count() / operations << endl;
+    }
+}
+
+// Time login lookups and duplicate-name checks against growing account tables
+void runLoginBenchmark() {
+    const int account_counts[] = {10, 10000, 1000000};
+    const int operations = 200000;
+    
+    cout << setw(10) << "Accounts" << setw(15) << "Login (ns)" << setw(15) << "Dup check (ns)" << endl;
+    for (int account_count : account_counts) {
+        client_database.clear();
+        client_slot_by_id.clear();
+        account_index.clear();
+        BaseUser::customer_count = 0;
+        client_database.reserve(account_count);
+        account_index.reserve(account_count);
+        for (int i = 0; i < account_count; ++i) {
+            addClient(Client("user" + to_string(i), "pass"));
+        }
+        
+        vector<string> names(operations);
+        unsigned int seed = 12345;
+        for (auto& name : names) {
+            seed = seed * 1103515245 + 12345;
+            name = "user" + to_string((seed >> 8) % account_count);
+        }
+        
+        int successes = 0;
+        auto start = chrono::steady_clock::now();
+        for (const auto& name : names) {
+            Client* client = findClientByName(name);
+            successes += (client != nullptr && client->validatePassword("pass"));
+        }
+        auto middle = chrono::steady_clock::now();
+        for (const auto& name : names) {
+            successes += (findClientByName(name + "x") == nullptr);
+        }
+        auto end = chrono::steady_clock::now();
+        
+        if (successes != 2 * operations) {
+            cout << "Login benchmark produced unexpected results\n";
+        }
+        cout << setw(10) << account_count 
+             << setw(15) << chrono::nanoseconds(middle - start).count() / operations 
+             << setw(15) << chrono::nanoseconds(end - middle).count() / operations << endl;
+    }
+}
+
+// Memory per vehicle for the brand/model/color columns as pooled codes vs
+// one std::string each, and an equality count over 1M vehicles both ways
+void runStringPoolBenchmark() {
+    const size_t fleet_size = 1000000;
+    const char* brands[] = {"Toyota", "Honda", "Suzuki", "Hyundai", "Kia", "Mercedes-Benz", "Volkswagen", "Mitsubishi"};
+    const char* models[] = {"Corolla", "Civic", "Swift", "Elantra", "Sportage", "E-Class", "Golf", "Outlander", 
+                            "Land Cruiser Prado", "Accord Hybrid Touring"};
+    const char* colors[] = {"White", "Black", "Silver", "Red", "Midnight Blue Metallic"};
+    clearAllTables();
+    vehicle_inventory.reserve(fleet_size);
+    vector<string> brand_strings;
+    brand_strings.reserve(fleet_size);
+    size_t string_bytes = 0;
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < fleet_size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        Vehicle vehicle(brands[(seed >> 8) % 8], models[(seed >> 12) % 10], 1000, 2000000, 5, colors[(seed >> 16) % 5]);
+        addVehicle(vehicle);
+        brand_strings.push_back(vehicle.brand_name);
+        // Each std::string column costs the object plus any text too long for the inline buffer
+        for (const string* text : {&vehicle.brand_name, &vehicle.vehicle_model, &vehicle.vehicle_color}) {
+            string_bytes += sizeof(string) + (text->size() > 15 ? text->size() + 1 : 0);
+        }
+    }
+    const FleetStore& fleet = vehicle_inventory;
+    size_t pooled_bytes = fleet_size * 3 * sizeof(uint32_t) + fleet.brand_pool.memoryBytes() 
+                        + fleet.model_pool.memoryBytes() + fleet.color_pool.memoryBytes();
+    
+    uint32_t wanted_code = fleet.brand_pool.find("Mercedes-Benz");
+    const string wanted_text = "Mercedes-Benz";
+    size_t code_matches = 0, string_matches = 0;
+    auto start = chrono::steady_clock::now();
+    for (uint32_t code : fleet.brand_code) {
+        code_matches += code == wanted_code;
+    }
+    auto middle = chrono::steady_clock::now();
+    for (const string& text : brand_strings) {
+        string_matches += text == wanted_text;
+    }
+    auto end = chrono::steady_clock::now();
+    cout << "String pools: " << fixed << setprecision(1) << double(string_bytes) / fleet_size << " bytes per vehicle as strings, " 
+         << double(pooled_bytes) / fleet_size << " as codes; brand equality over " << fleet_size << " vehicles " 
+         << chrono::duration<double, micro>(middle - start).count() << " us by code, " 
+         << chrono::duration<double, micro>(end - middle).count() << " us by string (" 
+         << (code_matches == string_matches ? "same" : "different") << " matches)" << endl;
+    cout.unsetf(ios::fixed);
+    clearAllTables();
+}
+
+// Admin removals from the front of 1M-row tables, the worst case for shifting
+// storage, then one compaction of the tombstones they leave behind
+void runRemovalBenchmark() {
+    const int table_size = 1000000;
+    const int removals = 10000;
+    populateSyntheticData(table_size, table_size);
+    auto start = chrono::steady_clock::now();
+    for (int id = 1; id <= removals; ++id) {
+        rental_engine.removeVehicle(id);
+    }
+    auto middle = chrono::steady_clock::now();
+    for (int id = 1; id <= removals; ++id) {
+        rental_engine.removeAccount({RenterRole::Client, id});
+    }
+    auto removed = chrono::steady_clock::now();
+    compactTables();
+    auto end = chrono::steady_clock::now();
+    bool consistent = findVehicleSlot(removals) == -1 && findVehicleSlot(removals + 1) == 0 
+                   && findClient(removals) == nullptr && findClient(removals + 1) == &client_database[0];
+    cout << "Removal from " << table_size << " rows: vehicle " 
+         << chrono::duration_cast<chrono::nanoseconds>(middle - start).count() / removals << " ns, client " 
+         << chrono::duration_cast<chrono::nanoseconds>(removed - middle).count() / removals << " ns; compacting " 
+         << removals << " + " << removals << " tombstones " << chrono::duration_cast<chrono::milliseconds>(end - removed).count() 
+         << " ms (IDs " << (consistent ? "consistent" : "INCONSISTENT") << ")" << endl;
+    clearAllTables();
+}
+
+// Import 1M-row vehicle and client CSV files with one worker and with all of them
+void runImportBenchmark() {
+    const int rows = 1000000;
+    const string vehicle_path = "car_bench_vehicles.csv";
+    const string client_path = "car_bench_clients.csv";
+    {
+        string text = "brand,model,rent,price,seats,color\n";
+        const char* brands[] = {"Toyota", "Honda", "Suzuki", "Kia"};
+        const char* colors[] = {"White", "Black", "Silver", "Red"};
+        for (int i = 0; i < rows; ++i) {
+            text.append(brands[i % 4]).append(",Model").append(to_string(i % 100)).append(",")
+                .append(to_string(500 + i % 5000)).append(",").append(to_string(1000000 + i)).append(",5,")
+                .append(colors[(i / 4) % 4]).append("\n");
+        }
+        ofstream(vehicle_path, ios::binary | ios::trunc) << text;
+        text = "name,password\n";
+        for (int i = 0; i < rows; ++i) {
+            text.append("user").append(to_string(i)).append(",pass").append(to_string(i)).append("\n");
+        }
+        ofstream(client_path, ios::binary | ios::trunc) << text;
+    }
+    
+    cout << setw(10) << "File" << setw(10) << "Workers" << setw(12) << "Imported" << setw(10) << "ms" << setw(14) << "Rows/s" << endl;
+    for (const auto& [kind, path, name] : {make_tuple(ImportKind::Vehicles, vehicle_path, "vehicles"), 
+                                           make_tuple(ImportKind::Clients, client_path, "clients")}) {
+        for (unsigned workers : {1u, workerCount()}) {
+            clearAllTables();
+            auto start = chrono::steady_clock::now();
+            ImportReport report = importCsv(kind, path, workers);
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            cout << setw(10) << name << setw(10) << workers << setw(12) << report.imported 
+                 << setw(10) << int(elapsed.count() * 1000) << setw(14) << int(report.imported / elapsed.count()) << endl;
+            if (workers == workerCount()) {
+                break;
+            }
+        }
+    }
+    remove(vehicle_path.c_str());
+    remove(client_path.c_str());
+    clearAllTables();
+}
+
+// Measure filter kernel throughput over a 10M-vehicle fleet
+void runFilterBenchmark() {
+    const size_t fleet_size = 10000000;
+    const int passes = 5;
+    
+    vehicle_inventory.clear();
+    vehicle_slot_by_id.clear();
+    Vehicle::vehicle_counter = 0;
+    vehicle_inventory.reserve(fleet_size);
+    Vehicle vehicle("Toyota", "Corolla", 0, 2000000, 0, "White");
+    const char* colors[] = {"White", "Black", "Silver", "Red"};
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < fleet_size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        vehicle.daily_rent = 500 + (seed >> 8) % 20000;
+        vehicle.seating_capacity = 2 + (seed >> 20) % 6;
+        vehicle.vehicle_condition = 50 + (seed >> 4) % 51;
+        vehicle.is_rented = (seed >> 12) % 3 == 0;
+        vehicle.vehicle_color = colors[(seed >> 24) % 4];
+        vehicle_inventory.append(vehicle);
+    }
+    
+    FleetFilter filter;
+    filter.min_seats = 5;
+    filter.max_rent = 5000;
+    filter.min_condition = 80;
+    filter.available_only = true;
+    filter.setColor("White");
+    
+    // Bytes read per row: rent, seats, condition, brand and color ints plus the rented flag
+    const double scanned_bytes = double(fleet_size) * (5 * sizeof(int) + sizeof(uint8_t));
+    const pair<FilterKernel, const char*> kernels[] = {
+        {FilterKernel::Scalar, "scalar"}, {FilterKernel::Sse, "sse4.1"}, {FilterKernel::Avx2, "avx2"}};
+    
+    cout << setw(10) << "Kernel" << setw(12) << "ms/scan" << setw(10) << "GB/s" << setw(12) << "Matches" << endl;
+    for (const auto& kernel : kernels) {
+        if (kernel.first > bestFilterKernel()) {
+            continue;
+        }
+        SelectionBitmap selection;
+        filterFleet(filter, selection, kernel.first);
+        
+        auto start = chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            filterFleet(filter, selection, kernel.first);
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        
+        size_t matches = 0;
+        for (uint64_t word : selection) {
+            matches += __builtin_popcountll(word);
+        }
+        cout << setw(10) << kernel.second 
+             << setw(12) << fixed << setprecision(2) << elapsed.count() * 1000 / passes 
+             << setw(10) << scanned_bytes * passes / elapsed.count() / 1e9 
+             << setw(12) << matches << endl;
+    }
+    cout.unsetf(ios::fixed);
+}
+
+// Time a snapshot round trip for 1M vehicles and 5M clients
+void runSnapshotBenchmark() {
+    const int fleet_size = 1000000;
+    const int client_count = 5000000;
+    const string path = "car_bench.snapshot";
+    
+    clearAllTables();
+    vehicle_inventory.reserve(fleet_size);
+    for (int i = 0; i < fleet_size; ++i) {
+        addVehicle(Vehicle("Toyota", "Corolla", 1000 + i % 500, 2000000, 5, "White"));
+    }
+    client_database.reserve(client_count);
+    account_index.reserve(client_count);
+    for (int i = 0; i < client_count; ++i) {
+        addClient(Client("user" + to_string(i), "pass"));
+    }
+    for (int i = 0; i < fleet_size; i += 4) {
+        openRental(RenterRole::Client, 1 + i % client_count, i, time(0), time(0) + RENTAL_PERIOD);
+    }
+    
+    auto start = chrono::steady_clock::now();
+    bool saved = SnapshotFile::save(path);
+    auto middle = chrono::steady_clock::now();
+    SnapshotStatus status = SnapshotFile::load(path);
+    auto end = chrono::steady_clock::now();
+    remove(path.c_str());
+    
+    if (!saved || status != SnapshotStatus::Loaded || client_database.size() != (size_t)client_count
+            || findClientByName("user4242") == nullptr) {
+        cout << "Snapshot benchmark failed\n";
+        return;
+    }
+    cout << "Snapshot of " << fleet_size << " vehicles / " << client_count << " clients: save "
+         << chrono::duration_cast<chrono::milliseconds>(middle - start).count() << " ms, load "
+         << chrono::duration_cast<chrono::milliseconds>(end - middle).count() << " ms" << endl;
+}
+
+// Group commit throughput with concurrent committers, then parallel replay of 1M records
+void runTransactionLogBenchmark() {
+    const string path = "car_bench.wal";
+    const int committers = 8;
+    const int commits_each = 500;
+    
+    cout << setw(12) << "Committers" << setw(12) << "Delay (us)" << setw(14) << "Commits/s" 
+         << setw(16) << "Records/fsync" << endl;
+    for (int threads : {1, committers}) {
+        WriteAheadLog log;
+        log.open(path, 1, chrono::microseconds(threads == 1 ? 0 : 200));
+        auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&log, t] {
+                WalRecord record;
+                record.type = WalRecordType::Payment;
+                record.account_id = t + 1;
+                record.numbers = {1};
+                for (int i = 0; i < commits_each; ++i) {
+                    log.append(record);
+                    log.commit();
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        log.close();
+        cout << setw(12) << threads << setw(12) << (threads == 1 ? 0 : 200) 
+             << setw(14) << int(threads * commits_each / elapsed.count()) 
+             << setw(16) << fixed << setprecision(1) << double(threads * commits_each) / log.flushed_batches << endl;
+        cout.unsetf(ios::fixed);
+    }
+    
+    const int accounts = 100000;
+    const int records = 1000000;
+    clearAllTables();
+    for (int i = 0; i < accounts; ++i) {
+        addVehicle(Vehicle("Toyota", "Corolla", 1000, 2000000, 5, "White"));
+        addClient(Client("user" + to_string(i), "pass"));
+    }
+    
+    string log_data;
+    WalHeader header;
+    memcpy(header.magic, WAL_MAGIC, sizeof(header.magic));
+    header.generation = 7;
+    log_data.append((const char*)&header, sizeof(header));
+    vector<char> rented(accounts + 1, 0);
+    unsigned int seed = 12345;
+    for (int i = 0; i < records; ++i) {
+        seed = seed * 1103515245 + 12345;
+        int id = 1 + (seed >> 8) % accounts;
+        WalRecord record;
+        record.account_id = id;
+        record.vehicle_id = id;
+        if ((seed >> 4) % 4 == 0) {
+            record.type = WalRecordType::Payment;
+            record.numbers = {10};
+        } else if (!rented[id]) {
+            record.type = WalRecordType::Rented;
+            record.numbers = {time(0), time(0) + RENTAL_PERIOD, 1000};
+        } else {
+            record.type = WalRecordType::Returned;
+            record.numbers = {0};
+        }
+        if (record.type != WalRecordType::Payment) {
+            rented[id] = !rented[id];
+        }
+        encodeWalRecord(record, log_data);
+    }
+    ofstream(path, ios::binary | ios::trunc).write(log_data.data(), log_data.size());
+    
+    auto start = chrono::steady_clock::now();
+    size_t replayed = WalReplay::replay(path, 7);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    remove(path.c_str());
+    cout << "Replayed " << replayed << " records with " << workerCount() << " worker(s) in " 
+         << int(elapsed.count() * 1000) << " ms" << endl;
+}
+
+// Find newly overdue rentals among a million open ones: tracker vs a full deadline scan
+void runOverdueBenchmark() {
+    const int fleet_size = 1000000;
+    const int client_count = 1000;
+    const int steps = 200;
+    clearAllTables();
+    vehicle_inventory.reserve(fleet_size);
+    for (int i = 0; i < fleet_size; ++i) {
+        addVehicle(Vehicle("Toyota", "Corolla", 1000, 2000000, 5, "White"));
+    }
+    for (int i = 0; i < client_count; ++i) {
+        addClient(Client("user" + to_string(i), "pass"));
+    }
+    time_t base_time = time(0);
+    unsigned int seed = 12345;
+    for (int i = 0; i < fleet_size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        openRental(RenterRole::Client, 1 + i % client_count, i, base_time, base_time + (seed >> 8) % fleet_size);
+    }
+    
+    // Each step moves the clock forward far enough to expire about 100 rentals
+    size_t hooked = 0;
+    overdue_tracker.addHook([&hooked](const Rental&, int) { ++hooked; });
+    chrono::nanoseconds tracker_time(0), scan_time(0);
+    size_t scanned_overdue = 0;
+    for (int step = 1; step <= steps; ++step) {
+        time_t now = base_time + step * 100;
+        auto start = chrono::steady_clock::now();
+        overdue_tracker.advance(now);
+        auto middle = chrono::steady_clock::now();
+        scanned_overdue = 0;
+        for (int slot = 0; slot < fleet_size; ++slot) {
+            scanned_overdue += vehicle_inventory.is_rented[slot] && vehicle_inventory.return_deadline[slot] < now;
+        }
+        auto end = chrono::steady_clock::now();
+        tracker_time += middle - start;
+        scan_time += end - middle;
+    }
+    cout << "Overdue: " << hooked << " of " << fleet_size << " rentals expired over " << steps 
+         << " steps (scan agrees: " << (scanned_overdue == hooked ? "yes" : "no") << "); per step tracker " 
+         << tracker_time.count() / steps / 1000 << " us, full scan " << scan_time.count() / steps / 1000 << " us" << endl;
+    overdue_tracker = OverdueTracker();
+}
+
+// Late fee accrual: the selection scan over 10M synthetic rentals per kernel,
+// then full runs over 1M open rentals with about a tenth overdue, repeated in
+// the same period to show that nothing is charged twice
+void runAccrualBenchmark() {
+    const size_t rentals = 10000000;
+    const int passes = 5;
+    time_t now = time(0);
+    vector<time_t> deadlines(rentals);
+    vector<uint8_t> rented(rentals, 1);
+    vector<int32_t> accrued(rentals, 0);
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < rentals; ++i) {
+        seed = seed * 1103515245 + 12345;
+        bool overdue = (seed >> 8) % 10 == 0;
+        deadlines[i] = overdue ? now - SECONDS_PER_DAY * (1 + (seed >> 12) % 30) : now + (seed >> 12) % (SECONDS_PER_DAY * 7);
+    }
+    AccrualColumns columns{deadlines.data(), rented.data(), accrued.data(), rentals};
+    
+    const pair<FilterKernel, const char*> kernels[] = {{FilterKernel::Scalar, "scalar"}, {FilterKernel::Avx2, "avx2"}};
+    cout << setw(10) << "Kernel" << setw(12) << "ms/scan" << setw(12) << "Due" << endl;
+    for (const auto& kernel : kernels) {
+        if (kernel.first > bestFilterKernel()) {
+            continue;
+        }
+        SelectionBitmap selection;
+        auto start = chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            selectAccruableRentals(columns, now, selection, kernel.first);
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        size_t due = 0;
+        for (uint64_t word : selection) {
+            due += __builtin_popcountll(word);
+        }
+        cout << setw(10) << kernel.second << setw(12) << fixed << setprecision(2) 
+             << elapsed.count() * 1000 / passes << setw(12) << due << endl;
+    }
+    cout.unsetf(ios::fixed);
+    
+    const int fleet_size = 1000000;
+    populateSyntheticData(fleet_size, 10000);
+    for (int i = 0; i < fleet_size; ++i) {
+        openRental(RenterRole::Client, 1 + i % 10000, i, now - SECONDS_PER_DAY * 7, deadlines[i]);
+    }
+    for (time_t run_time : {now, now, now + SECONDS_PER_DAY}) {
+        auto start = chrono::steady_clock::now();
+        EngineResult result = rental_engine.accrueLateFees(run_time);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        cout << "Accrual at +" << (run_time - now) / SECONDS_PER_DAY << " day(s): charged " << result.value 
+             << " of " << fleet_size << " rentals in " << int(elapsed.count() * 1000) << " ms" << endl;
+    }
+    clearAllTables();
+    overdue_tracker = OverdueTracker();
+}
+
+// Fill a year of bookings on 100k vehicles, then ask which vehicles are free
+// for random periods, with and without a filter in front of the calendars
+void runReservationBenchmark() {
+    const int fleet_size = 100000;
+    const int bookings = 1000000;
+    const int queries = 50;
+    populateSyntheticData(fleet_size, 1000);
+    prepareConcurrentRentals();
+    time_t now = time(0);
+    unsigned int seed = 12345;
+    auto next = [&seed] { seed = seed * 1103515245 + 12345; return seed >> 8; };
+    
+    int booked = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < bookings; ++i) {
+        time_t from = now + SECONDS_PER_DAY * (1 + next() % 365);
+        time_t to = from + SECONDS_PER_DAY * (1 + next() % 7);
+        int vehicle_id = 1 + next() % fleet_size;
+        booked += rental_engine.reserve({RenterRole::Client, 1 + int(next() % 1000), vehicle_id, from, to}).status 
+                  == OperationStatus::Success;
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    cout << "Booked " << booked << " of " << bookings << " requested periods in " << int(elapsed.count() * 1000) 
+         << " ms (" << int(bookings / elapsed.count()) << " requests/s)" << endl;
+    
+    FleetFilter cheap;
+    cheap.max_rent = 1050;
+    const pair<const FleetFilter*, const char*> filters[] = {{nullptr, "whole fleet"}, {&cheap, "rent <= 1050"}};
+    for (const auto& filter : filters) {
+        size_t free_vehicles = 0;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < queries; ++i) {
+            time_t from = now + SECONDS_PER_DAY * (1 + next() % 365);
+            SelectionBitmap selection;
+            selectFreeVehicles(filter.first ? *filter.first : FleetFilter(), from, from + SECONDS_PER_DAY * 3, selection);
+            for (uint64_t word : selection) {
+                free_vehicles += __builtin_popcountll(word);
+            }
+        }
+        elapsed = chrono::steady_clock::now() - start;
+        cout << "Free for 3 days, " << filter.second << ": " << fixed << setprecision(2) 
+             << elapsed.count() * 1000 / queries << " ms per query, " << free_vehicles / queries 
+             << " vehicles on average" << endl;
+        cout.unsetf(ios::fixed);
+    }
+    clearAllTables();
+}
+
+// Build each report over 10M clients and 1M vehicles, then again while one
+// thread keeps renting and returning, to show the scans do not hold it up
+void runReportBenchmark() {
+    const size_t fleet_size = 1000000;
+    const size_t clients = 10000000;
+    populateSyntheticData(fleet_size, 0, 1000);
+    FleetStore& fleet = vehicle_inventory;
+    unsigned int seed = 12345;
+    for (size_t slot = 0; slot < fleet_size; ++slot) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t model = (seed >> 8) % 200;
+        fleet.setBrand(slot, "Brand" + to_string(model % 20));
+        fleet.setModel(slot, "Model" + to_string(model));
+        fleet.is_rented[slot] = (seed >> 16) % 4 == 0;
+        fleet.revenue[slot] = (seed >> 4) % 100000;
+    }
+    client_database.reserve(clients);
+    for (size_t i = 0; i < clients; ++i) {
+        seed = seed * 1103515245 + 12345;
+        int dues = (seed >> 8) % 3 == 0 ? (seed >> 12) % 100000 : 0;
+        addClient(Client("user" + to_string(i), "pass", 100 - (seed >> 16) % 40, dues));
+    }
+    
+    const pair<ReportKind, const char*> kinds[] = {{ReportKind::Revenue, "revenue"}, {ReportKind::Dues, "dues"}, 
+                                                   {ReportKind::Utilization, "utilization"}, 
+                                                   {ReportKind::TopRenters, "top-renters"}};
+    // Also syncs the versioned tables the reports read
+    prepareConcurrentRentals();
+    cout << setw(14) << "Report" << setw(8) << "Rows" << setw(12) << "ms" << endl;
+    for (const auto& kind : kinds) {
+        auto start = chrono::steady_clock::now();
+        ReportTable table = ReportBuilder::build(kind.first);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        cout << setw(14) << kind.second << setw(8) << table.rows.size() << setw(12) 
+             << int(elapsed.count() * 1000) << endl;
+    }
+    
+    atomic<bool> stop(false);
+    long long traffic = 0;
+    thread renter([&] {
+        for (int vehicle_id = 1; !stop.load(memory_order_relaxed); vehicle_id = vehicle_id % 1000 + 1) {
+            rental_engine.rent({RenterRole::Staff, 1, vehicle_id});
+            rental_engine.returnVehicle({RenterRole::Staff, 1, vehicle_id});
+            traffic += 2;
+        }
+    });
+    auto start = chrono::steady_clock::now();
+    for (const auto& kind : kinds) {
+        ReportBuilder::build(kind.first);
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    stop = true;
+    renter.join();
+    cout << "All reports alongside live rentals: " << int(elapsed.count() * 1000) << " ms, " 
+         << traffic << " rent/return operation(s) completed meanwhile" << endl;
+    clearAllTables();
+}
+
+// Rent and return on every core but one while the last thread keeps building
+// the full vehicles listing, first from snapshots and then the way the server
+// used to run reports, holding admin_edit_lock exclusively. Renters only ever
+// bill revenue and dues together, so after each listing a snapshot is checked
+// for total revenue equal to total dues; any difference is a torn view.
+void runVersionedTablesBenchmark() {
+    const size_t fleet_size = 1000000;
+    const int clients = 100000;
+    const unsigned renters = max(1u, workerCount() - 1);
+    populateSyntheticData(fleet_size, clients);
+    prepareConcurrentRentals();
+    
+    auto balanced = [] {
+        TableSnapshot snapshot;
+        int64_t revenue = 0, dues = 0;
+        for (size_t slot = 0; slot < snapshot.vehicleCount(); ++slot) {
+            revenue += snapshot.vehicle(slot).revenue;
+        }
+        for (const Client& client : client_database) {
+            dues += snapshot.account(RenterRole::Client, client.user_id).dues;
+        }
+        return revenue == dues;
+    };
+    
+    const char* readers[] = {"none", "snapshot", "exclusive lock"};
+    cout << setw(16) << "Listing reader" << setw(16) << "Rent+return/s" << setw(10) << "Listings" 
+         << setw(10) << "Torn" << endl;
+    for (int reader = 0; reader < 3; ++reader) {
+        atomic<bool> stop(false);
+        atomic<long long> operations{0};
+        vector<thread> threads;
+        for (unsigned index = 0; index < renters; ++index) {
+            threads.emplace_back([&, index] {
+                long long local = 0;
+                // Each thread keeps to its own vehicles, so rents never collide
+                for (size_t round = 0; !stop.load(memory_order_relaxed); ++round) {
+                    int vehicle_id = 1 + int((round * renters + index) % fleet_size);
+                    int client_id = 1 + int((round * renters + index) % clients);
+                    shared_lock<shared_mutex> shared(admin_edit_lock);
+                    rental_engine.rent({RenterRole::Client, client_id, vehicle_id});
+                    rental_engine.returnVehicle({RenterRole::Client, client_id, vehicle_id});
+                    local += 2;
+                }
+                operations += local;
+            });
+        }
+        
+        int listings = 0, torn = 0;
+        auto start = chrono::steady_clock::now();
+        while (chrono::steady_clock::now() - start < chrono::seconds(2)) {
+            if (reader == 0) {
+                this_thread::sleep_for(chrono::milliseconds(10));
+                continue;
+            }
+            if (reader == 1) {
+                ReportBuilder::build(ReportKind::Vehicles);
+                torn += !balanced();
+            } else {
+                unique_lock<shared_mutex> exclusive(admin_edit_lock);
+                ReportBuilder::build(ReportKind::Vehicles);
+                torn += !balanced();
+            }
+            ++listings;
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        stop = true;
+        for (auto& running : threads) {
+            running.join();
+        }
+        cout << setw(16) << readers[reader] << setw(16) << int(operations / elapsed.count()) << setw(10) << listings 
+             << setw(10) << torn << endl;
+    }
+    table_epochs.collect();
+    cout << "Pages copied for open snapshots: " << table_epochs.pages_copied.load() << ", freed: " 
+         << table_epochs.pages_freed.load() << endl;
+    clearAllTables();
+}
+
+// Selective searches over a 1M-vehicle fleet, answered from the secondary
+// indexes and by the SIMD scan plus per-row checks, then the cost of keeping
+// the indexes current through rent changes and rent/return flips
+void runSearchBenchmark() {
+    const size_t fleet_size = 1000000;
+    const int queries = 200;
+    const int updates = 200000;
+    populateSyntheticData(fleet_size, 0);
+    FleetStore& fleet = vehicle_inventory;
+    unsigned int seed = 12345;
+    auto next = [&seed] { seed = seed * 1103515245 + 12345; return seed >> 8; };
+    for (size_t slot = 0; slot < fleet_size; ++slot) {
+        uint32_t model = next() % 200;
+        fleet.setBrand(slot, "Brand" + to_string(model % 20));
+        fleet.setModel(slot, "Model" + to_string(model));
+        fleet.setColor(slot, "Color" + to_string(next() % 10));
+        fleet.setRent(slot, 500 + next() % 5000);
+        fleet.setSeats(slot, 2 + next() % 7);
+        fleet.setCondition(slot, 1 + next() % 10);
+        fleet.is_rented[slot] = next() % 4 == 0;
+    }
+    
+    auto start = chrono::steady_clock::now();
+    fleet.buildIndexes();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    cout << "Index build: " << int(elapsed.count() * 1000) << " ms, " << fleet.indexes.memoryBytes() / (1024 * 1024) 
+         << " MB" << endl;
+    
+    // The baseline: the scan kernels take what they can express, the rest is checked row by row
+    auto scanSearch = [](const FleetSearch& search, SelectionBitmap& selection) {
+        FleetFilter filter;
+        filter.min_seats = search.min_seats;
+        filter.max_rent = search.max_rent;
+        filter.min_condition = search.min_condition;
+        filter.match_brand = search.match_brand;
+        filter.brand_code = search.brand_code;
+        filter.match_color = search.match_color;
+        filter.color_code = search.color_code;
+        filterFleet(filter, selection);
+        for (size_t word = 0; word < selection.size(); ++word) {
+            for (uint64_t bits = selection[word]; bits != 0; bits &= bits - 1) {
+                if (!search.matches(word * 64 + __builtin_ctzll(bits))) {
+                    selection[word] &= ~(bits & -bits);
+                }
+            }
+        }
+    };
+    
+    FleetSearch exact, rent_band, family, premium, broad;
+    exact.setBrand("Brand3");
+    exact.setModel("Model23");
+    exact.setColor("Color4");
+    rent_band.min_rent = 1000;
+    rent_band.max_rent = 1010;
+    family.setModel("Model57");
+    family.min_seats = 7;
+    family.available_only = true;
+    premium.setBrand("Brand11");
+    premium.min_rent = 5000;
+    premium.min_condition = 9;
+    broad.max_seats = 4;
+    broad.max_rent = 3000;
+    const pair<const FleetSearch*, const char*> searches[] = {
+        {&exact, "brand+model+color"}, {&rent_band, "rent 1000-1010"}, {&family, "model+seats>=7+available"},
+        {&premium, "brand+rent>=5000+cond>=9"}, {&broad, "seats<=4+rent<=3000"}};
+    
+    auto timeSearch = [&](const FleetSearch& search, auto run, size_t& matches) {
+        SelectionBitmap selection;
+        auto begin = chrono::steady_clock::now();
+        for (int i = 0; i < queries; ++i) {
+            run(search, selection);
+        }
+        chrono::duration<double> took = chrono::steady_clock::now() - begin;
+        matches = countSelected(selection);
+        return took.count() * 1e6 / queries;
+    };
+    cout << setw(28) << "Search" << setw(10) << "Matches" << setw(14) << "index us" << setw(14) << "scan us" << endl;
+    for (const auto& search : searches) {
+        size_t indexed_matches = 0, scanned_matches = 0;
+        double indexed_us = timeSearch(*search.first, searchFleet, indexed_matches);
+        double scanned_us = timeSearch(*search.first, scanSearch, scanned_matches);
+        cout << setw(28) << search.second << setw(10) << indexed_matches << fixed << setprecision(1) 
+             << setw(14) << indexed_us << setw(14) << scanned_us
+             << (indexed_matches != scanned_matches ? "  MISMATCH" : "") << endl;
+        cout.unsetf(ios::fixed);
+    }
+    
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < updates; ++i) {
+        fleet.setRent(next() % fleet_size, 500 + next() % 5000);
+    }
+    elapsed = chrono::steady_clock::now() - start;
+    cout << "Rent change: " << fixed << setprecision(3) << elapsed.count() * 1e6 / updates << " us each" << endl;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < updates; ++i) {
+        size_t slot = next() % fleet_size;
+        fleet.setRented(slot, !fleet.is_rented[slot]);
+    }
+    elapsed = chrono::steady_clock::now() - start;
+    cout << "Rented flag flip: " << elapsed.count() * 1e6 / updates << " us each" << endl;
+    cout.unsetf(ios::fixed);
+    
+    size_t indexed_matches = 0, scanned_matches = 0;
+    double indexed_us = timeSearch(rent_band, searchFleet, indexed_matches);
+    timeSearch(rent_band, scanSearch, scanned_matches);
+    cout << "rent 1000-1010 after updates: " << indexed_matches << " matches, " << fixed << setprecision(1) 
+         << indexed_us << " us" << (indexed_matches != scanned_matches ? "  MISMATCH" : "") << endl;
+    cout.unsetf(ios::fixed);
+    clearAllTables();
+}
+
+// Rent/return throughput with nobody listening, with fast consumers, and
+// with a slow consumer under each overflow policy. Renters never wait for
+// consumers, so what the scenarios change is where events get dropped.
+void runEventBenchmark() {
+    const int fleet_size = 100000;
+    const int pairs_per_thread = 100000;
+    const unsigned threads = max(4u, workerCount());
+    struct Scenario {
+        const char* name;
+        int consumers;
+        bool slow;
+        OverflowPolicy policy;
+    };
+    const Scenario scenarios[] = {
+        {"no subscribers", 0, false, OverflowPolicy::Drop}, {"1 consumer", 1, false, OverflowPolicy::Drop},
+        {"3 consumers", 3, false, OverflowPolicy::Drop}, {"slow consumer, drop", 1, true, OverflowPolicy::Drop},
+        {"slow consumer, wait", 1, true, OverflowPolicy::Wait}};
+    
+    cout << setw(22) << "Scenario" << setw(12) << "Ops/s" << setw(12) << "Delivered" << setw(14) << "Sub drops" 
+         << setw(14) << "Inbox drops" << endl;
+    for (const Scenario& scenario : scenarios) {
+        populateSyntheticData(fleet_size, 0, threads);
+        prepareConcurrentRentals();
+        uint64_t inbox_drops_before = event_bus.inboxDrops();
+        vector<shared_ptr<EventSubscription>> subscriptions;
+        vector<uint64_t> delivered(scenario.consumers, 0);
+        vector<thread> consumers;
+        for (int c = 0; c < scenario.consumers; ++c) {
+            subscriptions.push_back(event_bus.subscribe("bench" + to_string(c), 1 << 16, scenario.policy));
+        }
+        for (int c = 0; c < scenario.consumers; ++c) {
+            consumers.emplace_back([&, c] {
+                RentalEvent event;
+                uint64_t received = 0;
+                while (true) {
+                    bool running = event_bus.running();
+                    if (subscriptions[c]->poll(event)) {
+                        // A slow consumer: 50 us of work every 64 events
+                        if (++received % 64 == 0 && scenario.slow) {
+                            this_thread::sleep_for(chrono::microseconds(50));
+                        }
+                        continue;
+                    }
+                    if (!running) {
+                        break;
+                    }
+                    this_thread::sleep_for(chrono::microseconds(200));
+                }
+                delivered[c] = received;
+            });
+        }
+        
+        auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([t] {
+                int staff_id = t + 1;
+                for (int i = 0; i < pairs_per_thread; ++i) {
+                    int vehicle_id = 1 + (t * 1000 + i % 1000) % fleet_size;
+                    rental_engine.rent({RenterRole::Staff, staff_id, vehicle_id});
+                    rental_engine.returnVehicle({RenterRole::Staff, staff_id, vehicle_id});
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        event_bus.stop();
+        for (auto& consumer : consumers) {
+            consumer.join();
+        }
+        uint64_t subscriber_drops = 0, total_delivered = 0;
+        for (int c = 0; c < scenario.consumers; ++c) {
+            subscriber_drops += subscriptions[c]->dropped();
+            total_delivered += delivered[c];
+            event_bus.unsubscribe(subscriptions[c]);
+        }
+        cout << setw(22) << scenario.name << setw(12) << int(2.0 * pairs_per_thread * threads / elapsed.count()) 
+             << setw(12) << total_delivered << setw(14) << subscriber_drops 
+             << setw(14) << event_bus.inboxDrops() - inbox_drops_before << endl;
+    }
+    clearAllTables();
+}
+
+// Mixed rent/return throughput as cores are added: the shared engine with N
+// threads against the sharded runtime with N shards, on the same uniform trace
+void runShardBenchmark() {
+    LoadProfile profile;
+    profile.operations = 2000000;
+    profile.vehicles = profile.clients = 200000;
+    profile.staff = 20000;
+    profile.vehicle_skew = profile.renter_skew = 0;
+    const int mix[LOAD_OP_COUNT] = {0, 50, 50, 0, 0, 0};
+    copy(begin(mix), end(mix), profile.mix);
+    populateSyntheticData(profile.vehicles, profile.clients, profile.staff);
+    vector<TraceRecord> trace = generateTrace(profile);
+    
+    vector<int> counts = {1, 2, 4};
+    for (int more = 8; more <= (int)workerCount(); more *= 2) {
+        counts.push_back(more);
+    }
+    cout << setw(8) << "Cores" << setw(14) << "Shared ops/s" << setw(15) << "Sharded ops/s" 
+         << setw(12) << "Messages" << endl;
+    for (int cores : counts) {
+        vector<ReplayStats> stats;
+        populateSyntheticData(profile.vehicles, profile.clients, profile.staff);
+        double shared_seconds = replayShared(trace, cores, stats);
+        populateSyntheticData(profile.vehicles, profile.clients, profile.staff);
+        ShardedRuntime runtime(cores);
+        double sharded_seconds = runtime.replay(trace, stats);
+        cout << setw(8) << cores << setw(14) << int(trace.size() / shared_seconds) 
+             << setw(15) << int(trace.size() / sharded_seconds) << setw(12) << runtime.crossShardMessages() << endl;
+    }
+    clearAllTables();
+}
+
+#ifdef RENTAL_SERVER
+// Closed-loop load on an in-process server over a Unix socket. Every
+// connection logs in as its own staff member, then alternately rents and
+// returns its own vehicle with one request in flight, so throughput is bound
+// by round trips and the server's loops rather than by row contention.
+void runServerBenchmark() {
+    const int connection_counts[] = {100, 1000, 4000};
+    const int requests_per_connection = 100;
+    const unsigned drivers = min(4u, workerCount());
+    raiseDescriptorLimit();
+    string address = "unix:/tmp/car-bench-" + to_string(getpid()) + ".sock";
+    struct Connection {
+        int descriptor;
+        int id;
+        int answered = -1;  // -1 until the login is answered
+        string input;
+        chrono::steady_clock::time_point sent_at;
+    };
+    auto request = [](const Connection& connection) {
+        const char* verb = connection.answered % 2 == 0 ? "rent" : "return";
+        return string(verb) + " staff " + to_string(connection.id) + " " + to_string(connection.id) + "\n";
+    };
+    auto percentile = [](vector<uint32_t>& samples, double fraction) {
+        size_t rank = min(samples.size() - 1, size_t(fraction * samples.size()));
+        nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        return samples[rank] / 1000;
+    };
+    
+    cout << setw(12) << "Connections" << setw(12) << "Req/s" << setw(12) << "p50 us" << setw(12) << "p99 us" 
+         << setw(12) << "p99.9 us" << setw(10) << "Errors" << endl;
+    for (int connection_count : connection_counts) {
+        populateSyntheticData(connection_count, 0, connection_count);
+        RentalServer server;
+        string error;
+        if (!server.open(address, false, error)) {
+            cout << "Cannot serve on " << address << ": " << error << endl;
+            break;
+        }
+        thread serving(&RentalServer::run, &server, workerCount());
+        
+        vector<vector<uint32_t>> latencies(drivers);
+        atomic<int> errors{0};
+        auto drive = [&](unsigned driver) {
+            int epoll_descriptor = epoll_create1(EPOLL_CLOEXEC);
+            vector<Connection> connections;
+            for (int id = 1 + driver; id <= connection_count; id += drivers) {
+                int descriptor = connectToServer(address);
+                if (descriptor < 0) {
+                    errors.fetch_add(1);
+                    continue;
+                }
+                connections.push_back({descriptor, id, -1, {}, {}});
+            }
+            for (size_t i = 0; i < connections.size(); ++i) {
+                Connection& connection = connections[i];
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.u64 = i;
+                epoll_ctl(epoll_descriptor, EPOLL_CTL_ADD, connection.descriptor, &event);
+                sendAll(connection.descriptor, "login staff staff" + to_string(connection.id - 1) + " pass\n");
+            }
+            size_t finished = 0;
+            vector<epoll_event> events(256);
+            char buffer[4096];
+            while (finished < connections.size()) {
+                int count = epoll_wait(epoll_descriptor, events.data(), (int)events.size(), 1000);
+                if (count <= 0) {
+                    break;
+                }
+                for (int e = 0; e < count; ++e) {
+                    Connection& connection = connections[events[e].data.u64];
+                    ssize_t received = recv(connection.descriptor, buffer, sizeof(buffer), 0);
+                    if (received <= 0) {
+                        errors.fetch_add(1);
+                        ++finished;
+                        epoll_ctl(epoll_descriptor, EPOLL_CTL_DEL, connection.descriptor, nullptr);
+                        continue;
+                    }
+                    connection.input.append(buffer, received);
+                    if (connection.input.back() != '\n') {
+                        continue;
+                    }
+                    if (connection.input.find("\"ok\"") == string::npos) {
+                        errors.fetch_add(1);
+                    }
+                    connection.input.clear();
+                    auto now = chrono::steady_clock::now();
+                    if (connection.answered >= 0) {
+                        latencies[driver].push_back(chrono::duration_cast<chrono::nanoseconds>(now - connection.sent_at).count());
+                    }
+                    if (++connection.answered == requests_per_connection) {
+                        ++finished;
+                        continue;
+                    }
+                    connection.sent_at = now;
+                    sendAll(connection.descriptor, request(connection));
+                }
+            }
+            for (Connection& connection : connections) {
+                ::close(connection.descriptor);
+            }
+            ::close(epoll_descriptor);
+        };
+        
+        auto start = chrono::steady_clock::now();
+        vector<thread> threads;
+        for (unsigned driver = 0; driver < drivers; ++driver) {
+            threads.emplace_back(drive, driver);
+        }
+        for (auto& running : threads) {
+            running.join();
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        server.stop();
+        serving.join();
+        
+        vector<uint32_t> samples;
+        for (auto& driver_samples : latencies) {
+            samples.insert(samples.end(), driver_samples.begin(), driver_samples.end());
+        }
+        if (samples.empty()) {
+            samples.push_back(0);
+        }
+        cout << setw(12) << connection_count << setw(12) << int(server.requests() / elapsed.count()) 
+             << setw(12) << percentile(samples, 0.50) << setw(12) << percentile(samples, 0.99) 
+             << setw(12) << percentile(samples, 0.999) << setw(10) << errors.load() << endl;
+    }
+    clearAllTables();
+}
+#endif
+
+// Cost of timing one operation into the shared histograms, alone and with
+// every core recording into the same operation at once
+void runMetricsBenchmark() {
+    const size_t operations = 10000000;
+    auto record = [](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            OperationTimer timer(MetricOp::Pay);
+            timer.finish(OperationStatus::Success);
+        }
+    };
+    auto start = chrono::steady_clock::now();
+    record(operations);
+    double single_ns = (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    
+    unsigned workers = workerCount();
+    start = chrono::steady_clock::now();
+    parallelFor(operations * workers, workers, [&record](size_t begin, size_t end) { record(end - begin); });
+    double parallel_ns = (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    
+    // The cycle counter is read twice per operation; virtual machines may trap it
+    uint64_t checksum = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+        checksum += readCycles();
+    }
+    double counter_ns = (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    
+    cout << "Metrics: " << fixed << setprecision(1) << single_ns / operations << " ns per recorded operation (" 
+         << 2 * counter_ns / operations << " ns of it reading the cycle counter), " 
+         << parallel_ns / operations << " ns per operation per thread with " << workers << " thread(s) recording" 
+         << (checksum == 0 ? " " : "") << "\n";
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+// Render a 100k-vehicle listing to /dev/null: per-field iostream output with
+// endl (the old listing code) vs the buffered renderer, cold and warm cache
+void runListingBenchmark() {
+    const int fleet_size = 100000;
+    clearAllTables();
+    vehicle_inventory.reserve(fleet_size);
+    for (int i = 0; i < fleet_size; ++i) {
+        addVehicle(Vehicle("Toyota", "Corolla", 1000 + i % 500, 2000000, 5, "White"));
+    }
+    for (int i = 0; i < fleet_size; i += 3) {
+        openRental(RenterRole::Client, 1, i, time(0), time(0) + SECONDS_PER_DAY * (1 + i % 7));
+    }
+    
+    time_t current_time = time(0);
+    const FleetStore& fleet = vehicle_inventory;
+    ofstream stream_sink("/dev/null");
+    auto start = chrono::steady_clock::now();
+    for (int slot = 0; slot < fleet_size; ++slot) {
+        stream_sink << setw(3) << fleet.vehicle_id[slot] << setw(15) << fleet.brand(slot) 
+                    << setw(15) << fleet.model(slot) << setw(7) << fleet.daily_rent[slot] 
+                    << setw(12) << fleet.market_price[slot] << setw(6) << fleet.seating_capacity[slot] 
+                    << setw(10) << fleet.color(slot) << setw(10) << !fleet.is_rented[slot] 
+                    << setw(10) << fleet.vehicle_condition[slot] << setw(15);
+        time_t deadline = fleet.return_deadline[slot];
+        if (deadline == 0) {
+            stream_sink << "Not rented" << endl;
+        } else {
+            auto date_structure = localtime(&deadline);
+            stream_sink << date_structure->tm_mday << "/" << (1 + date_structure->tm_mon) << "/" 
+                        << (1900 + date_structure->tm_year) << endl;
+        }
+    }
+    chrono::duration<double> stream_time = chrono::steady_clock::now() - start;
+    
+    FILE* sink = fopen("/dev/null", "wb");
+    if (sink == nullptr) {
+        return;
+    }
+    double buffered_ms[2];
+    for (int pass = 0; pass < 2; ++pass) {
+        auto pass_start = chrono::steady_clock::now();
+        OutputBuffer out(sink);
+        for (int slot = 0; slot < fleet_size; ++slot) {
+            vehicle_row_cache.render(out, slot, current_time);
+            out.endRow();
+        }
+        out.flush();
+        buffered_ms[pass] = chrono::duration<double, milli>(chrono::steady_clock::now() - pass_start).count();
+    }
+    fclose(sink);
+    cout << "Listing " << fleet_size << " vehicles: iostream " << int(stream_time.count() * 1000) << " ms, buffered " 
+         << int(buffered_ms[0]) << " ms cold, " << int(buffered_ms[1]) << " ms cached (" 
+         << vehicle_row_cache.hits << " hits)" << endl;
+}
+
+// Stress rent/return from 1..N threads, most of them fighting over a few
+// popular cars. Every worker keeps a shadow holder count per vehicle; any
+// rent that succeeds while another thread still holds the car is a double booking.
+void runConcurrencyBenchmark() {
+    const int fleet_size = 100000;
+    const int popular_vehicles = 32;
+    const int operations_per_thread = 400000;
+    unsigned max_threads = max(4u, workerCount());
+    
+    cout << setw(8) << "Threads" << setw(14) << "Ops/s" << setw(12) << "Rented" 
+         << setw(12) << "Contended" << setw(16) << "Double-booked" << endl;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        clearAllTables();
+        vehicle_inventory.reserve(fleet_size);
+        for (int i = 0; i < fleet_size; ++i) {
+            addVehicle(Vehicle("Toyota", "Corolla", 1000, 2000000, 5, "White"));
+        }
+        for (unsigned t = 0; t < threads; ++t) {
+            addClient(Client("worker" + to_string(t), "pass"));
+        }
+        prepareConcurrentRentals();
+        
+        unique_ptr<atomic<int>[]> holders(new atomic<int>[fleet_size + 1]());
+        atomic<long long> rented(0), contended(0), double_booked(0), charged(0);
+        auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                int client_id = t + 1;
+                vector<int> held;
+                unsigned int seed = 12345 + t * 7919;
+                long long my_rented = 0, my_contended = 0, my_charged = 0;
+                for (int i = 0; i < operations_per_thread; ++i) {
+                    seed = seed * 1103515245 + 12345;
+                    if (held.size() < 4 && (seed >> 16) % 2 == 0) {
+                        // Nine rents in ten go to the popular cars
+                        int vehicle_id = (seed >> 4) % 10 != 0 ? 1 + (seed >> 8) % popular_vehicles 
+                                                               : 1 + (seed >> 8) % fleet_size;
+                        EngineResult result = rental_engine.rent({RenterRole::Client, client_id, vehicle_id});
+                        if (result.status == OperationStatus::Success) {
+                            if (holders[vehicle_id].fetch_add(1) != 0) {
+                                ++double_booked;
+                            }
+                            held.push_back(vehicle_id);
+                            ++my_rented;
+                            my_charged += result.value;
+                        } else {
+                            ++my_contended;
+                        }
+                    } else if (!held.empty()) {
+                        int vehicle_id = held.back();
+                        held.pop_back();
+                        holders[vehicle_id].fetch_sub(1);
+                        rental_engine.returnVehicle({RenterRole::Client, client_id, vehicle_id});
+                    }
+                }
+                rented += my_rented;
+                contended += my_contended;
+                charged += my_charged;
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        
+        // Cross-check the tables: each rented flag matches exactly one open rental
+        // and the dues charged equal the charges reported to the workers
+        vector<int> rentals_per_vehicle(fleet_size + 1, 0);
+        long long total_dues = 0;
+        for (const Client& client : client_database) {
+            total_dues += rental_engine.dues({RenterRole::Client, client.user_id}).value;
+            for (int slot = firstRental(RenterRole::Client, client.user_id); slot != -1; 
+                 slot = rental_table[slot].next_by_renter) {
+                ++rentals_per_vehicle[rental_table[slot].vehicle_id];
+            }
+        }
+        for (int slot = 0; slot < fleet_size; ++slot) {
+            if (rentals_per_vehicle[slot + 1] != vehicle_inventory.is_rented[slot]) {
+                ++double_booked;
+            }
+        }
+        if (total_dues != charged) {
+            ++double_booked;
+        }
+        
+        cout << setw(8) << threads << setw(14) << int(threads * operations_per_thread / elapsed.count()) 
+             << setw(12) << rented << setw(12) << contended << setw(16) << double_booked << endl;
+    }
+}
+
+// Push a generated command stream through batch mode, results discarded
+void runBatchBenchmark() {
+    const string path = "car_bench.batch";
+    const int accounts = 100000;
+    const int commands = 1000000;
+    clearAllTables();
+    for (int i = 0; i < accounts; ++i) {
+        addVehicle(Vehicle("Toyota", "Corolla", 1000, 2000000, 5, "White"));
+        addClient(Client("user" + to_string(i), "pass"));
+    }
+    
+    string script;
+    vector<char> rented(accounts + 1, 0);
+    unsigned int seed = 12345;
+    for (int i = 0; i < commands; ++i) {
+        seed = seed * 1103515245 + 12345;
+        int id = 1 + (seed >> 8) % accounts;
+        string id_str = to_string(id);
+        switch ((seed >> 4) % 4) {
+            case 0: script += "pay client " + id_str + " 10\n"; break;
+            case 1: script += "dues client " + id_str + "\n"; break;
+            default:
+                script += (rented[id] ? "return client " : "rent client ") + id_str + " " + id_str + "\n";
+                rented[id] = !rented[id];
+                break;
+        }
+    }
+    ofstream(path, ios::binary | ios::trunc).write(script.data(), script.size());
+    
+    FILE* input = fopen(path.c_str(), "rb");
+    FILE* output = fopen("/dev/null", "wb");
+    if (input == nullptr || output == nullptr) {
+        cout << "Batch benchmark skipped: cannot open " << path << endl;
+    } else {
+        BatchRunner runner(output);
+        auto start = chrono::steady_clock::now();
+        runner.run(input);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        cout << "Batch: " << runner.executed << " commands (" << runner.failed << " rejected) in " 
+             << int(elapsed.count() * 1000) << " ms, " << int(runner.executed / elapsed.count()) << " ops/s" << endl;
+    }
+    if (input != nullptr) {
+        fclose(input);
+    }
+    if (output != nullptr) {
+        fclose(output);
+    }
+    remove(path.c_str());
+}
+
+// Hot-path microbenchmarks on synthetic datasets, written as JSON Lines and
+// optionally compared against a stored baseline. Run with:
+//   car --microbench [--sizes 10,1000,...] [--out FILE] [--baseline FILE] [--tolerance 0.25]
+const int BENCH_REPETITIONS = 3;
+
+struct BenchResult {
+    string name;
+    size_t records;
+    double ns_per_op;
+    size_t operations;
+};
+
+// Run one hot path after another against a dataset of the given size
+void benchmarkDataset(size_t records, vector<BenchResult>& results) {
+    const size_t target_operations = 200000;
+    populateSyntheticData(records, records);
+    unsigned int seed = 12345;
+    auto next_random = [&seed] {
+        seed = seed * 1103515245 + 12345;
+        return seed >> 8;
+    };
+    auto elapsed_ns = [](chrono::steady_clock::time_point start) {
+        return (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    };
+    auto record = [&](const char* name, double total_ns, size_t operations) {
+        results.push_back({name, records, total_ns / max<size_t>(operations, 1), operations});
+    };
+    // Keep the fastest of several passes so scheduler noise doesn't read as a regression
+    auto best_of = [](auto pass) {
+        double best = pass();
+        for (int repetition = 1; repetition < BENCH_REPETITIONS; ++repetition) {
+            best = min(best, pass());
+        }
+        return best;
+    };
+    
+    // Vehicle lookup by ID
+    {
+        vector<int> vehicle_ids(target_operations);
+        for (int& vehicle_id : vehicle_ids) {
+            vehicle_id = 1 + next_random() % records;
+        }
+        size_t found = 0;
+        record("vehicle_lookup", best_of([&] {
+            auto start = chrono::steady_clock::now();
+            for (int vehicle_id : vehicle_ids) {
+                found += (findVehicleSlot(vehicle_id) >= 0);
+            }
+            return elapsed_ns(start);
+        }), vehicle_ids.size());
+        if (found != BENCH_REPETITIONS * vehicle_ids.size()) {
+            cout << "Vehicle lookup benchmark produced unexpected results\n";
+        }
+    }
+    
+    // Login by username and password
+    {
+        vector<Credentials> logins(target_operations);
+        for (Credentials& credentials : logins) {
+            credentials = {RenterRole::Client, "user" + to_string(next_random() % records), "pass"};
+        }
+        size_t successes = 0;
+        record("login", best_of([&] {
+            auto start = chrono::steady_clock::now();
+            for (const Credentials& credentials : logins) {
+                successes += (rental_engine.login(credentials).status == OperationStatus::Success);
+            }
+            return elapsed_ns(start);
+        }), logins.size());
+        if (successes != BENCH_REPETITIONS * logins.size()) {
+            cout << "Login benchmark produced unexpected results\n";
+        }
+    }
+    
+    // Rent and return every vehicle in a batch, round after round, so small
+    // datasets still run enough operations to time
+    {
+        size_t batch = min(records, target_operations);
+        vector<RentalRequest> requests(batch);
+        for (size_t i = 0; i < batch; ++i) {
+            int vehicle_id = batch == records ? int(i + 1) : int(1 + next_random() % records);
+            requests[i] = {RenterRole::Client, int(1 + next_random() % records), vehicle_id};
+        }
+        size_t rounds = max<size_t>(1, target_operations / batch);
+        double best_rent_ns = 0, best_return_ns = 0;
+        for (int repetition = 0; repetition < BENCH_REPETITIONS; ++repetition) {
+            double rent_ns = 0, return_ns = 0;
+            for (size_t round = 0; round < rounds; ++round) {
+                auto start = chrono::steady_clock::now();
+                for (const RentalRequest& request : requests) {
+                    rental_engine.rent(request);
+                }
+                rent_ns += elapsed_ns(start);
+                start = chrono::steady_clock::now();
+                for (const RentalRequest& request : requests) {
+                    rental_engine.returnVehicle(request);
+                }
+                return_ns += elapsed_ns(start);
+            }
+            best_rent_ns = repetition == 0 ? rent_ns : min(best_rent_ns, rent_ns);
+            best_return_ns = repetition == 0 ? return_ns : min(best_return_ns, return_ns);
+        }
+        record("rent", best_rent_ns, rounds * batch);
+        record("return", best_return_ns, rounds * batch);
+        
+        // Every renter above now owes at least one day's rent per pass
+        record("pay_dues", best_of([&] {
+            auto start = chrono::steady_clock::now();
+            for (size_t i = 0; i < target_operations; ++i) {
+                const RentalRequest& renter = requests[i % batch];
+                rental_engine.pay({RenterRole::Client, renter.renter_id, 1});
+            }
+            return elapsed_ns(start);
+        }), target_operations);
+    }
+    
+    // Full fleet listing to /dev/null, first with a cold row cache, then warm
+    FILE* sink = fopen("/dev/null", "wb");
+    if (sink != nullptr) {
+        size_t rows = min<size_t>(records, 1000000);
+        time_t current_time = time(0);
+        auto render_listing = [&] {
+            auto start = chrono::steady_clock::now();
+            OutputBuffer out(sink);
+            for (size_t slot = 0; slot < rows; ++slot) {
+                vehicle_row_cache.render(out, slot, current_time);
+                out.endRow();
+            }
+            out.flush();
+            return elapsed_ns(start);
+        };
+        record("fleet_listing_cold", best_of([&] {
+            vehicle_row_cache.clear();
+            return render_listing();
+        }), rows);
+        record("fleet_listing_cached", best_of(render_listing), rows);
+        fclose(sink);
+    }
+    
+    // Admin removals; each one changes the tables, so only a bounded number are timed
+    {
+        size_t removals = max<size_t>(1, min<size_t>(records / 2, 1000));
+        vector<int> vehicle_ids, client_ids;
+        for (size_t i = 0; i < removals; ++i) {
+            vehicle_ids.push_back(int(records - i));
+            client_ids.push_back(int(records - i));
+        }
+        // Clear any dues left by the rent round so the removals go through
+        for (int client_id : client_ids) {
+            int dues = (int)rental_engine.dues({RenterRole::Client, client_id}).value;
+            if (dues > 0) {
+                rental_engine.pay({RenterRole::Client, client_id, dues});
+            }
+        }
+        auto start = chrono::steady_clock::now();
+        for (int vehicle_id : vehicle_ids) {
+            rental_engine.removeVehicle(vehicle_id);
+        }
+        record("admin_remove_vehicle", elapsed_ns(start), removals);
+        start = chrono::steady_clock::now();
+        for (int client_id : client_ids) {
+            rental_engine.removeAccount({RenterRole::Client, client_id});
+        }
+        record("admin_remove_client", elapsed_ns(start), removals);
+    }
+}
+
+void writeBenchResults(const vector<BenchResult>& results, FILE* output) {
+    for (const BenchResult& result : results) {
+        fprintf(output, "{\"name\":\"%s\",\"records\":%zu,\"ns_per_op\":%.1f,\"operations\":%zu}\n",
+                result.name.c_str(), result.records, result.ns_per_op, result.operations);
+    }
+}
+
+// Read results written by writeBenchResults
+vector<BenchResult> readBenchResults(const string& path) {
+    vector<BenchResult> results;
+    ifstream input(path);
+    string line;
+    while (getline(input, line)) {
+        char name[64];
+        BenchResult result;
+        if (sscanf(line.c_str(), "{\"name\":\"%63[^\"]\",\"records\":%zu,\"ns_per_op\":%lf,\"operations\":%zu}",
+                   name, &result.records, &result.ns_per_op, &result.operations) == 4) {
+            result.name = name;
+            results.push_back(result);
+        }
+    }
+    return results;
+}
+
+// Print each result next to its baseline. Returns the number of regressions,
+// i.e. results slower than the baseline by more than the tolerance.
+int compareBenchResults(const vector<BenchResult>& results, const vector<BenchResult>& baseline, double tolerance) {
+    int regressions = 0;
+    cout << left << setw(24) << "Benchmark" << right << setw(10) << "Records" << setw(14) << "ns/op" 
+         << setw(14) << "Baseline" << setw(10) << "Change" << endl;
+    for (const BenchResult& result : results) {
+        cout << left << setw(24) << result.name << right << setw(10) << result.records 
+             << setw(14) << fixed << setprecision(1) << result.ns_per_op;
+        auto base = find_if(baseline.begin(), baseline.end(), [&result](const BenchResult& entry) {
+            return entry.name == result.name && entry.records == result.records;
+        });
+        if (base == baseline.end() || base->ns_per_op <= 0) {
+            cout << setw(14) << "-" << setw(10) << "-" << endl;
+            continue;
+        }
+        double change = result.ns_per_op / base->ns_per_op - 1;
+        bool regressed = change > tolerance;
+        regressions += regressed;
+        cout << setw(14) << base->ns_per_op << setw(9) << showpos << change * 100 << noshowpos << "%" 
+             << (regressed ? "  REGRESSION" : "") << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    return regressions;
+}
+
+// Entry point for --microbench. Exit status 2 means a regression against the baseline.
+int runMicrobenchmarks(const vector<size_t>& sizes, const string& output_path, 
+                       const string& baseline_path, double tolerance) {
+    vector<BenchResult> results;
+    for (size_t records : sizes) {
+        benchmarkDataset(records, results);
+    }
+    clearAllTables();
+    
+    if (!output_path.empty()) {
+        FILE* output = fopen(output_path.c_str(), "w");
+        if (output == nullptr) {
+            cout << "Cannot write benchmark results to " << output_path << "\n";
+            return 1;
+        }
+        writeBenchResults(results, output);
+        fclose(output);
+    }
+    
+    vector<BenchResult> baseline;
+    if (!baseline_path.empty()) {
+        baseline = readBenchResults(baseline_path);
+        if (baseline.empty()) {
+            cout << "No baseline results in " << baseline_path << "\n";
+        }
+    }
+    int regressions = compareBenchResults(results, baseline, tolerance);
+    if (regressions > 0) {
+        cout << regressions << " benchmark(s) regressed by more than " << int(tolerance * 100) << "%\n";
+        return 2;
+    }
+    return 0;
+}
+
+//======================= MAIN FUNCTION =======================//
+
+int main(int argc, char* argv[]) {
+    string snapshot_path;
+    string batch_path;
+    bool microbench = false;
+    vector<size_t> bench_sizes = {10, 1000, 100000, 1000000};
+    string bench_output, bench_baseline;
+    double bench_tolerance = 0.25;
+    bool generate_load = false;
+    LoadProfile load_profile;
+    int load_threads = max(1, int(thread::hardware_concurrency()));
+    int load_shards = 0;  // 0 replays through the shared engine
+    string record_trace_path, replay_trace_path;
+    string audit_path;
+    string serve_address, connect_address;
+    bool allow_remote = false;
+    unsigned server_threads = workerCount();
+    chrono::microseconds commit_delay(1000);
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "--bench") {
+            runLookupBenchmark();
+            runLoginBenchmark();
+            runFilterBenchmark();
+            runStringPoolBenchmark();
+            runRemovalBenchmark();
+            runImportBenchmark();
+            runSnapshotBenchmark();
+            runTransactionLogBenchmark();
+            runBatchBenchmark();
+            runConcurrencyBenchmark();
+            runOverdueBenchmark();
+            runListingBenchmark();
+            runMetricsBenchmark();
+            runAccrualBenchmark();
+            runReportBenchmark();
+            runVersionedTablesBenchmark();
+            runReservationBenchmark();
+            runSearchBenchmark();
+            runEventBenchmark();
+#ifdef RENTAL_SERVER
+            runServerBenchmark();
+#endif
+            runShardBenchmark();
+            return 0;
+        } else if (argument == "--snapshot" && i + 1 < argc) {
+            snapshot_path = argv[++i];
+        } else if (argument == "--commit-delay-us" && i + 1 < argc) {
+            commit_delay = chrono::microseconds(convertStringToInt(argv[++i]));
+        } else if (argument == "--batch" && i + 1 < argc) {
+            batch_path = argv[++i];
+        } else if (argument == "--audit" && i + 1 < argc) {
+            audit_path = argv[++i];
+#ifdef RENTAL_SERVER
+        } else if (argument == "--serve" && i + 1 < argc) {
+            serve_address = argv[++i];
+        } else if (argument == "--server-threads" && i + 1 < argc) {
+            server_threads = max(1, convertStringToInt(argv[++i]));
+        } else if (argument == "--allow-remote") {
+            allow_remote = true;
+        } else if (argument == "--connect" && i + 1 < argc) {
+            connect_address = argv[++i];
+#endif
+        } else if (argument == "--microbench") {
+            microbench = true;
+        } else if (argument == "--sizes" && i + 1 < argc) {
+            bench_sizes.clear();
+            stringstream list(argv[++i]);
+            string size;
+            while (getline(list, size, ',')) {
+                bench_sizes.push_back(max(1, convertStringToInt(size)));
+            }
+        } else if (argument == "--out" && i + 1 < argc) {
+            bench_output = argv[++i];
+        } else if (argument == "--baseline" && i + 1 < argc) {
+            bench_baseline = argv[++i];
+        } else if (argument == "--tolerance" && i + 1 < argc) {
+            bench_tolerance = atof(argv[++i]);
+        } else if (argument == "--load") {
+            generate_load = true;
+        } else if (argument == "--ops" && i + 1 < argc) {
+            load_profile.operations = max(1, convertStringToInt(argv[++i]));
+        } else if (argument == "--records" && i + 1 < argc) {
+            load_profile.vehicles = load_profile.clients = max(1, convertStringToInt(argv[++i]));
+            load_profile.staff = max<size_t>(1, load_profile.clients / 10);
+        } else if (argument == "--threads" && i + 1 < argc) {
+            load_threads = max(1, convertStringToInt(argv[++i]));
+        } else if (argument == "--shards" && i + 1 < argc) {
+            load_shards = max(1, convertStringToInt(argv[++i]));
+        } else if (argument == "--skew" && i + 1 < argc) {
+            load_profile.vehicle_skew = load_profile.renter_skew = atof(argv[++i]);
+        } else if (argument == "--vehicle-skew" && i + 1 < argc) {
+            load_profile.vehicle_skew = atof(argv[++i]);
+        } else if (argument == "--renter-skew" && i + 1 < argc) {
+            load_profile.renter_skew = atof(argv[++i]);
+        } else if (argument == "--mix" && i + 1 < argc && parseLoadMix(argv[i + 1], load_profile)) {
+            ++i;
+        } else if (argument == "--seed" && i + 1 < argc) {
+            load_profile.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--record-trace" && i + 1 < argc) {
+            record_trace_path = argv[++i];
+        } else if (argument == "--replay-trace" && i + 1 < argc) {
+            replay_trace_path = argv[++i];
+        } else {
+            cout << "Usage: " << argv[0] << " [--snapshot FILE [--commit-delay-us N]] [--batch FILE|-] [--audit FILE] [--bench]\n"
+                 << "       " << argv[0] << " --microbench [--sizes N,N,...] [--out FILE] [--baseline FILE] [--tolerance F]\n"
+                 << "       " << argv[0] << " [--snapshot FILE] --load [--ops N] [--records N] [--threads N|--shards N] [--skew S]\n"
+                 << "              [--vehicle-skew S] [--renter-skew S] [--mix op=weight,...] [--seed N] [--record-trace FILE]\n"
+                 << "       " << argv[0] << " [--snapshot FILE] --replay-trace FILE [--threads N|--shards N]\n"
+#ifdef RENTAL_SERVER
+                 << "       " << argv[0] << " [--snapshot FILE] [--audit FILE] --serve ADDRESS [--server-threads N] [--allow-remote]\n"
+                 << "       " << argv[0] << " --connect ADDRESS\n"
+#endif
+                 ;
+            return 1;
+        }
+    }
+    
+    if (microbench) {
+        return runMicrobenchmarks(bench_sizes, bench_output, bench_baseline, bench_tolerance);
+    }
+#ifdef RENTAL_SERVER
+    if (!connect_address.empty()) {
+        return runServerClient(connect_address);
+    }
+#endif
+    
+    // A replayed trace brings the dataset size it was recorded against
+    vector<TraceRecord> load_trace;
+    bool load_mode = generate_load || !replay_trace_path.empty();
+    if (!replay_trace_path.empty()) {
+        TraceHeader header;
+        if (!loadTrace(replay_trace_path, header, load_trace)) {
+            cout << "Trace " << replay_trace_path << " is missing or corrupt\n";
+            return 1;
+        }
+        load_profile.vehicles = header.vehicles;
+        load_profile.clients = header.clients;
+        load_profile.staff = header.staff;
+    }
+    
+    bool system_running = true;
+    // Batch results own stdout, so status messages go to stderr in batch mode
+    ostream& status_output = batch_path.empty() ? cout : cerr;
+    
+    SnapshotStatus snapshot_status = SnapshotStatus::Missing;
+    if (!snapshot_path.empty()) {
+        snapshot_status = SnapshotFile::load(snapshot_path);
+        if (snapshot_status == SnapshotStatus::Invalid) {
+            status_output << "Snapshot " << snapshot_path << " is corrupt or from an incompatible version\n";
+            return 1;
+        }
+    }
+    
+    if (snapshot_status == SnapshotStatus::Missing && load_mode) {
+        populateSyntheticData(load_profile.vehicles, load_profile.clients, load_profile.staff);
+    } else if (snapshot_status == SnapshotStatus::Missing) {
+        // Initialize sample vehicle inventory
+        addVehicle(Vehicle("Toyota", "Corolla", 1000, 2000000, 5, "White", 100, time(0) + SECONDS_PER_DAY));
+        addVehicle(Vehicle("Honda", "Civic", 1500, 2500000, 5, "Black", 100, time(0) + SECONDS_PER_DAY));
+        addVehicle(Vehicle("Suzuki", "Cultus", 800, 1000000, 5, "Grey"));
+        addVehicle(Vehicle("Suzuki", "Mehran", 500, 500000, 5, "White"));
+        addVehicle(Vehicle("Toyota", "Vitz", 1200, 1500000, 5, "Red"));
+        addVehicle(Vehicle("Rolls", "Royce", 50000, 20000000, 4, "White", 90));
+        addVehicle(Vehicle("Ferrari", "Laferrari", 15000, 30000000, 2, "Red", 100, time(0) + 600));
+        addVehicle(Vehicle("Lamborghini", "Aventador", 20000, 40000000, 2, "Black", 100, time(0) + 1200));
+        addVehicle(Vehicle("Bugatti", "Veyron", 25000, 50000000, 2, "Blue"));
+        addVehicle(Vehicle("Audi", "A8", 5000, 10000000, 5, "Black"));
+
+        // Initialize sample client database
+        addClient(Client("ali", "asd", 100, 5000));
+        addClient(Client("ahmed", "123"));
+        addClient(Client("asad", "123"));
+        addClient(Client("ahsan", "123"));
+        addClient(Client("adeel", "123"));
+        openRental(RenterRole::Client, findClientByName("ali")->user_id, 0, time(0), vehicle_inventory.return_deadline[0]);
+        openRental(RenterRole::Client, findClientByName("ali")->user_id, 1, time(0), vehicle_inventory.return_deadline[1]);
+
+        // Initialize sample staff database
+        addStaff(StaffMember("dev", "123", 1.00, 0));
+        addStaff(StaffMember("daksh", "123"));
+        addStaff(StaffMember("sway", "123"));
+        addStaff(StaffMember("himan", "123", 0.99, 5000));
+        addStaff(StaffMember("kum", "123"));
+        openRental(RenterRole::Staff, findStaffByName("himan")->user_id, 6, time(0), vehicle_inventory.return_deadline[6]);
+        openRental(RenterRole::Staff, findStaffByName("himan")->user_id, 7, time(0), vehicle_inventory.return_deadline[7]);
+    }
+    
+    // Replay committed transactions from the log, then fold them into a fresh
+    // snapshot so the new log starts empty
+    if (!snapshot_path.empty()) {
+        string log_path = snapshot_path + ".wal";
+        size_t replayed = 0;
+        if (snapshot_status == SnapshotStatus::Loaded) {
+            replayed = WalReplay::replay(log_path, wal_generation);
+        }
+        if ((snapshot_status == SnapshotStatus::Missing || replayed > 0) && !checkpoint(snapshot_path)) {
+            status_output << "Failed to write snapshot " << snapshot_path << "\n";
+            return 1;
+        }
+        if (!transaction_log.open(log_path, wal_generation, commit_delay)) {
+            status_output << "Failed to open transaction log " << log_path << "\n";
+            return 1;
+        }
+        if (replayed > 0) {
+            status_output << "Recovered " << replayed << " transaction(s) from " << log_path << "\n";
+        }
+    }
+
+#ifdef RENTAL_SERVER
+    RentalServer server;
+    string server_error;
+    if (!serve_address.empty() && !server.open(serve_address, allow_remote, server_error)) {
+        status_output << "Cannot serve on " << serve_address << ": " << server_error << "\n";
+        transaction_log.close();
+        return 1;
+    }
+#endif
+
+    // Open the batch input before the audit writer starts, so failing here has nothing to stop
+    FILE* input = nullptr;
+    if (!batch_path.empty()) {
+        input = batch_path == "-" ? stdin : fopen(batch_path.c_str(), "rb");
+        if (input == nullptr) {
+            cerr << "Cannot open batch file " << batch_path << "\n";
+            transaction_log.close();
+            return 1;
+        }
+    }
+
+    // Every change from here on is also written to the audit trail, by its own thread
+    FILE* audit_output = nullptr;
+    shared_ptr<EventSubscription> audit;
+    thread audit_writer;
+    if (!audit_path.empty()) {
+        audit_output = fopen(audit_path.c_str(), "w");
+        if (audit_output == nullptr) {
+            status_output << "Cannot write audit trail " << audit_path << "\n";
+            transaction_log.close();
+            return 1;
+        }
+        audit = event_bus.subscribe("audit", 1 << 16, OverflowPolicy::Wait);
+        audit_writer = thread(writeAuditTrail, ref(*audit), audit_output);
+    }
+
+    if (load_mode) {
+        if (load_trace.empty()) {
+            load_trace = generateTrace(load_profile);
+        }
+        if (!record_trace_path.empty() && !saveTrace(record_trace_path, load_trace)) {
+            cout << "Failed to write trace " << record_trace_path << "\n";
+        }
+        if (load_shards > 0) {
+            replayTraceSharded(load_trace, load_shards);
+        } else {
+            replayTrace(load_trace, load_threads);
+        }
+        system_running = false;
+    }
+    
+#ifdef RENTAL_SERVER
+    if (!serve_address.empty()) {
+        raiseDescriptorLimit();
+        signal(SIGINT, interruptServer);
+        signal(SIGTERM, interruptServer);
+        status_output << "Serving on " << serve_address << " with " << server_threads << " thread(s)\n";
+        server.run(server_threads);
+        status_output << "Served " << server.requests() << " request(s) over " << server.connections() << " connection(s)\n";
+        system_running = false;
+    }
+#endif
+    
+    if (!batch_path.empty()) {
+        BatchRunner runner(stdout);
+        runner.run(input);
+        if (input != stdin) {
+            fclose(input);
+        }
+        system_running = false;
+    }
+
+    while (system_running) {
+        overdue_tracker.advance(time(0));
+        accrueLateFeesIfDue(time(0));
+        // Nothing else touches the tables between menu selections, so tombstones are reclaimed here
+        compactTables();
+        cout << "####################### Digital Vehicle Rental Management System #######################\n";
+        cout << "1. Client Portal\n2. Staff Portal\n3. Administrator Portal\n0. Exit System\n"
+             << "Enter your selection: ";
+        
+        char main_choice;
+        cin >> main_choice;
+        
+        switch (main_choice) {
+            case '0': system_running = false; break;
+            case '1': handleClientLogin(); break;
+            case '2': handleStaffLogin(); break;
+            case '3': handleAdminLogin(); break;
+            default: cout << "Invalid selection\n"; break;
+        }
+        
+        system("cls"); // Use "clear" for Linux/Mac, "cls" for Windows
+    }
+    
+    if (!snapshot_path.empty() && !checkpoint(snapshot_path)) {
+        status_output << "Failed to write snapshot " << snapshot_path << "\n";
+    }
+    transaction_log.close();
+    if (audit) {
+        event_bus.stop();
+        audit_writer.join();
+        fclose(audit_output);
+        if (event_bus.inboxDrops() != 0) {
+            status_output << event_bus.inboxDrops() << " event(s) were dropped before reaching " << audit_path << "\n";
+        }
+    }
+    
+    if (batch_path.empty() && serve_address.empty() && !load_mode) {
+        cin.get();
+    }
+    return 0;
+}